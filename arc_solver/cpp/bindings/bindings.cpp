@@ -1,14 +1,119 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
+#include <pybind11/functional.h>
 #include "../include/symmetry_solver.hpp"
 #include "../include/chess_solver.hpp"
 #include "../include/tiling_solver.hpp"
 #include "../include/ml_solver.hpp"
 #include "../include/dag_solver.hpp"
+#include "../dag_solver_temp/include/io/corpus.hpp"
+#include "../dag_solver_temp/include/shared_store.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 namespace py = pybind11;
 
+using CorpusReaderPtr = std::shared_ptr<arc::io::CorpusReader>;
+using SharedTaskStorePtr = std::shared_ptr<arc::solver::SharedTaskStore>;
+
+// uint8语料返回指向映射内存的只读numpy视图，数组持有owner（reader或共享存储）
+// 引用以保证映射有效；4位压缩语料只能解包到新数组
+static py::array corpusGridArray(const arc::io::CorpusReader& reader, std::size_t gridIndex, py::handle owner) {
+    arc::io::GridView view = reader.gridView(gridIndex);
+    std::vector<py::ssize_t> shape = {view.height, view.width};
+    if (reader.isPacked()) {
+        py::array_t<std::uint8_t> out(shape);
+        reader.loadGridInto(gridIndex, out.mutable_data());
+        return std::move(out);
+    }
+    std::vector<py::ssize_t> strides = {view.width, 1};
+    py::array out(py::dtype::of<std::uint8_t>(), shape, strides, view.pixels, owner);
+    py::detail::array_proxy(out.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    return out;
+}
+
+static py::array corpusGridArray(const CorpusReaderPtr& reader, std::size_t gridIndex) {
+    return corpusGridArray(*reader, gridIndex, py::cast(reader));
+}
+
+static py::array storeGridArray(const SharedTaskStorePtr& store, std::size_t gridIndex) {
+    return corpusGridArray(store->corpus(), gridIndex, py::cast(store));
+}
+
+static arc::io::TaskView storeTask(const SharedTaskStorePtr& store, std::size_t slot) {
+    if (slot >= store->slotCount()) {
+        throw py::index_error("slot out of range");
+    }
+    return store->corpus().task(store->corpusTask(slot));
+}
+
+// DAGSolverCpp.solve_iter返回的迭代器：后台线程求解，更新经队列交给Python，
+// 等待时释放GIL。迭代器被丢弃时通过Deadline取消求解，再等待后台线程退出
+class DAGSolveIterator {
+public:
+    using Grids = std::vector<std::vector<std::vector<int>>>;
+
+    DAGSolveIterator(arc_solver::SolverConfig config, Grids trainInputs, Grids trainOutputs, Grids testInputs)
+        : solver_(config) {
+        worker_ = std::thread([this, trainInputs = std::move(trainInputs),
+                               trainOutputs = std::move(trainOutputs), testInputs = std::move(testInputs)] {
+            try {
+                solver_.solveStreaming(trainInputs, trainOutputs, testInputs,
+                    [this](const arc_solver::AnswerUpdate& update) {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        queue_.push_back(update);
+                        ready_.notify_one();
+                    }, deadline_);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_ = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+            ready_.notify_one();
+        });
+    }
+
+    ~DAGSolveIterator() {
+        deadline_.cancel();
+        if (worker_.joinable()) {
+            py::gil_scoped_release release;
+            worker_.join();
+        }
+    }
+
+    arc_solver::AnswerUpdate next() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        {
+            py::gil_scoped_release release;
+            ready_.wait(lock, [this] { return !queue_.empty() || done_; });
+        }
+        if (queue_.empty()) {
+            if (error_) std::rethrow_exception(error_);
+            throw py::stop_iteration();
+        }
+        arc_solver::AnswerUpdate update = std::move(queue_.front());
+        queue_.pop_front();
+        return update;
+    }
+
+private:
+    arc_solver::DAGSolverCpp solver_;
+    arc::core::Deadline deadline_;
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<arc_solver::AnswerUpdate> queue_;
+    std::exception_ptr error_;
+    bool done_ = false;
+};
+
 PYBIND11_MODULE(arc_solver_cpp, m) {
     m.doc() = "ARC Solver C++ optimized modules";
 
@@ -57,6 +162,182 @@ PYBIND11_MODULE(arc_solver_cpp, m) {
         .def("solve", &arc_solver::DAGSolverCpp::solve,
              "Solve task using DAG-based search and return predictions",
              py::arg("train_inputs"), py::arg("train_outputs"), py::arg("test_inputs"))
+        .def("solve_streaming", [](arc_solver::DAGSolverCpp& self,
+                                   const DAGSolveIterator::Grids& trainInputs,
+                                   const DAGSolveIterator::Grids& trainOutputs,
+                                   const DAGSolveIterator::Grids& testInputs,
+                                   const arc_solver::AnswerCallback& onUpdate, double timeLimit) {
+                 self.solveStreaming(trainInputs, trainOutputs, testInputs, onUpdate,
+                                     arc::core::Deadline(timeLimit));
+             },
+             "Solve task and call on_update(update) whenever the answer set improves; "
+             "time_limit > 0 stops the search after that many seconds",
+             py::arg("train_inputs"), py::arg("train_outputs"), py::arg("test_inputs"),
+             py::arg("on_update"), py::arg("time_limit") = 0.0, py::call_guard<py::gil_scoped_release>())
+        .def("solve_iter", [](const arc_solver::DAGSolverCpp& self,
+                              DAGSolveIterator::Grids trainInputs, DAGSolveIterator::Grids trainOutputs,
+                              DAGSolveIterator::Grids testInputs) {
+                 return std::make_unique<DAGSolveIterator>(self.getConfig(), std::move(trainInputs),
+                                                           std::move(trainOutputs), std::move(testInputs));
+             },
+             "Iterate over improving answer updates while the task is being solved",
+             py::arg("train_inputs"), py::arg("train_outputs"), py::arg("test_inputs"))
         .def("get_available_functions", &arc_solver::DAGSolverCpp::getAvailableFunctions,
              "Get list of available transform functions");
+
+    py::class_<arc_solver::AnswerUpdate>(m, "AnswerUpdate")
+        .def_readonly("answers", &arc_solver::AnswerUpdate::answers)
+        .def_readonly("score", &arc_solver::AnswerUpdate::score)
+        .def_readonly("elapsed", &arc_solver::AnswerUpdate::elapsed)
+        .def_readonly("stage", &arc_solver::AnswerUpdate::stage)
+        .def_readonly("final", &arc_solver::AnswerUpdate::final);
+
+    py::class_<DAGSolveIterator>(m, "DAGSolveIterator")
+        .def("__iter__", [](DAGSolveIterator& self) -> DAGSolveIterator& { return self; },
+             py::return_value_policy::reference_internal)
+        .def("__next__", &DAGSolveIterator::next);
+
+    py::class_<arc::io::CorpusReader, CorpusReaderPtr>(m, "ArcCorpus")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def("__len__", &arc::io::CorpusReader::taskCount)
+        .def_property_readonly("is_packed", &arc::io::CorpusReader::isPacked)
+        .def("task_id", [](const CorpusReaderPtr& self, std::size_t i) { return self->task(i).id; },
+             "Get the id of the i-th task", py::arg("index"))
+        .def("train_pairs", [](const CorpusReaderPtr& self, std::size_t i) {
+                 arc::io::TaskView task = self->task(i);
+                 py::list pairs;
+                 for (std::size_t k = 0; k < task.trainCount; ++k) {
+                     pairs.append(py::make_tuple(corpusGridArray(self, task.trainInputGrid(k)),
+                                                 corpusGridArray(self, task.trainOutputGrid(k))));
+                 }
+                 return pairs;
+             },
+             "Get (input, output) numpy views of the training examples", py::arg("index"))
+        .def("test_inputs", [](const CorpusReaderPtr& self, std::size_t i) {
+                 arc::io::TaskView task = self->task(i);
+                 py::list grids;
+                 for (std::size_t k = 0; k < task.testCount; ++k) {
+                     grids.append(corpusGridArray(self, task.testInputGrid(k)));
+                 }
+                 return grids;
+             },
+             "Get numpy views of the test inputs", py::arg("index"))
+        .def("test_outputs", [](const CorpusReaderPtr& self, std::size_t i) {
+                 arc::io::TaskView task = self->task(i);
+                 py::list grids;
+                 for (std::size_t k = 0; k < task.testOutputCount; ++k) {
+                     if (self->hasGrid(task.testOutputGrid(k))) {
+                         grids.append(corpusGridArray(self, task.testOutputGrid(k)));
+                     } else {
+                         grids.append(py::none());
+                     }
+                 }
+                 return grids;
+             },
+             "Get numpy views of the test outputs, one per test with None where a test has no output "
+             "(empty when the corpus has no solutions)", py::arg("index"));
+
+    // 共享内存任务存储：网格是指向段内语料的只读视图，结果槽位与CLI的--shm-worker/--shm-collect互通
+    py::class_<arc::solver::SharedTaskStore, SharedTaskStorePtr>(m, "SharedTaskStore")
+        .def_static("create", [](const std::string& name, const std::string& corpusPath, std::size_t slotBytes) {
+                        arc::solver::SharedTaskStore::Config config;
+                        config.slotBytes = slotBytes;
+                        return SharedTaskStorePtr(arc::solver::SharedTaskStore::create(name, corpusPath, config));
+                    },
+                    "Copy a binary corpus into a new named shared memory segment (e.g. \"/arc_eval\")",
+                    py::arg("name"), py::arg("corpus_path"), py::arg("slot_bytes") = 16384)
+        .def_static("attach", [](const std::string& name) {
+                        return SharedTaskStorePtr(arc::solver::SharedTaskStore::attach(name));
+                    },
+                    "Attach to an existing shared task store", py::arg("name"))
+        .def_static("unlink", &arc::solver::SharedTaskStore::unlink,
+                    "Remove the segment name; attached processes keep their mapping", py::arg("name"))
+        .def_property_readonly("name", &arc::solver::SharedTaskStore::name)
+        .def_property_readonly("completed", &arc::solver::SharedTaskStore::completed,
+                               "Number of slots that have a result")
+        .def("__len__", &arc::solver::SharedTaskStore::slotCount)
+        .def("claim", [](arc::solver::SharedTaskStore& self) -> std::optional<std::size_t> {
+                 const long slot = self.claim();
+                 if (slot < 0) return std::nullopt;
+                 return static_cast<std::size_t>(slot);
+             },
+             "Atomically claim the next unassigned slot, or None when every slot has been handed out")
+        .def("task_id", [](const SharedTaskStorePtr& self, std::size_t slot) { return storeTask(self, slot).id; },
+             "Get the task id of a slot", py::arg("slot"))
+        .def("test_index", [](const SharedTaskStorePtr& self, std::size_t slot) {
+                 storeTask(self, slot);
+                 return self->testIndex(slot);
+             },
+             "Get which test input of its task a slot covers", py::arg("slot"))
+        .def("train_pairs", [](const SharedTaskStorePtr& self, std::size_t slot) {
+                 arc::io::TaskView task = storeTask(self, slot);
+                 py::list pairs;
+                 for (std::size_t k = 0; k < task.trainCount; ++k) {
+                     pairs.append(py::make_tuple(storeGridArray(self, task.trainInputGrid(k)),
+                                                 storeGridArray(self, task.trainOutputGrid(k))));
+                 }
+                 return pairs;
+             },
+             "Get (input, output) numpy views of the slot's training examples", py::arg("slot"))
+        .def("test_input", [](const SharedTaskStorePtr& self, std::size_t slot) {
+                 arc::io::TaskView task = storeTask(self, slot);
+                 return storeGridArray(self, task.testInputGrid(self->testIndex(slot)));
+             },
+             "Get a numpy view of the slot's test input", py::arg("slot"))
+        .def("test_output", [](const SharedTaskStorePtr& self, std::size_t slot) -> py::object {
+                 arc::io::TaskView task = storeTask(self, slot);
+                 const std::size_t test = self->testIndex(slot);
+                 if (test < task.testOutputCount && self->corpus().hasGrid(task.testOutputGrid(test))) {
+                     return storeGridArray(self, task.testOutputGrid(test));
+                 }
+                 return py::none();
+             },
+             "Get a numpy view of the slot's test output, or None when the corpus has none", py::arg("slot"))
+        .def("store_result", [](const SharedTaskStorePtr& self, std::size_t slot,
+                                const std::vector<py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast>>& answers,
+                                float score, double solvingTime) {
+                 arc::io::TaskView view = storeTask(self, slot);
+                 arc::solver::ARCTask task;
+                 task.taskId = view.id;
+                 task.testIndex = self->testIndex(slot);
+
+                 arc::solver::SolveResult result;
+                 for (const auto& answer : answers) {
+                     if (answer.ndim() != 2) {
+                         throw std::runtime_error("answers must be 2-D grids");
+                     }
+                     arc::core::Grid grid(static_cast<int>(answer.shape(1)), static_cast<int>(answer.shape(0)));
+                     std::copy(answer.data(), answer.data() + answer.size(), grid.pixels.begin());
+                     result.answers.push_back(std::move(grid));
+                 }
+                 result.success = !result.answers.empty();
+                 result.verdict = result.success ? arc::solver::SolveResult::Verdict::Candidate
+                                                 : arc::solver::SolveResult::Verdict::Nothing;
+                 result.bestScore = score;
+                 result.solvingTime = solvingTime;
+                 self->storeResult(slot, task, result);
+             },
+             "Write the answers for a slot (at most what fits in slot_bytes; later answers are dropped)",
+             py::arg("slot"), py::arg("answers"), py::arg("score") = 0.0f, py::arg("solving_time") = 0.0)
+        .def("load_result", [](const SharedTaskStorePtr& self, std::size_t slot) -> py::object {
+                 storeTask(self, slot);
+                 arc::solver::SolveResult result;
+                 if (!self->loadResult(slot, result)) {
+                     return py::none();
+                 }
+                 py::list answers;
+                 for (const auto& grid : result.answers) {
+                     py::array_t<std::uint8_t> out(std::vector<py::ssize_t>{grid.height, grid.width});
+                     std::copy(grid.pixels.begin(), grid.pixels.end(), out.mutable_data());
+                     answers.append(std::move(out));
+                 }
+                 return py::make_tuple(answers, result.bestScore);
+             },
+             "Read a slot's result as (answers, score), or None when it has no complete result",
+             py::arg("slot"));
+
+    m.def("convert_arc_json_to_corpus", &arc::io::convertJsonToCorpus,
+          "Convert ARC JSON (single task or challenges file) to a packed binary corpus",
+          py::arg("json_path"), py::arg("corpus_path"), py::arg("solutions_path") = "",
+          py::arg("pack_nibbles") = false);
 } 
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "task.hpp"
+
+namespace arc::solver {
+
+// 单个任务结果的二进制编码：taskId、testIndex、verdict、分数、计数、答案网格，
+// 以及堆高水位、各阶段耗时、分配统计和性能计数（定长部分按内存布局，读写双方须为同一构建）
+// 批量运行日志的记录负载、守护进程和协调进程的结果帧、共享内存结果槽位和
+// 进程池的结果管道都使用这一格式
+std::string encodeTaskResult(const ARCTask& task, const SolveResult& result);
+bool decodeTaskResult(const char* data, std::size_t size, std::string& taskId, std::size_t& testIndex,
+                      SolveResult& result);
+
+// ============================================================================
+// 批量运行日志 - 每完成一个任务追加一条记录，中断后重跑时跳过已完成的任务
+//
+// 二进制格式：文件头（含求解器指纹）+ 若干条 {magic, 负载长度, 负载校验和, 负载}，
+// 负载为encodeTaskResult的输出。写入按条数或时间批量fsync；
+// 打开时校验全部记录并截掉崩溃留下的残缺尾部。同一时刻只允许一个进程打开
+// （flock），进程内的多个工作线程可以并发append。
+// 求解器指纹（solverFingerprint）与文件头不一致时拒绝打开，避免把不同配置的结果混进同一次续跑
+// ============================================================================
+
+class BatchJournal {
+public:
+    struct Config {
+        std::size_t syncEvery;         // 每追加多少条记录fsync一次
+        double syncInterval;           // 距上次fsync超过多少秒时立即fsync
+
+        Config() : syncEvery(16), syncInterval(2.0) {}
+    };
+
+    struct Entry {
+        std::string taskId;
+        std::size_t testIndex = 0;
+        SolveResult result;
+    };
+
+    // 文件不存在时创建；文件已被其他进程打开、格式不对或求解器指纹不一致时抛出std::runtime_error
+    BatchJournal(const std::string& path, std::uint64_t solverFingerprint, const Config& config = Config());
+    ~BatchJournal();
+
+    BatchJournal(const BatchJournal&) = delete;
+    BatchJournal& operator=(const BatchJournal&) = delete;
+
+    // 同一任务有多条记录时以最后一条为准
+    const SolveResult* find(const std::string& taskId, std::size_t testIndex) const;
+
+    // 把已记录的结果填入results（与tasks一一对应），返回尚未完成的任务下标
+    std::vector<std::size_t> restore(const std::vector<ARCTask>& tasks, std::vector<SolveResult>& results) const;
+
+    void append(const ARCTask& task, const SolveResult& result);
+    void sync();
+
+    std::size_t size() const;
+    const std::string& path() const { return path_; }
+
+    // 按Kaggle格式写出submission.json：{"<id>": [{"attempt_1": grid, "attempt_2": grid}, ...]}
+    // 覆盖tasks中的每个任务和每个test，日志中没有结果的（跳过、未求解或失败）写1x1占位网格
+    void writeSubmission(const std::string& path, const std::vector<ARCTask>& tasks) const;
+
+private:
+    std::string path_;
+    std::uint64_t solverFingerprint_;
+    Config config_;
+    int fd_ = -1;
+
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+    std::map<std::pair<std::string, std::size_t>, std::size_t> index_;
+    std::size_t unsynced_ = 0;
+    std::chrono::steady_clock::time_point lastSync_;
+
+    void load();
+};
+
+} // namespace arc::solver
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "solver.hpp"
+
+namespace arc::bench {
+
+// ============================================================================
+// 合成任务生成器 - 网格尺寸、训练对数、颜色数、连通块数可以独立调节
+//
+// 输入为背景0上随机放置的矩形块；输出由从已注册变换函数中抽取的组合程序生成，
+// 因此每个任务都有已知解。相同spec（含seed）总是生成相同的任务
+// ============================================================================
+
+struct SyntheticTaskSpec {
+    int width = 10;
+    int height = 10;
+    int trainPairs = 3;
+    int colors = 3;            // 非背景颜色数（1-9）
+    int components = 3;        // 每个输入中的矩形块数
+    int programLength = 2;     // 组合的变换函数个数
+    std::uint64_t seed = 1;
+};
+
+struct SyntheticTask {
+    arc::solver::ARCTask task;
+    std::vector<std::string> program;   // 按应用顺序的函数名
+};
+
+class SyntheticTaskGenerator {
+public:
+    struct Config {
+        int maxOutputSide;             // 输出边长上限，超出则重新抽取程序
+        int maxProgramAttempts;        // 抽取程序的最大尝试次数
+
+        Config() : maxOutputSide(30), maxProgramAttempts(200) {}
+    };
+
+    explicit SyntheticTaskGenerator(const Config& config = Config());
+
+    // 找不到在所有输入上都有效的程序时抛出std::runtime_error
+    SyntheticTask generate(const SyntheticTaskSpec& spec) const;
+
+    // 随机输入网格
+    static arc::core::Grid randomInput(const SyntheticTaskSpec& spec, std::mt19937_64& rng);
+
+private:
+    Config config_;
+    std::vector<std::uint16_t> functions_;   // 可用于单图像状态的已注册函数
+
+    bool applyProgram(const std::vector<std::uint16_t>& program, const arc::core::Grid& input,
+                      arc::core::Grid& output) const;
+};
+
+} // namespace arc::bench
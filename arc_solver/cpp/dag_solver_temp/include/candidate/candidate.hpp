@@ -5,6 +5,8 @@
 #include <functional>
 #include "piece/piece.hpp"
 #include "core/state.hpp"
+#include "core/packed.hpp"
+#include "candidate/mask_scheduler.hpp"
 
 namespace arc::candidate {
 
@@ -74,6 +76,26 @@ private:
     std::size_t getBlockCount() const { return (size_ + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK; }
 };
 
+// ============================================================================
+// 压缩piece图像表 - 组合阶段的工作集，4位存储
+// ============================================================================
+
+struct PackedPieceTable {
+    std::vector<std::size_t> imageOffsets; // 每个DAG的图像在行内的字节偏移
+    std::size_t rowBytes = 0;              // 每个piece一行，行内依次存放各DAG的图像
+    std::vector<std::uint8_t> data;
+    
+    const std::uint8_t* image(std::size_t pieceIndex, std::size_t dagIndex) const {
+        return data.data() + pieceIndex * rowBytes + imageOffsets[dagIndex];
+    }
+    std::uint8_t* image(std::size_t pieceIndex, std::size_t dagIndex) {
+        return data.data() + pieceIndex * rowBytes + imageOffsets[dagIndex];
+    }
+    std::uint8_t pixel(std::size_t pieceIndex, std::size_t dagIndex, std::size_t pixelIndex) const {
+        return (image(pieceIndex, dagIndex)[pixelIndex >> 1] >> ((pixelIndex & 1) << 2)) & 15;
+    }
+};
+
 // ============================================================================
 // 贪心组合器 - 对应icecuber的greedyCompose2
 // ============================================================================
@@ -87,6 +109,16 @@ public:
         bool enableGreedyFill = true;    // 启用贪心填充
         bool enableVariations = true;    // 启用变化组合
         std::size_t maxCandidates = 1000; // 最大候选数量
+        
+        // 训练子集调度 - 训练对较多时避免指数级枚举且不丢弃后面的训练对
+        MaskStrategy maskStrategy = MaskStrategy::Auto;
+        int exhaustiveMaskLimit = 5;     // 训练对数不超过此值时穷举（对应icecuber的1<<5）
+        int maxMaskSubsetSize = 8;       // 线性调度中每个子集的最大训练对数
+        
+        arc::core::Deadline deadline;    // 任务级预算，用尽时返回已生成的候选解
+        
+        // 每轮（每个piece深度阈值）组合结束后以当前全部候选解回调，用于渐进式输出
+        std::function<void(const std::vector<Candidate>&)> onRoundComplete;
     };
     
     GreedyComposer(const Config& config = {});
@@ -109,8 +141,9 @@ private:
         CompactBitset& current,
         const CompactBitset& careMask,
         int pieceDepthThreshold,
-        std::vector<arc::core::Grid>& result,
+        std::vector<arc::core::PackedGrid>& result,
         const arc::piece::PieceCollection& pieces,
+        const PackedPieceTable& pieceTable,
         const std::vector<std::size_t>& imageSizes,
         const std::vector<std::uint64_t>& activeMem,
         const std::vector<std::uint64_t>& badMem,
@@ -119,11 +152,12 @@ private:
         const std::vector<std::size_t>& imageIndices
     );
     
-    // 预处理pieces数据 - 对应icecuber的内存预处理逻辑
+    // 预处理pieces数据 - 对应icecuber的内存预处理逻辑，同时生成压缩piece图像表
     void preprocessPieces(
         const arc::piece::PieceCollection& pieces,
         const std::vector<arc::core::Grid>& targets,
-        const std::vector<arc::core::Grid>& initialImages,
+        const std::vector<arc::core::PackedGrid>& initialImages,
+        PackedPieceTable& pieceTable,
         std::vector<std::uint64_t>& activeMem,
         std::vector<std::uint64_t>& badMem,
         std::vector<std::size_t>& activeIndices,
@@ -159,9 +193,11 @@ public:
     );
     
     // 评估候选解 - 对应icecuber的evaluateCands
+    // 预算用尽时只对已评估的候选解排序（至少保留一个有效候选解）
     std::vector<Candidate> evaluateCandidates(
         const std::vector<Candidate>& candidates,
-        const std::vector<std::pair<arc::core::Grid, arc::core::Grid>>& trainingPairs
+        const std::vector<std::pair<arc::core::Grid, arc::core::Grid>>& trainingPairs,
+        const arc::core::Deadline& deadline = arc::core::Deadline()
     );
     
     // 获取贪心组合器配置
@@ -242,6 +278,9 @@ private:
 // 辅助函数
 // ============================================================================
 
+// 候选解图像占用的字节数，组合器按它做预算记账
+std::size_t candidateBytes(const Candidate& candidate);
+
 // 创建测试候选解
 std::vector<Candidate> createTestCandidates(
     const std::vector<arc::core::Grid>& images
@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "core/state.hpp"
+
+namespace arc::candidate {
+
+// ============================================================================
+// 训练子集调度 - 替代greedyCompose2中的 mask < min(1<<n, 1<<5) 枚举
+// ============================================================================
+
+// 子集枚举策略
+enum class MaskStrategy {
+    Auto,           // 训练对数 <= exhaustiveLimit 时穷举，否则为GreedyInfoGain + 一个全集任务
+    Exhaustive,     // 穷举所有非空子集（对应icecuber的原始行为，指数级，最多MAX_EXHAUSTIVE_PAIRS个训练对）
+    AllPairs,       // 全部训练对作为一个子集，每个训练对各关心一次（成员总数O(n^2)）
+    LeaveOneOut,    // 每次留出一个训练对（成员总数O(n^2)）
+    GreedyInfoGain  // 按信息增益贪心排序后，每个训练对与排在它之前的至多maxSubsetSize-1个组成子集
+};
+
+// 一次贪心组合任务：在members限定的训练对上组合，并以careIndex的覆盖率作为目标
+struct MaskJob {
+    std::vector<int> members;  // 子集中的训练对索引（升序）
+    int careIndex = -1;        // 本次关心的训练对索引，必然属于members
+};
+
+class MaskScheduler {
+public:
+    struct Config {
+        MaskStrategy strategy;
+        int exhaustiveLimit;   // Auto模式下穷举的最大训练对数（原实现为5）
+        int maxSubsetSize;     // GreedyInfoGain子集的最大训练对数，使成员总数为O(n)
+
+        Config() : strategy(MaskStrategy::Auto), exhaustiveLimit(5), maxSubsetSize(8) {}
+    };
+
+    // 穷举的训练对数上限，超出时记录警告并改用Auto的线性调度，不丢弃任何训练对
+    static constexpr int MAX_EXHAUSTIVE_PAIRS = 20;
+
+    explicit MaskScheduler(const Config& config = Config());
+
+    // 生成组合任务列表；除Exhaustive外任务数为O(n)，且每个训练对至少作为一次careIndex出现。
+    // Auto（训练对较多时）和GreedyInfoGain的成员总数为O(n * maxSubsetSize)
+    std::vector<MaskJob> schedule(const std::vector<arc::core::Grid>& targets) const;
+
+    // 按信息增益贪心排序训练对 - 增益 = 目标图像的信息量 + 新出现颜色覆盖的面积，O(n log n)
+    static std::vector<int> orderByInformationGain(const std::vector<arc::core::Grid>& targets);
+
+    const Config& getConfig() const { return config_; }
+    void setConfig(const Config& config) { config_ = config; }
+
+private:
+    Config config_;
+
+    void appendExhaustive(int count, std::vector<MaskJob>& jobs) const;
+    void appendAllPairs(int count, std::vector<MaskJob>& jobs) const;
+    void appendLeaveOneOut(int count, std::vector<MaskJob>& jobs) const;
+    void appendGreedyInfoGain(const std::vector<int>& order, std::vector<MaskJob>& jobs) const;
+    void appendLinear(const std::vector<arc::core::Grid>& targets, std::vector<MaskJob>& jobs) const;
+};
+
+} // namespace arc::candidate
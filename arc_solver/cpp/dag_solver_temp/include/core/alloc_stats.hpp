@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "core/stage.hpp"
+
+namespace arc::core {
+
+// ============================================================================
+// 分配统计 - 按求解阶段、按线程统计operator new/delete
+//
+// 统计来自src/core/alloc_hooks.cpp中替换的全局operator new/delete，
+// 只有以ARC_ALLOC_ACCOUNTING编译并链接该文件的程序（CLI、benchmark）才会计数；
+// 其他构建中计数始终为0，allocAccountingEnabled()返回false。
+// 计数器是线程局部的，阶段标记也是线程局部的：一个任务的统计即求解它的线程的统计
+// ============================================================================
+
+struct AllocCounters {
+    std::uint64_t allocations = 0;
+    std::uint64_t frees = 0;
+    std::uint64_t bytesAllocated = 0;
+    std::uint64_t bytesFreed = 0;
+
+    AllocCounters& operator+=(const AllocCounters& other);
+    AllocCounters operator-(const AllocCounters& other) const;
+};
+
+struct AllocSnapshot {
+    std::array<AllocCounters, SOLVE_STAGE_COUNT> stages{};
+    std::int64_t liveBytes = 0;      // 当前线程分配减去释放，跨线程释放时可能为负
+    std::int64_t peakBytes = 0;      // 当前线程liveBytes的高水位
+
+    AllocCounters total() const;
+};
+
+// 是否已链接分配钩子
+bool allocAccountingEnabled();
+
+// 当前线程的累计统计
+AllocSnapshot threadAllocSnapshot();
+
+// 由alloc_hooks.cpp调用
+void markAllocHooksInstalled() noexcept;
+void recordAllocation(std::size_t bytes) noexcept;
+void recordFree(std::size_t bytes) noexcept;
+
+// 由StageScope调用：切换当前线程的分配阶段，返回之前的阶段
+SolveStage enterAllocStage(SolveStage stage) noexcept;
+
+// 一个任务的统计窗口：构造时记录基线并重置高水位
+class AllocTaskScope {
+public:
+    AllocTaskScope() noexcept;
+
+    // 自构造以来的各阶段增量
+    std::array<AllocCounters, SOLVE_STAGE_COUNT> stageDelta() const;
+    // 自构造以来高于基线的峰值字节数
+    std::int64_t peakBytes() const;
+
+private:
+    AllocSnapshot baseline_;
+};
+
+} // namespace arc::core
@@ -4,7 +4,9 @@
 #include <cstdint>
 #include <memory>
 #include <functional>
+#include <string>
 #include "core/state.hpp"
+#include "core/deadline.hpp"
 
 namespace arc::core {
 
@@ -131,6 +133,7 @@ public:
         std::size_t maxNodes;          // 最大节点数
         std::size_t maxPixels;         // 最大总像素数
         double timeLimit;              // 时间限制(秒)
+        Deadline deadline;             // 任务级预算，到期、超内存或被取消时停止扩展
         
         Config() : maxDepth(25), maxNodes(100000), maxPixels(40*40*5), timeLimit(60.0) {}
     };
@@ -142,6 +145,7 @@ private:
     FunctionRegistry functions_;               // 函数注册表
     std::size_t givenNodes_{0};               // 给定的输入节点数量
     Point targetSize_{0, 0};                  // 目标输出尺寸
+    std::vector<NodeID> frontier_;            // 因深度、节点数或预算限制未完全扩展的节点
     
     // 统计信息
     mutable std::size_t expandCalls_{0};
@@ -159,6 +163,11 @@ public:
     std::vector<NodeID> expandNode(NodeID nodeId);
     void buildDAG(); // 全面构建DAG到指定深度
     
+    // 迭代加深：把深度上限提高到newMaxDepth，只从上次留下的边界节点继续扩展，
+    // 已有节点和子节点映射保持不变。返回是否产生了新节点
+    bool extendDepth(std::size_t newMaxDepth);
+    bool canExtend() const { return !frontier_.empty(); }
+    
     // 函数注册
     std::uint16_t registerFunction(const std::string& name,
                                   FunctionRegistry::TransformFunction func,
@@ -181,6 +190,8 @@ public:
     const Config& getConfig() const { return config_; }
     void setTargetSize(const Point& size) { targetSize_ = size; }
     void setGivenNodes(std::size_t count) { givenNodes_ = count; }
+    void setDeadline(const Deadline& deadline) { config_.deadline = deadline; }
+    double getBuildTime() const { return buildTime_; }
     
     // 统计信息
     struct Statistics {
@@ -200,6 +211,7 @@ public:
 private:
     bool isValidExpansion(const State& newState) const;
     NodeID applyFunction(NodeID nodeId, std::uint16_t funcId);
+    void expandLevels(std::vector<NodeID> currentLevel);
 };
 
 } // namespace arc::core 
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+namespace arc::core {
+
+// ============================================================================
+// 任务预算 - 墙钟截止时间 + 内存记账 + 取消标志
+// 拷贝和stage()得到的子预算共享同一个取消标志和内存记账，可以跨阶段、跨线程传递
+// ============================================================================
+
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 不限时、不限内存
+    Deadline();
+
+    // seconds <= 0 表示不限时，memoryLimit == 0 表示不限内存
+    explicit Deadline(double seconds, std::size_t memoryLimit = 0);
+
+    bool timeLimited() const { return timeLimited_; }
+    double elapsed() const;
+    double remaining() const;      // 不限时返回正无穷
+
+    bool timeExpired() const { return timeLimited_ && Clock::now() >= end_; }
+    bool memoryExceeded() const;
+    bool cancelled() const { return shared_->cancelled.load(std::memory_order_relaxed); }
+    bool expired() const { return cancelled() || memoryExceeded() || timeExpired(); }
+
+    // 取消所有共享此预算的阶段
+    void cancel() const { shared_->cancelled.store(true, std::memory_order_relaxed); }
+
+    // 内存记账（字节）
+    void chargeMemory(std::size_t bytes) const { shared_->memoryUsed.fetch_add(bytes, std::memory_order_relaxed); }
+    // 归还记账的字节（结构被释放或整体重建时），不会减到0以下
+    void releaseMemory(std::size_t bytes) const;
+    std::size_t memoryUsed() const { return shared_->memoryUsed.load(std::memory_order_relaxed); }
+    std::size_t memoryLimit() const { return shared_->memoryLimit; }
+
+    // 子预算：截止时间为当前剩余时间的share部分，不超过父预算
+    Deadline stage(double share) const;
+
+private:
+    struct Shared {
+        std::atomic<bool> cancelled{false};
+        std::atomic<std::size_t> memoryUsed{0};
+        std::size_t memoryLimit = 0;
+    };
+
+    Clock::time_point start_;
+    Clock::time_point end_;
+    bool timeLimited_ = false;
+    std::shared_ptr<Shared> shared_;
+};
+
+} // namespace arc::core
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+// ============================================================================
+// 分级日志 - 编译期 + 运行期两级过滤，每线程缓冲
+//
+//   ARC_LOG_DEBUG("Piece提取完成: pieces=" << pieces.size());
+//
+// 宏参数是一条<<表达式，级别被过滤时整条表达式不会求值。
+// ARC_LOG_MIN_LEVEL（0=Trace … 5=Off）在编译期去掉更低级别的日志，默认保留全部；
+// setLogLevel()在运行期过滤，默认只输出Warn及以上。
+// 每个线程先写入自己的缓冲区，满4KB、遇到Warn及以上或线程退出时整块写出，
+// 并行批量求解时不会在输出流的锁上排队
+// ============================================================================
+
+#ifndef ARC_LOG_MIN_LEVEL
+#define ARC_LOG_MIN_LEVEL 0
+#endif
+
+namespace arc::core {
+
+enum class LogLevel : int {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+    Off = 5
+};
+
+namespace detail {
+extern std::atomic<int> runtimeLogLevel;
+}
+
+inline bool logEnabled(LogLevel level) {
+    return static_cast<int>(level) >= detail::runtimeLogLevel.load(std::memory_order_relaxed);
+}
+
+void setLogLevel(LogLevel level);
+LogLevel getLogLevel();
+
+// 解析"trace"/"debug"/"info"/"warn"/"error"/"off"，无法识别时返回fallback
+LogLevel parseLogLevel(const std::string& name, LogLevel fallback = LogLevel::Warn);
+
+// 输出目标，默认std::cerr；调用方保证其生命周期
+void setLogStream(std::ostream& stream);
+
+// 写出当前线程缓冲区中的日志
+void flushLog();
+
+// 一条日志：析构时追加到当前线程的缓冲区
+class LogLine {
+public:
+    explicit LogLine(LogLevel level);
+    ~LogLine();
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    std::ostream& stream() { return stream_; }
+
+private:
+    LogLevel level_;
+    std::ostringstream stream_;
+};
+
+} // namespace arc::core
+
+#define ARC_LOG(level, expr)                                                          \
+    do {                                                                              \
+        if constexpr (static_cast<int>(level) >= ARC_LOG_MIN_LEVEL) {                 \
+            if (::arc::core::logEnabled(level)) {                                     \
+                ::arc::core::LogLine arcLogLine_(level);                              \
+                arcLogLine_.stream() << expr;                                         \
+            }                                                                         \
+        }                                                                             \
+    } while (0)
+
+#define ARC_LOG_TRACE(expr) ARC_LOG(::arc::core::LogLevel::Trace, expr)
+#define ARC_LOG_DEBUG(expr) ARC_LOG(::arc::core::LogLevel::Debug, expr)
+#define ARC_LOG_INFO(expr) ARC_LOG(::arc::core::LogLevel::Info, expr)
+#define ARC_LOG_WARN(expr) ARC_LOG(::arc::core::LogLevel::Warn, expr)
+#define ARC_LOG_ERROR(expr) ARC_LOG(::arc::core::LogLevel::Error, expr)
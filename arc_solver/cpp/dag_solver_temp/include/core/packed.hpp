@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "core/state.hpp"
+
+namespace arc::core {
+
+// ============================================================================
+// 4位压缩像素存储 - ARC颜色0-9及未填充标记10都可以用4位表示
+// ============================================================================
+
+// 未填充像素标记 - 对应GreedyComposer中的10
+static constexpr std::uint8_t UNFILLED_PIXEL = 10;
+
+// 每字节存两个像素：偶数索引在低4位，奇数索引在高4位
+inline std::size_t packedBytes(std::size_t pixelCount) { return (pixelCount + 1) / 2; }
+
+// ============================================================================
+// SIMD内核 - 有SSE2时向量化，否则退化为标量实现
+// ============================================================================
+
+// 将count个字节像素（值 < 16）压缩为4位存储
+void packNibbles(const std::uint8_t* src, std::size_t count, std::uint8_t* dst);
+
+// 将count个4位像素展开为字节像素
+void unpackNibbles(const std::uint8_t* src, std::size_t count, std::uint8_t* dst);
+
+// 逐像素比较两个压缩图像，不相等的像素在bits中置1（bits需至少(count+63)/64个元素，会被覆盖）
+void nibbleNotEqualMask(const std::uint8_t* a, const std::uint8_t* b, std::size_t count, std::uint64_t* bits);
+
+// 非零像素在bits中置1（bits需至少(count+63)/64个元素，会被覆盖）
+void nibbleNonZeroMask(const std::uint8_t* a, std::size_t count, std::uint64_t* bits);
+
+// 将src的前count位复制到dst从dstOffset开始的位置（按位或）
+void orBitsAt(std::uint64_t* dst, std::size_t dstOffset, const std::uint64_t* src, std::size_t count);
+
+// ============================================================================
+// 压缩图像 - Grid的4位版本，只保存像素内容
+// ============================================================================
+
+struct PackedGrid {
+    int width{0}, height{0};
+    std::vector<std::uint8_t> nibbles;
+
+    PackedGrid() = default;
+    PackedGrid(int w, int h, std::uint8_t filling = 0) : width(w), height(h) {
+        std::uint8_t fill = static_cast<std::uint8_t>((filling & 15) | (filling & 15) << 4);
+        nibbles.assign(packedBytes(static_cast<std::size_t>(w) * h), fill);
+    }
+    explicit PackedGrid(const Grid& grid) : width(grid.width), height(grid.height) {
+        nibbles.resize(packedBytes(grid.pixels.size()));
+        packNibbles(grid.pixels.data(), grid.pixels.size(), nibbles.data());
+    }
+
+    std::size_t size() const { return static_cast<std::size_t>(width) * height; }
+
+    std::uint8_t get(std::size_t index) const {
+        return (nibbles[index >> 1] >> ((index & 1) << 2)) & 15;
+    }
+    void set(std::size_t index, std::uint8_t value) {
+        std::uint8_t& byte = nibbles[index >> 1];
+        int shift = static_cast<int>(index & 1) << 2;
+        byte = static_cast<std::uint8_t>((byte & ~(15 << shift)) | (value & 15) << shift);
+    }
+
+    // 展开为普通Grid（位置为原点）
+    Grid unpack() const {
+        Grid grid(width, height);
+        unpackNibbles(nibbles.data(), grid.pixels.size(), grid.pixels.data());
+        return grid;
+    }
+};
+
+} // namespace arc::core
@@ -0,0 +1,73 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace arc::core {
+
+// ============================================================================
+// 简单的分块并行工具 - 不依赖OpenMP
+// ============================================================================
+
+// 解析线程数：requested为0时使用硬件并发数，并保证每个线程至少有minItemsPerThread个任务
+inline std::size_t resolveThreadCount(std::size_t requested, std::size_t workItems,
+                                      std::size_t minItemsPerThread = 1) {
+    std::size_t threads = requested;
+    if (threads == 0) {
+        threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+    std::size_t byWork = workItems / std::max<std::size_t>(1, minItemsPerThread);
+    return std::max<std::size_t>(1, std::min(threads, byWork));
+}
+
+// 启动numWorkers个工作者并行执行fn(workerIndex)
+// 第0个在调用线程上执行；任一工作者抛出的第一个异常会在所有线程结束后重新抛出
+template <typename Fn>
+void parallelWorkers(std::size_t numWorkers, Fn&& fn) {
+    numWorkers = std::max<std::size_t>(1, numWorkers);
+    if (numWorkers == 1) {
+        fn(std::size_t{0});
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(numWorkers);
+    std::vector<std::thread> workers;
+    workers.reserve(numWorkers - 1);
+
+    auto runWorker = [&](std::size_t worker) {
+        try {
+            fn(worker);
+        } catch (...) {
+            errors[worker] = std::current_exception();
+        }
+    };
+
+    for (std::size_t worker = 1; worker < numWorkers; ++worker) {
+        workers.emplace_back(runWorker, worker);
+    }
+    runWorker(0);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+// 将[0, count)切分为numChunks个连续块，并行执行fn(begin, end, chunkIndex)
+template <typename Fn>
+void parallelChunks(std::size_t count, std::size_t numChunks, Fn&& fn) {
+    numChunks = std::max<std::size_t>(1, std::min(numChunks, count));
+    const std::size_t chunkSize = (count + numChunks - 1) / numChunks;
+
+    parallelWorkers(numChunks, [&](std::size_t chunk) {
+        std::size_t begin = chunk * chunkSize;
+        std::size_t end = std::min(count, begin + chunkSize);
+        if (begin < end || numChunks == 1) fn(begin, end, chunk);
+    });
+}
+
+} // namespace arc::core
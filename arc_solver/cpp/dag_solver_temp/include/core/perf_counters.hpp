@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "core/stage.hpp"
+
+namespace arc::core {
+
+// ============================================================================
+// 硬件性能计数器 - 每线程一个perf_event_open计数器组（周期、指令、缓存缺失、分支预测失败）
+//
+// 只在Linux上可用；内核不允许（perf_event_paranoid、容器seccomp）或硬件不支持时
+// PerfTaskScope::available()为false，所有计数为0，求解照常进行。
+// 计数器组在线程第一次使用时打开并常开，阶段切换时读取一次差值记到当前阶段
+// ============================================================================
+
+struct PerfCounts {
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t cacheMisses = 0;
+    std::uint64_t branchMisses = 0;
+
+    PerfCounts& operator+=(const PerfCounts& other);
+    PerfCounts operator-(const PerfCounts& other) const;
+    double ipc() const { return cycles > 0 ? static_cast<double>(instructions) / cycles : 0.0; }
+};
+
+using PerfStageCounts = std::array<PerfCounts, SOLVE_STAGE_COUNT>;
+
+// 一个任务的计数窗口：enabled为true时在当前线程打开计数器组并开始按阶段累计
+class PerfTaskScope {
+public:
+    explicit PerfTaskScope(bool enabled);
+    ~PerfTaskScope();
+
+    PerfTaskScope(const PerfTaskScope&) = delete;
+    PerfTaskScope& operator=(const PerfTaskScope&) = delete;
+
+    bool available() const { return active_; }
+    // 自构造以来各阶段的计数
+    PerfStageCounts stageDelta() const;
+
+private:
+    bool active_ = false;
+    bool previousActive_ = false;
+    PerfStageCounts baseline_{};
+};
+
+// 由StageScope调用：切换当前线程的计数阶段，返回之前的阶段；
+// 当前线程开启了计数时先把上次读取以来的计数记到旧阶段
+SolveStage enterPerfStage(SolveStage stage);
+
+} // namespace arc::core
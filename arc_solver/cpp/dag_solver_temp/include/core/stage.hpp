@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include "core/trace.hpp"
+
+namespace arc::core {
+
+// ============================================================================
+// 求解阶段 - 分配统计和硬件性能计数器共用同一组阶段
+//
+// 阶段标记是线程局部的；StageScope同时切换两者的当前阶段，退出时恢复。
+// 阶段边界通常还有一个追踪span，ARC_STAGE_SPAN一次声明两者：
+//
+//   ARC_STAGE_SPAN(span, "build_pieces", SolveStage::PieceExtraction);
+//   ARC_TRACE_COUNTER(span, "dags", dags.size());
+// ============================================================================
+
+enum class SolveStage : int {
+    Other = 0,
+    SizePrediction,
+    DAGBuild,
+    PieceExtraction,
+    Composition,
+    Evaluation,
+    Count
+};
+
+constexpr std::size_t SOLVE_STAGE_COUNT = static_cast<std::size_t>(SolveStage::Count);
+
+const char* solveStageName(SolveStage stage);
+
+// 在作用域内把当前线程的分配和性能计数记到stage下，退出时恢复之前的阶段
+class StageScope {
+public:
+    explicit StageScope(SolveStage stage);
+    ~StageScope();
+
+    StageScope(const StageScope&) = delete;
+    StageScope& operator=(const StageScope&) = delete;
+
+private:
+    SolveStage previousAlloc_;
+    SolveStage previousPerf_;
+};
+
+} // namespace arc::core
+
+#define ARC_STAGE_SPAN(var, name, stage) \
+    ARC_TRACE_SPAN(var, name);            \
+    ::arc::core::StageScope var##Stage(stage)
@@ -0,0 +1,101 @@
+#pragma once
+
+// ============================================================================
+// 阶段追踪 - RAII span写入Chrome trace JSON，可直接在Perfetto/chrome://tracing打开
+//
+// 定义ARC_ENABLE_TRACING编译时才有追踪代码；未定义时所有ARC_TRACE_*宏展开为空，
+// 参数不会被求值，也不链接trace.cpp
+//
+//   ARC_TRACE_SPAN(span, "build_dag");
+//   ARC_TRACE_COUNTER(span, "nodes", nodes_.size());
+//
+// 运行时还需Tracer::instance().start()开始记录，stop()之后writeChromeTrace()导出
+// ============================================================================
+
+#if defined(ARC_ENABLE_TRACING)
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace arc::core {
+
+struct TraceEvent {
+    const char* name = "";
+    const char* category = "";
+    std::int64_t start = 0;        // 微秒，相对Tracer启动时间
+    std::int64_t duration = 0;
+    std::uint32_t threadId = 0;
+    std::vector<std::pair<const char*, double>> counters;
+    std::vector<std::pair<const char*, std::string>> labels;
+};
+
+class Tracer {
+public:
+    static Tracer& instance();
+
+    void start();                  // 清空已有事件并开始记录
+    void stop();
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    std::int64_t now() const;
+    void record(TraceEvent&& event);
+
+    std::size_t eventCount() const;
+    void writeChromeTrace(const std::string& path) const;
+
+private:
+    // 每个线程一个缓冲区，只在导出时与写线程竞争各自的锁
+    struct ThreadBuffer {
+        std::uint32_t threadId = 0;
+        mutable std::mutex mutex;
+        std::vector<TraceEvent> events;
+    };
+
+    Tracer() = default;
+    ThreadBuffer& localBuffer();
+
+    std::atomic<bool> enabled_{false};
+    std::chrono::steady_clock::time_point epoch_ = std::chrono::steady_clock::now();
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;   // 线程退出后缓冲区仍保留
+};
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, const char* category = "solver");
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void counter(const char* key, double value) {
+        if (active_) event_.counters.emplace_back(key, value);
+    }
+    void label(const char* key, std::string value) {
+        if (active_) event_.labels.emplace_back(key, std::move(value));
+    }
+
+private:
+    bool active_;
+    TraceEvent event_;
+};
+
+} // namespace arc::core
+
+#define ARC_TRACE_SPAN(var, name) ::arc::core::TraceSpan var(name)
+#define ARC_TRACE_COUNTER(var, key, value) (var).counter((key), static_cast<double>(value))
+#define ARC_TRACE_LABEL(var, key, value) (var).label((key), (value))
+
+#else
+
+#define ARC_TRACE_SPAN(var, name) ((void)0)
+#define ARC_TRACE_COUNTER(var, key, value) ((void)0)
+#define ARC_TRACE_LABEL(var, key, value) ((void)0)
+
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/state.hpp"
+
+namespace arc::io {
+
+// ============================================================================
+// ARC JSON流式解析 - 不建立DOM，网格直接解析进arc::core::Grid
+// ============================================================================
+
+// 解析得到的一个ARC任务，保留全部test输入
+struct TaskRecord {
+    std::string id;
+    std::vector<std::pair<arc::core::Grid, arc::core::Grid>> train;
+    std::vector<arc::core::Grid> testInputs;
+    // 按test位置对应testInputs，来自任务文件或solutions文件；没有output的test为空，
+    // 整个任务都没有output时可以为空数组
+    std::vector<std::optional<arc::core::Grid>> testOutputs;
+};
+
+// 单任务文件: {"train": [...], "test": [...]}
+TaskRecord parseTaskJson(const char* data, std::size_t size, const std::string& id = "");
+
+// 合并的challenges文件: {"<id>": {"train": [...], "test": [...]}, ...}
+std::vector<TaskRecord> parseChallengesJson(const char* data, std::size_t size);
+
+// solutions文件: {"<id>": [grid, ...], ...}，按id写入tasks的testOutputs（按位置对应test）
+void applySolutionsJson(const char* data, std::size_t size, std::vector<TaskRecord>& tasks);
+
+// 自动识别格式：顶层第一个键是"train"或"test"时按单任务解析，否则按challenges解析
+std::vector<TaskRecord> parseArcJson(const char* data, std::size_t size, const std::string& defaultId = "");
+
+} // namespace arc::io
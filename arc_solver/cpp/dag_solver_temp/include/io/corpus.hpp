@@ -0,0 +1,130 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "core/state.hpp"
+#include "io/arc_json.hpp"
+#include "io/mapped_file.hpp"
+
+namespace arc::io {
+
+// ============================================================================
+// 二进制任务语料 - 一次转换，之后按mmap零拷贝读取
+//
+// 布局（小端）：
+//   CorpusHeader
+//   CorpusTaskEntry[taskCount]
+//   CorpusGridEntry[gridCount]    8字节对齐（含uint64字段），前面按需补零
+//   任务id字符串区
+//   网格像素区（每个网格16字节对齐，uint8或4位压缩）
+// 每个任务的网格连续存放：train输入/输出交替，然后test输入，最后test输出。
+// test输出要么没有，要么与test输入一一对应，缺少output的test用带CORPUS_GRID_ABSENT的空网格占位
+// ============================================================================
+
+static constexpr char CORPUS_MAGIC[8] = {'A', 'R', 'C', 'C', 'O', 'R', 'P', '1'};
+static constexpr std::uint32_t CORPUS_VERSION = 2;   // 2: 网格索引8字节对齐
+static constexpr std::uint32_t CORPUS_FLAG_NIBBLES = 1u << 0;  // 像素按4位压缩
+static constexpr std::uint32_t CORPUS_GRID_ABSENT = 1u << 0;   // 网格占位：该test没有output
+
+struct CorpusHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint32_t taskCount;
+    std::uint32_t gridCount;
+    std::uint64_t taskIndexOffset;
+    std::uint64_t gridIndexOffset;
+    std::uint64_t stringsOffset;
+    std::uint64_t payloadOffset;
+    std::uint64_t fileSize;
+};
+
+struct CorpusTaskEntry {
+    std::uint32_t idOffset;        // 相对字符串区
+    std::uint32_t idLength;
+    std::uint32_t firstGrid;
+    std::uint16_t trainCount;
+    std::uint16_t testCount;
+    std::uint16_t testOutputCount;
+    std::uint16_t reserved;
+};
+
+struct CorpusGridEntry {
+    std::uint64_t payloadOffset;   // 相对像素区
+    std::uint16_t width;
+    std::uint16_t height;
+    std::uint32_t flags;           // CORPUS_GRID_*
+};
+
+static_assert(sizeof(CorpusHeader) == 64, "CorpusHeader布局必须固定");
+static_assert(sizeof(CorpusTaskEntry) == 20, "CorpusTaskEntry布局必须固定");
+static_assert(sizeof(CorpusGridEntry) == 16, "CorpusGridEntry布局必须固定");
+
+// 写入语料文件；4位压缩时像素值超过15抛出std::runtime_error
+void writeCorpus(const std::vector<TaskRecord>& tasks, const std::string& path, bool packNibbles = false);
+
+// 转换器：challenges（或单任务）JSON + 可选solutions JSON -> 二进制语料，返回任务数
+std::size_t convertJsonToCorpus(
+    const std::string& jsonPath,
+    const std::string& corpusPath,
+    const std::string& solutionsPath = "",
+    bool packNibbles = false
+);
+
+// 只读网格视图 - 指向映射内存，uint8语料才有像素指针
+struct GridView {
+    int width = 0;
+    int height = 0;
+    const std::uint8_t* pixels = nullptr;  // 4位压缩语料中为压缩数据
+
+    std::size_t pixelCount() const { return static_cast<std::size_t>(width) * height; }
+};
+
+// 只读任务视图
+struct TaskView {
+    std::string id;
+    std::size_t firstGrid = 0;
+    std::size_t trainCount = 0;
+    std::size_t testCount = 0;
+    std::size_t testOutputCount = 0;   // 0或testCount，具体某个test是否有output见CorpusReader::hasGrid
+
+    std::size_t trainInputGrid(std::size_t i) const { return firstGrid + 2 * i; }
+    std::size_t trainOutputGrid(std::size_t i) const { return firstGrid + 2 * i + 1; }
+    std::size_t testInputGrid(std::size_t i) const { return firstGrid + 2 * trainCount + i; }
+    std::size_t testOutputGrid(std::size_t i) const { return firstGrid + 2 * trainCount + testCount + i; }
+};
+
+class CorpusReader {
+public:
+    explicit CorpusReader(const std::string& path);
+    // 直接读取内存中的语料（如从socket收到的），调用方须保证缓冲区在读取期间有效且按8字节对齐
+    CorpusReader(const char* data, std::size_t size);
+
+    std::size_t taskCount() const { return header_->taskCount; }
+    std::size_t gridCount() const { return header_->gridCount; }
+    bool isPacked() const { return (header_->flags & CORPUS_FLAG_NIBBLES) != 0; }
+
+    TaskView task(std::size_t index) const;
+    GridView gridView(std::size_t gridIndex) const;
+    // 占位网格（缺少output的test）返回false
+    bool hasGrid(std::size_t gridIndex) const;
+
+    // 物化为Grid：uint8语料一次memcpy，4位语料一次解包
+    arc::core::Grid loadGrid(std::size_t gridIndex) const;
+    void loadGridInto(std::size_t gridIndex, std::uint8_t* out) const;
+    TaskRecord loadTask(std::size_t index) const;
+    std::vector<TaskRecord> loadAll() const;
+
+private:
+    MappedFile file_;
+    const CorpusHeader* header_ = nullptr;
+    const CorpusTaskEntry* tasks_ = nullptr;
+    const CorpusGridEntry* grids_ = nullptr;
+    const char* strings_ = nullptr;
+    const std::uint8_t* payload_ = nullptr;
+
+    void attach(const char* data, std::size_t size, const std::string& path);
+};
+
+} // namespace arc::io
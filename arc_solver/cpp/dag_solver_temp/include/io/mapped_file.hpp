@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace arc::io {
+
+// ============================================================================
+// 只读内存映射文件 - RAII，只可移动
+// ============================================================================
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const std::string& path() const { return path_; }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::string path_;
+
+    void release();
+};
+
+} // namespace arc::io
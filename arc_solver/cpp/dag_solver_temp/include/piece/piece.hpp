@@ -34,11 +34,16 @@ public:
     // 对应icecuber的vector<int> mem - 存储所有piece的节点索引
     std::vector<arc::core::NodeID> memory;
     
-    PieceCollection() = default;
+    PieceCollection();
     PieceCollection(const PieceCollection&) = delete;
     PieceCollection& operator=(const PieceCollection&) = delete;
-    PieceCollection(PieceCollection&&) = default;
-    PieceCollection& operator=(PieceCollection&&) = default;
+    // 移动时代数随内容转移，被移走的对象换一个新代数
+    PieceCollection(PieceCollection&& other) noexcept;
+    PieceCollection& operator=(PieceCollection&& other) noexcept;
+    
+    // 集合代数：每个新构建的集合全局唯一，评分器以此缓存按集合计算的索引。
+    // 同一地址上重新提取（如迭代加深）得到的集合代数不同
+    std::uint64_t generation() const { return generation_; }
     
     // 获取指定piece在指定DAG中的节点ID
     arc::core::NodeID getPieceNodeId(std::size_t pieceIndex, std::size_t dagIndex) const;
@@ -66,6 +71,9 @@ public:
         std::size_t memoryUsage = 0;
     };
     Statistics getStatistics() const;
+    
+private:
+    std::uint64_t generation_;
 };
 
 // ============================================================================
@@ -78,10 +86,12 @@ public:
     struct Config {
         std::uint16_t maxDepth;          // 最大搜索深度
         std::uint32_t maxPieces;         // 最大piece数量
+        std::size_t maxNodes;            // 每个DAG的最大节点数
         bool enableParallelExtraction;   // 启用并行提取
         bool validateConsistency;        // 验证一致性
+        arc::core::Deadline deadline;    // 任务级预算，用尽时返回已提取的pieces
         
-        Config() : maxDepth(10), maxPieces(100000), enableParallelExtraction(true), validateConsistency(true) {}
+        Config() : maxDepth(10), maxPieces(100000), maxNodes(100000), enableParallelExtraction(true), validateConsistency(true) {}
     };
     
     PieceExtractor(const Config& config = Config());
@@ -96,6 +106,10 @@ public:
         const std::vector<arc::core::Point>& outputSizes = {}
     );
     
+    // 迭代加深：把collection中的DAG在原地扩展到depth，再在扩展后的DAG上重新提取pieces。
+    // 没有DAG产生新节点时返回false，collection保持不变
+    bool deepen(PieceCollection& collection, std::uint16_t depth);
+    
     const Config& getConfig() const { return config_; }
     void setConfig(const Config& config) { config_ = config; }
     
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "solver.hpp"
+
+namespace arc::solver {
+
+// ============================================================================
+// 进程隔离的批量求解 - 每个工作进程在任务和函数库加载完成后fork，
+// 这些页面以写时复制方式共享
+//
+// 工作进程通过管道领取任务下标、回传序列化的SolveResult。父进程轮询子进程的
+// 常驻内存和单任务耗时，超限时SIGKILL；子进程崩溃或被杀时，它正在求解的任务
+// 记为失败，并立即重启一个新的工作进程继续处理其余任务。
+// 父进程在run()期间保持单线程，避免fork多线程进程
+// ============================================================================
+
+class ProcessPool {
+public:
+    struct Config {
+        std::size_t workers;           // 工作进程数，0表示使用硬件并发数
+        std::size_t addressSpaceLimit; // 每个工作进程的RLIMIT_AS(字节)，0表示不限
+        std::size_t rssLimit;          // 每个工作进程的常驻内存上限(字节)，超出即杀死，0表示不限
+        double taskTimeout;            // 单任务墙钟上限(秒)，超出即杀死，0表示不限
+        int pollIntervalMs;            // 检查内存和超时的间隔
+
+        Config() : workers(0), addressSpaceLimit(0), rssLimit(0), taskTimeout(0.0), pollIntervalMs(50) {}
+    };
+
+    struct Failure {
+        std::size_t index = 0;         // 任务下标
+        std::string reason;
+    };
+
+    explicit ProcessPool(const Config& config = Config());
+
+    // 用solver的配置在工作进程中求解，结果按输入顺序返回并计入solver的统计
+    // onTaskDone在父进程中对每个成功返回结果的任务调用一次；工作进程崩溃或被杀的任务
+    // 只记入failures()，不回调，调用方据此追加日志时失败的任务不会被当作已完成
+    std::vector<SolveResult> run(ARCSolver& solver, const std::vector<ARCTask>& tasks,
+                                 const TaskDoneCallback& onTaskDone = nullptr);
+
+    const std::vector<Failure>& failures() const { return failures_; }
+    std::size_t restarts() const { return restarts_; }
+
+private:
+    struct Worker {
+        pid_t pid = -1;
+        int taskFd = -1;               // 父 -> 子：任务下标
+        int resultFd = -1;             // 子 -> 父：结果
+        long task = -1;                // 正在求解的任务，-1表示空闲
+        double taskStart = 0.0;
+        std::string killReason;        // 父进程主动杀死时的原因
+    };
+
+    Config config_;
+    std::vector<Failure> failures_;
+    std::size_t restarts_ = 0;
+
+    void spawn(std::vector<Worker>& workers, std::size_t slot, const SolverConfig& solverConfig,
+               const std::vector<ARCTask>& tasks);
+};
+
+// 读取进程的常驻内存（字节），读取失败返回0
+std::size_t processResidentBytes(pid_t pid);
+
+} // namespace arc::solver
@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "solver.hpp"
+#include "io/mapped_file.hpp"
+
+namespace arc::solver {
+
+// ============================================================================
+// 任务规范化 - 颜色重编号 + D4对称
+//
+// 对8种rigid变换分别把训练对和测试输入按固定顺序序列化，颜色按首次出现的顺序
+// 重编号（背景色0保持不变，很多变换把0当背景处理），取字节序最小的一种作为规范形式。
+// 颜色置换或旋转翻转后等价的任务得到相同的规范形式
+// ============================================================================
+
+struct CanonicalTask {
+    std::string bytes;                         // 规范形式
+    std::uint64_t hash = 0;                    // 规范形式的两个独立哈希，合起来作为键
+    std::uint64_t check = 0;
+    int transform = 0;                         // 施加在原任务上的rigid变换编号
+    std::array<std::uint8_t, 256> colorMap{};  // 原颜色 -> 规范颜色（完整置换）
+};
+
+CanonicalTask canonicalizeTask(const ARCTask& task);
+
+// 原任务空间的网格 <-> 规范空间的网格
+arc::core::Grid toCanonical(const arc::core::Grid& grid, const CanonicalTask& key);
+arc::core::Grid fromCanonical(const arc::core::Grid& grid, const CanonicalTask& key);
+
+// 影响求解结果的配置项和变换函数库（名称、代价、顺序）的指纹；
+// 线程数、打印开关等不影响结果的参数不计入
+std::uint64_t solverFingerprint(const SolverConfig& config);
+
+// ============================================================================
+// 持久化求解结果缓存
+//
+// 只追加的单文件：文件头 + 若干条记录（记录头 + 负载），负载带校验和。
+// 查找通过mmap进行，文件增长后重新映射并只索引新追加的部分；
+// 写入时持有flock排他锁并一次写完整条记录，崩溃留下的残缺尾部由下一次写入截掉。
+// 多个线程、多个进程可以同时打开同一个文件
+// ============================================================================
+
+struct CachedResult {
+    std::vector<arc::core::Grid> answers;      // 规范空间中的答案
+    float bestScore = 0.0f;
+    std::size_t totalPieces = 0;
+    std::size_t totalCandidates = 0;
+    int searchDepth = 0;
+    double solvingTime = 0.0;                  // 写入时的原始求解时间
+};
+
+class ResultCache {
+public:
+    // 文件不存在时在第一次写入时创建；文件头不匹配时抛出std::runtime_error
+    explicit ResultCache(const std::string& path);
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    bool lookup(const CanonicalTask& key, std::uint64_t fingerprint, CachedResult& result);
+    void store(const CanonicalTask& key, std::uint64_t fingerprint, const CachedResult& result);
+
+    const std::string& path() const { return path_; }
+    std::size_t entryCount();
+
+private:
+    std::string path_;
+    std::mutex mutex_;
+    arc::io::MappedFile file_;
+    std::size_t indexedBytes_ = 0;             // 已索引的有效前缀长度
+    std::unordered_multimap<std::uint64_t, std::size_t> index_;   // 键 -> 记录偏移
+
+    // 映射文件新增的部分，返回有效前缀是否覆盖整个文件
+    // refresh()持有共享flock，写入者截断残缺尾部时不会读到被截掉的页
+    bool refresh();
+    // 调用方已持有文件锁
+    bool refreshLocked();
+    bool readRecord(std::size_t offset, const CanonicalTask& key, std::uint64_t fingerprint,
+                    CachedResult& result) const;
+};
+
+} // namespace arc::solver
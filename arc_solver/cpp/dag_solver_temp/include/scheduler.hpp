@@ -0,0 +1,90 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "solver.hpp"
+
+namespace arc::solver {
+
+// ============================================================================
+// 任务耗时预测 - 只用加载后即可得到的廉价特征
+// ============================================================================
+
+struct TaskFeatures {
+    double pixels = 0.0;            // 所有训练输入输出和测试输入的像素总数
+    int maxSide = 0;                // 最大网格边长
+    int trainPairs = 0;
+    int paletteSize = 0;            // 出现过的颜色数（含背景）
+};
+
+TaskFeatures extractTaskFeatures(const ARCTask& task);
+
+// 相对耗时（无单位）：DAG规模随像素数和DAG个数增长，颜色多时变换分支更多
+double predictTaskCost(const TaskFeatures& features);
+double predictTaskCost(const ARCTask& task);
+
+// ============================================================================
+// 全局截止时间批量调度器
+//
+// 任务按预测耗时从长到短分发。每次分发时，用剩余墙钟时间乘以工作线程数、
+// 扣除正在运行任务尚未用完的预算，得到剩余容量，再按预测耗时占所有未分发
+// 任务的比例切给当前任务；提前完成的任务释放的预算自然流向后面的任务。
+// 节点预算随时间预算缩放。线程安全，供solveBatch的各工作线程共享
+// ============================================================================
+
+class BatchScheduler {
+public:
+    struct Config {
+        double totalBudget;            // 整批墙钟预算(秒)
+        double reserveFraction;        // 预留给加载、汇总等的比例
+        double minTaskBudget;          // 单任务最少时间，剩余时间不足时跳过任务
+        double nodeRate;               // 每秒可构建的“节点×像素”数，用于换算节点预算
+        std::size_t minNodes;          // 节点预算下限
+        std::size_t maxNodes;          // 节点预算上限（取自SolverConfig::maxNodes）
+
+        Config() : totalBudget(0.0), reserveFraction(0.05), minTaskBudget(0.05),
+                   nodeRate(2.0e6), minNodes(200), maxNodes(100000) {}
+    };
+
+    struct Assignment {
+        std::size_t index = 0;         // 任务在输入中的下标
+        double predictedCost = 0.0;
+        double timeBudget = 0.0;       // 秒
+        std::size_t nodeBudget = 0;    // 每个DAG的最大节点数
+        bool skipped = false;          // 全局时间已用尽，不求解
+    };
+
+    BatchScheduler(const std::vector<ARCTask>& tasks, std::size_t workers, const Config& config = Config());
+
+    // 取下一个任务，全部分发完返回false
+    bool next(Assignment& assignment);
+
+    // 任务结束（含跳过），释放其未用完的预算
+    void complete(const Assignment& assignment);
+
+    double elapsed() const;
+    const std::vector<double>& predictedCosts() const { return costs_; }
+
+private:
+    struct Running {
+        double start = 0.0;
+        double budget = 0.0;
+        bool active = false;
+    };
+
+    Config config_;
+    std::size_t workers_;
+    std::chrono::steady_clock::time_point start_;
+
+    std::vector<double> costs_;
+    std::vector<double> pixelsPerDAG_;       // 换算节点预算用
+    std::vector<std::size_t> order_;         // 按预测耗时降序
+    std::vector<Running> running_;           // 按任务下标
+
+    std::mutex mutex_;
+    std::size_t nextSlot_ = 0;
+    double remainingCost_ = 0.0;             // 未分发任务的预测耗时之和
+};
+
+} // namespace arc::solver
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "core/state.hpp"
+
+namespace arc::scoring {
+
+// ============================================================================
+// 评分内核 - 有SSE2时按16字节向量化，否则退化为标量实现
+// ============================================================================
+
+// ARC颜色数量，直方图只统计0-9
+static constexpr int NUM_COLORS = 10;
+
+// 逐字节比较，返回相等的像素数
+std::size_t countEqualPixels(const std::uint8_t* a, const std::uint8_t* b, std::size_t count);
+
+// 10色直方图（值 >= 10 的像素不计入）
+void colorHistogram(const std::uint8_t* pixels, std::size_t count, std::uint32_t histogram[NUM_COLORS]);
+
+// 一对图像的全部中间量，单次遍历得到
+struct GridPairMetrics {
+    bool sameSize = false;
+    std::size_t predictedPixels = 0;
+    std::size_t targetPixels = 0;
+    std::size_t matchingPixels = 0;     // 同尺寸时相等的像素数
+    std::size_t targetNonZero = 0;      // 同尺寸时目标的非零像素数
+    std::size_t sharedNonZero = 0;      // 同尺寸时两者都非零的像素数
+    std::uint32_t predictedHistogram[NUM_COLORS] = {0};
+    std::uint32_t targetHistogram[NUM_COLORS] = {0};
+};
+
+// 融合内核：一次遍历两个图像，同时得到像素一致、形状和颜色直方图
+GridPairMetrics computeGridPairMetrics(const arc::core::Grid& predicted, const arc::core::Grid& target);
+
+// 由中间量得到的各子分数，与pixelDiff/shapeBonus/sizeMatchBonus/colorDistributionSimilarity一致
+struct GridPairScores {
+    float pixel = 0.0f;
+    float shape = 0.0f;
+    float size = 0.0f;
+    float color = 0.0f;
+};
+
+GridPairScores scoresFromMetrics(const GridPairMetrics& metrics,
+                                 const arc::core::Grid& predicted,
+                                 const arc::core::Grid& target);
+
+} // namespace arc::scoring
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace arc::scoring {
+
+// ============================================================================
+// MinHash签名 + LSH分桶 - 近似最近邻相似度，整体近线性时间
+// ============================================================================
+
+class MinHashLSH {
+public:
+    struct Config {
+        int bands;                  // band数量，越多召回率越高
+        int rowsPerBand;            // 每个band的行数，越多越只保留高相似度的近邻
+        std::size_t maxBucketProbe; // 每个元素在桶内最多比较的邻居数，限制热点桶的开销
+        std::uint64_t seed;
+
+        Config() : bands(8), rowsPerBand(4), maxBucketProbe(16), seed(0x5DEECE66DULL) {}
+    };
+
+    explicit MinHashLSH(const Config& config = Config());
+
+    // 为一个指纹集合计算签名并加入索引，返回其编号；空集合不参与分桶，与任何集合的相似度为0
+    std::size_t add(const std::vector<std::uint64_t>& fingerprints);
+
+    std::size_t size() const { return count_; }
+    int numHashes() const { return config_.bands * config_.rowsPerBand; }
+
+    // 两个集合的Jaccard相似度估计（签名中相同位置相等的比例）
+    float estimateSimilarity(std::size_t a, std::size_t b) const;
+
+    // 每个集合与LSH候选近邻中最相似者的估计相似度；没有候选近邻时为0
+    std::vector<float> nearestSimilarities() const;
+
+private:
+    Config config_;
+    std::size_t count_ = 0;
+    std::vector<std::uint32_t> signatures_; // 按集合连续存放，每个集合numHashes()个值
+    std::vector<bool> empty_;               // 空集合的签名全为最大值，不能参与比较
+
+    const std::uint32_t* signature(std::size_t index) const {
+        return signatures_.data() + index * static_cast<std::size_t>(numHashes());
+    }
+};
+
+} // namespace arc::scoring
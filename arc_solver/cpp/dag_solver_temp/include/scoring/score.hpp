@@ -5,6 +5,7 @@
 #include "candidate/candidate.hpp"
 #include "piece/piece.hpp"
 #include "core/state.hpp"
+#include "scoring/kernels.hpp"
 
 namespace arc::scoring {
 
@@ -119,6 +120,12 @@ public:
         float depthPenalty = 0.05f;         // 深度惩罚
         float diversityBonus = 0.1f;        // 多样性奖励
         bool favorLowDepth = true;          // 偏好低深度pieces
+
+        // 多样性：对每个piece在各DAG上的图像指纹做MinHash，LSH分桶找近似最近邻
+        // 增大bands/maxBucketProbe更准确，减小则更快
+        int minHashBands = 8;               // LSH band数量
+        int minHashRowsPerBand = 4;         // 每个band的行数
+        std::size_t maxBucketProbe = 16;    // 每个piece在桶内最多比较的邻居数
     };
 
     PieceScorer(const Config& config = {});
@@ -152,12 +159,17 @@ private:
         const std::vector<arc::core::Grid>& targets
     );
 
-    // 计算piece的多样性
+    // 计算piece的多样性 - 查询按集合缓存的索引
     float calculateDiversity(
-        const arc::piece::Piece& piece,
         const arc::piece::PieceCollection& collection,
         std::size_t pieceIndex
     );
+
+    // 为整个集合一次性计算多样性（1 - 与最近邻的估计相似度），同一代集合只构建一次
+    void buildDiversityIndex(const arc::piece::PieceCollection& collection);
+
+    std::uint64_t indexedGeneration_ = 0;   // 0表示尚未建立索引
+    std::vector<float> diversity_;
 };
 
 // ============================================================================
@@ -175,11 +187,13 @@ public:
         float pieceWeight = 0.3f;           // Piece权重
         bool enableMultiObjective = true;   // 启用多目标优化
         std::size_t maxReturnedAnswers = 3; // 最大返回答案数 - 对应icecuber的assert
+        std::size_t numThreads = 0;         // 并行评分线程数，0表示使用硬件并发数
+        std::size_t minCandidatesPerThread = 64; // 每个线程最少的候选解数，避免小批量时的线程开销
     };
 
     IntegratedScorer(const Config& config = {});
 
-    // 综合评分和排序
+    // 综合评分和排序 - 分块并行评分，同一遍统计ScoringStatistics，只返回前maxReturnedAnswers个
     std::vector<arc::candidate::Candidate> scoreAndRank(
         std::vector<arc::candidate::Candidate> candidates,
         const arc::core::Grid& testInput,
@@ -216,9 +230,6 @@ private:
     PieceScorer pieceScorer_;
     ScoringStatistics lastStats_;
 
-    // 计算评分统计
-    void calculateStatistics(const std::vector<arc::candidate::Candidate>& candidates);
-
     // 多目标评分融合
     float fuseMultiObjectiveScores(
         float candidateScore,
@@ -271,11 +282,40 @@ public:
 private:
     Config config_;
 
+    static constexpr int NUM_STRATEGIES = 4;
+
+    // 单次评估的缓存 - 同一(candidate, target)上每个策略只计算一次，
+    // 像素一致、尺寸匹配、直方图等共享中间量也只计算一次
+    class EvaluationCache {
+    public:
+        EvaluationCache(const arc::candidate::Candidate& candidate, const arc::core::Grid& target);
+
+        bool hasAnswer() const { return answer_ != nullptr; }
+        const GridPairScores& pairScores();  // 一次融合遍历得到的子分数
+        bool exactMatch();
+
+        bool hasStrategyScore(StrategyType strategy) const { return ready_[static_cast<int>(strategy)]; }
+        float strategyScore(StrategyType strategy) const { return scores_[static_cast<int>(strategy)]; }
+        float storeStrategyScore(StrategyType strategy, float score);
+
+    private:
+        const arc::core::Grid* answer_;
+        const arc::core::Grid& target_;
+        bool metricsReady_ = false;
+        GridPairMetrics metrics_;
+        GridPairScores pairScores_;
+        bool ready_[NUM_STRATEGIES] = {false};
+        float scores_[NUM_STRATEGIES] = {0.0f};
+    };
+
+    // 带缓存的策略分派
+    float scoreCached(EvaluationCache& cache, StrategyType strategy);
+
     // 各种评分策略实现
-    float exactMatchScore(const arc::candidate::Candidate& candidate, const arc::core::Grid& target);
-    float structuralSimilarityScore(const arc::candidate::Candidate& candidate, const arc::core::Grid& target);
-    float progressiveEvalScore(const arc::candidate::Candidate& candidate, const arc::core::Grid& target);
-    float ensembleScore(const arc::candidate::Candidate& candidate, const arc::core::Grid& target);
+    float exactMatchScore(EvaluationCache& cache);
+    float structuralSimilarityScore(EvaluationCache& cache);
+    float progressiveEvalScore(EvaluationCache& cache);
+    float ensembleScore(EvaluationCache& cache);
 };
 
 // ============================================================================
@@ -291,10 +331,11 @@ float quickScore(
     const arc::core::Grid& target
 );
 
-// 批量评分
+// 批量评分 - numThreads为0时使用硬件并发数
 std::vector<float> batchScore(
     const std::vector<arc::candidate::Candidate>& candidates,
-    const arc::core::Grid& target
+    const arc::core::Grid& target,
+    std::size_t numThreads = 0
 );
 
 // 评分结果验证
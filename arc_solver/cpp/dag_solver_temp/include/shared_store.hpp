@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "task.hpp"
+#include "io/corpus.hpp"
+
+namespace arc::solver {
+
+class ARCSolver;
+
+// ============================================================================
+// 共享内存任务/结果存储 - 语料只加载一次，放进命名POSIX共享内存段，
+// 任意进程附加后通过CorpusReader得到零拷贝的网格视图
+//
+// 段布局（按页对齐）：
+//   StoreHeader                  可写：分发计数、完成计数
+//   语料字节 + 槽位索引          只读（附加后mprotect），每个test输入一个槽位
+//   结果槽位                     可写，每个槽位存一个encodeTaskResult
+// 进程通过claim()原子地领取槽位，互不协调即可分摊任务；内存和启动开销
+// 不随工作进程数增长。Python绑定（SharedTaskStore）同样可以附加、领取和读写结果，
+// CLI的--shm-collect在删除段之前把结果槽位读回报告和日志
+// ============================================================================
+
+class SharedTaskStore {
+public:
+    struct Config {
+        std::size_t slotBytes;         // 每个结果槽位的容量，放不下时丢弃靠后的答案
+
+        Config() : slotBytes(16384) {}
+    };
+
+    // 把二进制语料复制进新的共享内存段（name形如"/arc_eval"），段已存在时抛出std::runtime_error
+    static std::unique_ptr<SharedTaskStore> create(const std::string& name, const std::string& corpusPath,
+                                                   const Config& config = Config());
+
+    // 附加到已创建完成的段
+    static std::unique_ptr<SharedTaskStore> attach(const std::string& name);
+
+    // 删除段名；已附加的进程仍可使用，直到全部解除映射
+    static void unlink(const std::string& name);
+
+    ~SharedTaskStore();
+
+    SharedTaskStore(const SharedTaskStore&) = delete;
+    SharedTaskStore& operator=(const SharedTaskStore&) = delete;
+
+    const std::string& name() const { return name_; }
+
+    // 零拷贝访问语料：corpus().gridView()直接指向共享内存
+    const arc::io::CorpusReader& corpus() const { return *corpus_; }
+
+    // 槽位 = 一个test输入，顺序与TaskLoader::loadCorpus展开的任务一致
+    std::size_t slotCount() const;
+    std::size_t corpusTask(std::size_t slot) const;
+    std::size_t testIndex(std::size_t slot) const;
+
+    // 物化为求解器使用的ARCTask（复制该任务的网格）
+    ARCTask loadTask(std::size_t slot) const;
+
+    // 原子地领取下一个尚未分发的槽位，全部分发完返回-1
+    long claim();
+
+    // 写入/读取结果；读取时槽位尚无完整结果返回false
+    void storeResult(std::size_t slot, const ARCTask& task, const SolveResult& result);
+    bool loadResult(std::size_t slot, SolveResult& result) const;
+
+    std::size_t completed() const;
+
+private:
+    struct StoreHeader;
+    struct SlotEntry;
+
+    std::string name_;
+    char* base_ = nullptr;
+    std::size_t size_ = 0;
+    StoreHeader* header_ = nullptr;
+    const SlotEntry* slots_ = nullptr;
+    std::unique_ptr<arc::io::CorpusReader> corpus_;
+
+    SharedTaskStore(const std::string& name, char* base, std::size_t size);
+    char* resultSlot(std::size_t slot) const;
+};
+
+// 工作进程循环：领取槽位、求解、写回结果，直到全部分发完，返回本进程求解的任务数
+// 进程崩溃时它已领取的槽位不会重新分发，需要容错时使用ProcessPool或BatchCoordinator
+std::size_t solveFromStore(ARCSolver& solver, SharedTaskStore& store);
+
+} // namespace arc::solver
@@ -2,7 +2,12 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
 #include "core/state.hpp"
+#include "core/alloc_stats.hpp"
+#include "core/perf_counters.hpp"
+#include "core/deadline.hpp"
+#include "task.hpp"
 #include "transform/transform.hpp"
 #include "piece/piece.hpp"
 #include "candidate/candidate.hpp"
@@ -10,27 +15,7 @@
 
 namespace arc::solver {
 
-// ============================================================================
-// ARC任务数据结构
-// ============================================================================
-
-struct ARCExample {
-    arc::core::Grid input;
-    arc::core::Grid output;
-    
-    ARCExample(const arc::core::Grid& in, const arc::core::Grid& out) 
-        : input(in), output(out) {}
-};
-
-struct ARCTask {
-    std::string taskId;
-    std::vector<ARCExample> trainingExamples;
-    arc::core::Grid testInput;
-    arc::core::Grid testOutput; // 用于评估（实际求解时为空）
-    
-    std::size_t getTrainingCount() const { return trainingExamples.size(); }
-    bool hasTestOutput() const { return testOutput.width > 0 && testOutput.height > 0; }
-};
+class ResultCache;
 
 // ============================================================================
 // 求解器配置 - 对应icecuber的参数设置
@@ -42,6 +27,9 @@ struct SolverConfig {
     int maxSide = 100;              // 对应icecuber的MAXSIDE
     int maxArea = 1600;             // 对应icecuber的MAXAREA (40*40)
     int maxPixels = 8000;           // 对应icecuber的MAXPIXELS
+    std::size_t maxNodes = 100000;  // 每个DAG的最大节点数
+    bool iterativeDeepening = true; // 从initialDepth开始，训练对未被完全解释时逐层加深到maxDepth
+    int initialDepth = 2;
     
     // Piece提取参数
     std::size_t maxPieces = 100000; // 最大piece数量
@@ -56,41 +44,43 @@ struct SolverConfig {
     float complexityPenalty = 0.01f; // 对应icecuber的0.01
     std::size_t maxAnswers = 3;      // 对应icecuber的assert(answers.size() <= 3)
     
+    // 预算参数 - 超出后返回截至当时的最佳答案
+    double timeBudget = 0.0;         // 每个任务的墙钟时间预算(秒)，0表示不限
+    std::size_t memoryBudget = 0;    // 每个任务的内存预算(字节)，0表示不限
+    std::string resultCachePath;     // 非空时启用持久化结果缓存（见result_cache.hpp）
+    double batchDeadline = 0.0;      // solveBatch整批的墙钟预算(秒)，>0时由BatchScheduler逐任务分配时间和节点预算
+    std::size_t nodeBudget = 0;      // BatchScheduler分配的单任务节点预算，0表示使用maxNodes；不计入缓存指纹
+    std::string journalPath;         // 非空时solveBatch把完成的任务追加到该日志，重跑时跳过（见batch_journal.hpp）
+    
+    // 并行参数
+    std::size_t batchThreads = 0;    // solveBatch的工作线程数，0表示使用硬件并发数
+    std::size_t scoringThreads = 0;  // 单个任务内评分的线程数，0表示使用硬件并发数
+    
     // 调试参数
     bool printTimes = false;
     bool printMemory = false;
     bool printNodes = false;
     bool enableVisualization = false;
+    bool perfCounters = false;       // 按阶段采集硬件性能计数器（仅Linux，无权限时自动关闭）
 };
 
 // ============================================================================
-// 求解结果
+// 渐进式答案 - 求解过程中答案集一旦改进就回调，调用方可随时截断
 // ============================================================================
 
-struct SolveResult {
-    std::vector<arc::core::Grid> answers;      // 最多3个答案
-    double solvingTime = 0.0;                  // 求解时间（秒）
-    std::size_t totalPieces = 0;               // 生成的piece数量
-    std::size_t totalCandidates = 0;           // 生成的候选解数量
-    float bestScore = 0.0f;                    // 最佳候选解分数
-    bool success = false;                      // 是否成功求解
-    
-    // 对应icecuber的verdict系统
-    enum class Verdict {
-        Nothing = 0,     // 没有找到答案
-        Dimensions = 1,  // 尺寸正确
-        Candidate = 2,   // 有候选解
-        Correct = 3      // 完全正确
-    };
-    Verdict verdict = Verdict::Nothing;
-    
-    bool hasAnswers() const { return !answers.empty(); }
-    const arc::core::Grid& getBestAnswer() const { 
-        if (answers.empty()) throw std::runtime_error("No answers available");
-        return answers[0]; 
-    }
+struct AnswerUpdate {
+    std::vector<arc::core::Grid> answers;      // 当前最佳答案集（最多maxAnswers个）
+    float score = 0.0f;                        // 当前最佳候选解分数
+    double elapsed = 0.0;                      // 自开始求解经过的秒数
+    std::string stage;                         // 产生此更新的阶段
+    bool final = false;                        // 是否为最终排序后的结果
 };
 
+using AnswerCallback = std::function<void(const AnswerUpdate&)>;
+
+// 批量求解中每完成一个任务回调一次（参数为任务下标），可能在多个工作线程中并发调用
+using TaskDoneCallback = std::function<void(std::size_t, const SolveResult&)>;
+
 // ============================================================================
 // 主求解器 - 对应icecuber的runner核心逻辑
 // ============================================================================
@@ -98,12 +88,24 @@ struct SolveResult {
 class ARCSolver {
 public:
     ARCSolver(const SolverConfig& config = {});
+    ~ARCSolver();
     
-    // 主求解函数 - 对应icecuber的run函数核心逻辑
+    // 主求解函数 - 对应icecuber的run函数核心逻辑，预算取自timeBudget/memoryBudget
     SolveResult solve(const ARCTask& task);
     
+    // 使用外部预算求解，可由调用方取消
+    SolveResult solve(const ARCTask& task, const arc::core::Deadline& deadline);
+    
+    // 渐进式求解：精确piece检查后、每轮贪心组合后、最终排序后，答案集改进时回调onUpdate
+    SolveResult solve(const ARCTask& task, const arc::core::Deadline& deadline,
+                      const AnswerCallback& onUpdate);
+    
     // 批量求解 - 对应icecuber的批量处理
-    std::vector<SolveResult> solveBatch(const std::vector<ARCTask>& tasks);
+    // 每个工作线程拥有独立的求解组件，预计耗时长的任务先分发，结果按输入顺序返回
+    // batchDeadline > 0时整批受全局截止时间约束，每个任务的时间和节点预算见BatchScheduler
+    // journalPath非空时先从日志恢复已完成的任务，只求解其余任务并逐个追加到日志
+    std::vector<SolveResult> solveBatch(const std::vector<ARCTask>& tasks,
+                                        const TaskDoneCallback& onTaskDone = nullptr);
     
     // 获取统计信息
     struct Statistics {
@@ -113,9 +115,16 @@ public:
         int dimensionMatches = 0;
         double averageSolvingTime = 0.0;
         double totalTime = 0.0;
+        std::int64_t peakHeapBytes = 0;        // 所有任务中最大的堆高水位
+        std::array<arc::core::AllocCounters, arc::core::SOLVE_STAGE_COUNT> allocations{};
+        int cacheHits = 0;                     // 命中结果缓存的任务数
+        int perfTasks = 0;                     // 采集到性能计数器的任务数
+        arc::core::PerfStageCounts perfCounters{};
     };
     
     Statistics getStatistics() const { return statistics_; }
+    // 计入在本求解器之外（如工作进程中）得到的结果
+    void recordResult(const SolveResult& result) { updateStatistics(result); }
     void resetStatistics() { statistics_ = Statistics{}; }
     
     const SolverConfig& getConfig() const { return config_; }
@@ -130,6 +139,17 @@ private:
     std::unique_ptr<arc::piece::PieceExtractor> pieceExtractor_;
     std::unique_ptr<arc::candidate::CandidateComposer> candidateComposer_;
     std::unique_ptr<arc::scoring::IntegratedScorer> scorer_;
+    std::unique_ptr<ResultCache> resultCache_;
+    
+    // 按resultCachePath打开（或重新打开）缓存，未配置时返回nullptr
+    ResultCache* resultCache();
+    
+    // 不经过日志的批量求解
+    std::vector<SolveResult> solveTasks(const std::vector<ARCTask>& tasks, const TaskDoneCallback& onTaskDone);
+    
+    // 全局截止时间下的批量求解
+    std::vector<SolveResult> solveScheduled(const std::vector<ARCTask>& tasks, std::size_t numWorkers,
+                                            const TaskDoneCallback& onTaskDone);
     
     // 核心求解步骤 - 对应icecuber的主要流程
     
@@ -143,20 +163,38 @@ private:
     arc::piece::PieceCollection buildPieces(
         const arc::core::Grid& testInput,
         const std::vector<ARCExample>& training,
-        const std::vector<arc::core::Point>& outputSizes
+        const std::vector<arc::core::Point>& outputSizes,
+        int depth,
+        const arc::core::Deadline& deadline
+    );
+    
+    // 2.1 迭代加深 - 原地扩展已有DAG一层并重新提取pieces，DAG没有新节点时返回false
+    bool deepenPieces(
+        arc::piece::PieceCollection& pieces,
+        int depth,
+        const arc::core::Deadline& deadline
     );
     
-    // 3. 组合候选解 - 对应icecuber的composePieces2
+    // 2.5 精确piece检查 - 在所有训练对上都与输出一致的piece直接成为候选解
+    std::vector<arc::candidate::Candidate> findExactPieceCandidates(
+        const arc::piece::PieceCollection& pieces,
+        const std::vector<ARCExample>& training
+    );
+    
+    // 3. 组合候选解 - 对应icecuber的composePieces2，每轮组合结束后调用onRound
     std::vector<arc::candidate::Candidate> generateCandidates(
         arc::piece::PieceCollection& pieces,
         const std::vector<ARCExample>& training,
-        const std::vector<arc::core::Point>& outputSizes
+        const std::vector<arc::core::Point>& outputSizes,
+        const arc::core::Deadline& deadline,
+        const std::function<void(const std::vector<arc::candidate::Candidate>&)>& onRound = nullptr
     );
     
     // 4. 评估和排序 - 对应icecuber的evaluateCands
     std::vector<arc::candidate::Candidate> evaluateAndRank(
         std::vector<arc::candidate::Candidate> candidates,
-        const std::vector<ARCExample>& training
+        const std::vector<ARCExample>& training,
+        const arc::core::Deadline& deadline
     );
     
     // 5. 选择最佳答案 - 对应icecuber的答案过滤逻辑
@@ -166,6 +204,7 @@ private:
     
     // 辅助函数
     void updateStatistics(const SolveResult& result);
+    void mergeStatistics(const Statistics& other);
     SolveResult::Verdict calculateVerdict(
         const std::vector<arc::core::Grid>& answers,
         const ARCTask& task
@@ -178,17 +217,34 @@ private:
 // 任务加载器 - 对应icecuber的读取逻辑
 // ============================================================================
 
+// 每个test输入展开为一个ARCTask（taskId相同，testIndex区分）
 class TaskLoader {
 public:
-    // 从JSON文件加载单个任务
+    // 从JSON文件加载单个任务（第一个test输入）
     static ARCTask loadFromFile(const std::string& filepath);
     
-    // 从JSON字符串加载任务
+    // 从JSON字符串加载任务（第一个test输入）
     static ARCTask loadFromJson(const std::string& jsonStr);
     
-    // 批量加载任务目录
+    // 加载文件中的全部任务 - 自动识别单任务文件和合并的challenges文件
+    static std::vector<ARCTask> loadTasksFromFile(const std::string& filepath);
+    
+    // 同上，从内存中的JSON文本加载，单任务文件使用defaultId作为taskId
+    static std::vector<ARCTask> loadTasksFromJson(const char* data, std::size_t size, const std::string& defaultId);
+    
+    // 加载arc-agi_*_challenges.json，可选地从solutions.json填入testOutput
+    static std::vector<ARCTask> loadChallenges(
+        const std::string& challengesPath,
+        const std::string& solutionsPath = ""
+    );
+    
+    // 批量加载任务目录中的所有*.json（按文件名排序，文件名即taskId）
     static std::vector<ARCTask> loadFromDirectory(const std::string& dirPath);
     
+    // 从二进制语料加载（见io/corpus.hpp），每个网格一次memcpy
+    static std::vector<ARCTask> loadCorpus(const std::string& corpusPath);
+    static std::vector<ARCTask> loadCorpus(const char* data, std::size_t size);
+    
     // 创建简单测试任务
     static ARCTask createTestTask(
         const std::vector<std::pair<arc::core::Grid, arc::core::Grid>>& examples,
@@ -232,4 +288,53 @@ void printResult(int taskIndex, const std::string& taskId, const SolveResult& re
 // 打印统计摘要
 void printStatistics(const ARCSolver::Statistics& stats);
 
+// ============================================================================
+// 批量评估摘要 - 准确率、吞吐、延迟分位数、峰值内存
+// ============================================================================
+
+struct BatchSummary {
+    std::size_t tasks = 0;
+    std::size_t threads = 0;
+    std::size_t correct = 0;
+    std::size_t dimensions = 0;
+    std::size_t candidates = 0;
+    std::size_t nothing = 0;
+    std::size_t budgetExceeded = 0;
+    std::size_t withGroundTruth = 0;         // 有testOutput、可判定正确性的任务数
+    
+    double wallSeconds = 0.0;
+    double tasksPerSecond = 0.0;
+    double latencyMean = 0.0;                // 单任务求解时间（秒）
+    double latencyP50 = 0.0;
+    double latencyP90 = 0.0;
+    double latencyP99 = 0.0;
+    double latencyMax = 0.0;
+    
+    std::size_t peakRssBytes = 0;            // 进程峰值常驻内存
+    std::int64_t peakHeapBytes = 0;          // 单任务最大堆高水位（需分配统计构建）
+    
+    double accuracy() const { return withGroundTruth > 0 ? static_cast<double>(correct) / withGroundTruth : 0.0; }
+};
+
+// results与tasks一一对应，wallSeconds为整批墙钟时间
+BatchSummary summarizeBatch(
+    const std::vector<ARCTask>& tasks,
+    const std::vector<SolveResult>& results,
+    double wallSeconds,
+    std::size_t threads
+);
+
+void printBatchSummary(const BatchSummary& summary);
+
+// 写出机器可读的JSON：摘要 + 每个任务的verdict和耗时
+void writeBatchReportJson(
+    const std::string& path,
+    const BatchSummary& summary,
+    const std::vector<ARCTask>& tasks,
+    const std::vector<SolveResult>& results
+);
+
+// 当前进程的峰值常驻内存（字节），不支持的平台返回0
+std::size_t peakResidentBytes();
+
 } // namespace arc::solver 
\ No newline at end of file
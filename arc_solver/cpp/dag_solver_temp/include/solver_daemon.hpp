@@ -0,0 +1,148 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "solver.hpp"
+
+namespace arc::solver {
+
+// ============================================================================
+// 常驻求解守护进程 - 监听Unix domain socket，函数库和各工作线程的求解组件
+// 只在启动时构建一次，之后每次调用的延迟不再包含启动开销
+//
+// 协议（整数均为本机字节序，客户端与守护进程在同一台机器上）：
+//   请求 = RequestHeader + 负载（ARC JSON：单任务或challenges文件；或二进制语料）
+//   响应 = 若干ResponseHeader + 负载，同一请求的结果按完成顺序流式返回，
+//          最后以一个Done帧结束。同一连接上可以连续发送多个请求
+// ============================================================================
+
+constexpr std::uint32_t DAEMON_REQUEST_MAGIC = 0x51435241;    // "ARCQ"
+constexpr std::uint32_t DAEMON_RESPONSE_MAGIC = 0x53435241;   // "ARCS"
+
+enum class RequestFormat : std::uint8_t {
+    Json = 0,
+    Corpus = 1
+};
+
+enum class ResponseKind : std::uint8_t {
+    Result = 0,    // 负载为encodeTaskResult的输出（见batch_journal.hpp）
+    Error = 1,     // 负载为UTF-8错误信息（请求无法解析等）
+    Done = 2       // 负载为uint32结果数
+};
+
+struct RequestHeader {
+    std::uint32_t magic;
+    std::uint8_t format;           // RequestFormat
+    std::uint8_t reserved[3];
+    std::uint32_t requestId;       // 由客户端分配，响应帧原样带回
+    float timeBudget;              // 每个任务的时间预算(秒)，0表示使用守护进程的配置
+    std::uint32_t payloadBytes;
+};
+
+struct ResponseHeader {
+    std::uint32_t magic;
+    std::uint32_t requestId;
+    std::uint8_t kind;             // ResponseKind
+    std::uint8_t reserved[3];
+    std::uint32_t payloadBytes;
+};
+
+static_assert(sizeof(RequestHeader) == 20, "RequestHeader布局必须固定");
+static_assert(sizeof(ResponseHeader) == 16, "ResponseHeader布局必须固定");
+
+class SolverDaemon {
+public:
+    struct Config {
+        std::string socketPath;
+        std::size_t workers;           // 求解线程数，0表示使用硬件并发数
+        std::size_t maxQueuedTasks;    // 等待求解的任务上限，超出时暂停读取新请求
+        std::size_t maxRequestBytes;   // 单个请求负载上限
+
+        Config() : workers(0), maxQueuedTasks(1024), maxRequestBytes(256u << 20) {}
+    };
+
+    SolverDaemon(const SolverConfig& solverConfig, const Config& config);
+    ~SolverDaemon();
+
+    SolverDaemon(const SolverDaemon&) = delete;
+    SolverDaemon& operator=(const SolverDaemon&) = delete;
+
+    // 绑定socket并服务，直到stop()；退出前删除socket文件
+    // socket已被另一个存活的守护进程占用时抛出std::runtime_error
+    void run();
+
+    // 只做原子写和shutdown()，可以在信号处理函数中调用
+    void stop();
+
+    std::size_t requestsServed() const { return requests_.load(); }
+    std::size_t tasksSolved() const { return tasks_.load(); }
+
+private:
+    struct Connection;
+    struct Request;
+
+    struct Job {
+        std::shared_ptr<Connection> connection;
+        std::shared_ptr<Request> request;
+        std::size_t index = 0;
+    };
+
+    SolverConfig solverConfig_;
+    Config config_;
+
+    std::atomic<int> listenFd_{-1};
+    std::atomic<bool> stopping_{false};
+
+    // 任务队列
+    std::mutex queueMutex_;
+    std::condition_variable queueReady_;
+    std::condition_variable queueSpace_;
+    std::deque<Job> queue_;
+    bool workersStop_ = false;
+    std::size_t numWorkers_ = 0;
+    std::vector<std::thread> workers_;
+
+    // 连接，每个连接一个读取线程
+    std::mutex connectionsMutex_;
+    std::condition_variable connectionsDone_;
+    std::vector<std::weak_ptr<Connection>> connections_;
+    std::size_t activeConnections_ = 0;
+
+    std::atomic<std::size_t> requests_{0};
+    std::atomic<std::size_t> tasks_{0};
+
+    void serveConnection(std::shared_ptr<Connection> connection);
+    void workerLoop();
+    void enqueue(const std::shared_ptr<Connection>& connection, const std::shared_ptr<Request>& request);
+    void finishJob(const Job& job);
+};
+
+// 守护进程的客户端 - 一次一个请求，结果到达时回调
+class SolverClient {
+public:
+    using ResultCallback = std::function<void(const std::string& taskId, std::size_t testIndex, const SolveResult&)>;
+
+    explicit SolverClient(const std::string& socketPath);
+    ~SolverClient();
+
+    SolverClient(const SolverClient&) = delete;
+    SolverClient& operator=(const SolverClient&) = delete;
+
+    // 返回收到的结果数；守护进程报告错误或连接断开时抛出std::runtime_error
+    std::size_t solve(const std::string& payload, RequestFormat format, double timeBudget,
+                      const ResultCallback& onResult);
+
+private:
+    int fd_ = -1;
+    std::uint32_t nextRequestId_ = 1;
+};
+
+} // namespace arc::solver
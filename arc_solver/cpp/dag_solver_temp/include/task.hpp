@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "core/state.hpp"
+#include "core/alloc_stats.hpp"
+#include "core/perf_counters.hpp"
+
+namespace arc::solver {
+
+// ============================================================================
+// ARC任务数据结构 - 与求解器分离，批量日志、共享内存存储和Python绑定
+// 只依赖这里的类型，不必引入求解组件
+// ============================================================================
+
+struct ARCExample {
+    arc::core::Grid input;
+    arc::core::Grid output;
+    
+    ARCExample(const arc::core::Grid& in, const arc::core::Grid& out) 
+        : input(in), output(out) {}
+};
+
+struct ARCTask {
+    std::string taskId;
+    std::size_t testIndex = 0;  // 同一任务有多个test输入时的序号
+    std::vector<ARCExample> trainingExamples;
+    arc::core::Grid testInput;
+    arc::core::Grid testOutput; // 用于评估（实际求解时为空）
+    
+    std::size_t getTrainingCount() const { return trainingExamples.size(); }
+    bool hasTestOutput() const { return testOutput.width > 0 && testOutput.height > 0; }
+};
+
+// ============================================================================
+// 求解结果
+// ============================================================================
+
+// 各阶段墙钟时间（秒）
+struct StageTimes {
+    double sizePrediction = 0.0;
+    double dagBuild = 0.0;          // 所有DAG的构建时间之和
+    double pieceExtraction = 0.0;   // Piece构建中除DAG构建以外的部分
+    double composition = 0.0;
+    double evaluation = 0.0;
+};
+
+struct SolveResult {
+    std::vector<arc::core::Grid> answers;      // 最多3个答案
+    double solvingTime = 0.0;                  // 求解时间（秒）
+    std::size_t totalPieces = 0;               // 生成的piece数量
+    std::size_t totalCandidates = 0;           // 生成的候选解数量（迭代加深时为各轮之和）
+    int searchDepth = 0;                       // 最终的DAG搜索深度
+    float bestScore = 0.0f;                    // 最佳候选解分数
+    bool success = false;                      // 是否成功求解
+    bool budgetExceeded = false;               // 时间/内存预算用尽或被取消，答案为截至当时的最佳结果
+    bool cacheHit = false;                     // 答案来自持久化结果缓存
+    StageTimes stageTimes;
+    
+    // 分配统计（仅在以ARC_ALLOC_ACCOUNTING链接分配钩子的构建中非零）
+    std::int64_t peakHeapBytes = 0;            // 求解期间堆高水位（高于开始时的字节数）
+    std::array<arc::core::AllocCounters, arc::core::SOLVE_STAGE_COUNT> allocations{};  // 按阶段
+    
+    // 硬件性能计数器（config.perfCounters且perf_event可用时有效）
+    bool perfAvailable = false;
+    arc::core::PerfStageCounts perfCounters{};
+    
+    // 对应icecuber的verdict系统
+    enum class Verdict {
+        Nothing = 0,     // 没有找到答案
+        Dimensions = 1,  // 尺寸正确
+        Candidate = 2,   // 有候选解
+        Correct = 3      // 完全正确
+    };
+    Verdict verdict = Verdict::Nothing;
+    
+    bool hasAnswers() const { return !answers.empty(); }
+    const arc::core::Grid& getBestAnswer() const { 
+        if (answers.empty()) throw std::runtime_error("No answers available");
+        return answers[0]; 
+    }
+};
+
+} // namespace arc::solver
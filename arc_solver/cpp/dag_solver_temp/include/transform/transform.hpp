@@ -118,7 +118,7 @@ arc::core::Grid majorityCol(const arc::core::Grid& img);
 // 高级变换函数注册
 // ============================================================================
 
-// 初始化所有变换函数 - 对应icecuber的initFuncs3
+// 初始化所有变换函数 - 对应icecuber的initFuncs3，只会执行一次，线程安全
 void initializeTransformFunctions();
 
 } // namespace arc::transform 
\ No newline at end of file
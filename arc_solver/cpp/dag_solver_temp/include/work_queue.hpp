@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "solver.hpp"
+
+namespace arc::solver {
+
+// ============================================================================
+// 多机批量分发 - 协调进程通过TCP按任务下标分发租约，工作进程拉取任务、
+// 求解后回传结果
+//
+// 协调进程和所有工作进程加载同一份任务文件（challenges JSON、目录或语料），
+// 握手时比对任务集指纹。工作进程求解期间定时发心跳续租；连接断开时其全部
+// 租约立即收回，心跳超时的租约到期收回，重新排队。同一任务被收回maxAttempts
+// 次后记为失败，避免一个必然崩溃的任务拖垮所有工作进程。
+// solver配置了journalPath时复用批量运行日志：已记录的任务不再分发，新结果逐个追加；
+// 记为失败的任务不写日志，重启后重新分发
+// ============================================================================
+
+class BatchCoordinator {
+public:
+    struct Config {
+        std::string bindAddress;       // IPv4监听地址；协议没有认证，默认只监听本机，跨机器时须显式指定
+        int port;
+        double leaseTimeout;           // 租约多久没有心跳即收回(秒)
+        std::size_t maxAttempts;       // 同一任务最多被收回几次
+        int pollIntervalMs;
+
+        Config() : bindAddress("127.0.0.1"), port(7077), leaseTimeout(30.0), maxAttempts(3), pollIntervalMs(100) {}
+    };
+
+    struct Failure {
+        std::size_t index = 0;         // 任务下标
+        std::string reason;
+    };
+
+    explicit BatchCoordinator(const Config& config = Config());
+
+    // 阻塞直到所有任务完成或失败，结果按输入顺序返回并计入solver的统计
+    std::vector<SolveResult> run(ARCSolver& solver, const std::vector<ARCTask>& tasks);
+
+    const std::vector<Failure>& failures() const { return failures_; }
+    std::size_t reassignments() const { return reassignments_; }
+    std::size_t workersSeen() const { return workersSeen_; }
+
+private:
+    Config config_;
+    std::vector<Failure> failures_;
+    std::size_t reassignments_ = 0;
+    std::size_t workersSeen_ = 0;
+};
+
+class BatchWorker {
+public:
+    struct Config {
+        std::string host;
+        int port;
+        std::size_t threads;           // 并发连接数，每个连接一个求解线程，0表示使用硬件并发数
+        double connectTimeout;         // 协调进程尚未启动时重试连接的时长(秒)
+
+        Config() : host("127.0.0.1"), port(7077), threads(1), connectTimeout(30.0) {}
+    };
+
+    explicit BatchWorker(const Config& config = Config());
+
+    // 拉取并求解任务直到协调进程宣布结束，返回本进程求解的任务数
+    // 任务集与协调进程不一致或无法连接时抛出std::runtime_error
+    std::size_t run(const SolverConfig& solverConfig, const std::vector<ARCTask>& tasks);
+
+private:
+    Config config_;
+
+    std::size_t serve(const SolverConfig& solverConfig, const std::vector<ARCTask>& tasks);
+};
+
+// 任务集指纹：按顺序哈希每个任务的taskId和testIndex
+std::uint64_t taskSetFingerprint(const std::vector<ARCTask>& tasks);
+
+} // namespace arc::solver
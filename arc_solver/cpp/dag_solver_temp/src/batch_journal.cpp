@@ -0,0 +1,394 @@
+#include "batch_journal.hpp"
+#include "core/log.hpp"
+#include "io/mapped_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace arc::solver {
+
+namespace {
+
+constexpr char JOURNAL_MAGIC[8] = {'A', 'R', 'C', 'J', 'R', 'N', 'L', '1'};
+constexpr std::uint32_t JOURNAL_VERSION = 3;
+constexpr std::uint32_t ENTRY_MAGIC = 0x59524e45;   // "ENRY"
+
+struct JournalHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t solverFingerprint;   // 写入这些结果的求解器配置
+};
+
+struct EntryHeader {
+    std::uint32_t magic;
+    std::uint32_t payloadBytes;
+    std::uint64_t checksum;        // 负载的FNV-1a
+};
+
+static_assert(sizeof(JournalHeader) == 24, "JournalHeader布局必须固定");
+static_assert(sizeof(EntryHeader) == 16, "EntryHeader布局必须固定");
+
+std::uint64_t fnv1a(const char* data, std::size_t size) {
+    std::uint64_t hash = 1469598103934665603ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<std::uint8_t>(data[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+void put(std::string& buffer, const T& value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// 顺序读取负载，越界时置失败标志
+class Reader {
+public:
+    Reader(const char* data, std::size_t size) : data_(data), end_(data + size) {}
+
+    template <typename T>
+    T get() {
+        T value{};
+        if (data_ + sizeof(T) > end_) {
+            ok_ = false;
+            return value;
+        }
+        std::memcpy(&value, data_, sizeof(T));
+        data_ += sizeof(T);
+        return value;
+    }
+
+    const char* take(std::size_t size) {
+        if (data_ + size > end_) {
+            ok_ = false;
+            return nullptr;
+        }
+        const char* p = data_;
+        data_ += size;
+        return p;
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    const char* data_;
+    const char* end_;
+    bool ok_ = true;
+};
+
+std::string encodeEntry(const ARCTask& task, const SolveResult& result) {
+    const std::string payload = encodeTaskResult(task, result);
+    EntryHeader header{ENTRY_MAGIC, static_cast<std::uint32_t>(payload.size()), fnv1a(payload.data(), payload.size())};
+    std::string record;
+    put(record, header);
+    record += payload;
+    return record;
+}
+
+void writeAll(int fd, const std::string& buffer) {
+    std::size_t written = 0;
+    while (written < buffer.size()) {
+        ssize_t n = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            throw std::runtime_error("写入批量运行日志失败");
+        }
+        written += static_cast<std::size_t>(n);
+    }
+}
+
+void writeGridJson(std::ostream& out, const arc::core::Grid& grid) {
+    out << '[';
+    for (int r = 0; r < grid.height; ++r) {
+        if (r > 0) out << ',';
+        out << '[';
+        for (int c = 0; c < grid.width; ++c) {
+            if (c > 0) out << ',';
+            out << static_cast<int>(grid(r, c));
+        }
+        out << ']';
+    }
+    out << ']';
+}
+
+} // namespace
+
+// ============================================================================
+// 任务结果编码
+// ============================================================================
+
+std::string encodeTaskResult(const ARCTask& task, const SolveResult& result) {
+    std::string payload;
+    put(payload, static_cast<std::uint16_t>(task.taskId.size()));
+    payload += task.taskId;
+    put(payload, static_cast<std::uint32_t>(task.testIndex));
+    put(payload, static_cast<std::uint8_t>(result.verdict));
+    put(payload, static_cast<std::uint8_t>(result.success));
+    put(payload, static_cast<std::uint8_t>(result.budgetExceeded));
+    put(payload, static_cast<std::uint8_t>(result.cacheHit));
+    put(payload, result.bestScore);
+    put(payload, result.solvingTime);
+    put(payload, static_cast<std::uint64_t>(result.totalPieces));
+    put(payload, static_cast<std::uint64_t>(result.totalCandidates));
+    put(payload, static_cast<std::int32_t>(result.searchDepth));
+    put(payload, static_cast<std::uint32_t>(result.answers.size()));
+    for (const auto& answer : result.answers) {
+        put(payload, static_cast<std::uint16_t>(answer.width));
+        put(payload, static_cast<std::uint16_t>(answer.height));
+        payload.append(reinterpret_cast<const char*>(answer.pixels.data()), answer.pixels.size());
+    }
+    put(payload, static_cast<std::int64_t>(result.peakHeapBytes));
+    put(payload, static_cast<std::uint8_t>(result.perfAvailable));
+    put(payload, result.stageTimes);
+    put(payload, result.allocations);
+    put(payload, result.perfCounters);
+
+    return payload;
+}
+
+bool decodeTaskResult(const char* data, std::size_t size, std::string& taskId, std::size_t& testIndex,
+                      SolveResult& result) {
+    Reader reader(data, size);
+    const auto idLength = reader.get<std::uint16_t>();
+    const char* id = reader.take(idLength);
+    if (!reader.ok()) return false;
+    taskId.assign(id, idLength);
+    testIndex = reader.get<std::uint32_t>();
+
+    result = SolveResult{};
+    result.verdict = static_cast<SolveResult::Verdict>(reader.get<std::uint8_t>());
+    result.success = reader.get<std::uint8_t>() != 0;
+    result.budgetExceeded = reader.get<std::uint8_t>() != 0;
+    result.cacheHit = reader.get<std::uint8_t>() != 0;
+    result.bestScore = reader.get<float>();
+    result.solvingTime = reader.get<double>();
+    result.totalPieces = reader.get<std::uint64_t>();
+    result.totalCandidates = reader.get<std::uint64_t>();
+    result.searchDepth = reader.get<std::int32_t>();
+
+    const auto answerCount = reader.get<std::uint32_t>();
+    for (std::uint32_t i = 0; i < answerCount && reader.ok(); ++i) {
+        const auto width = reader.get<std::uint16_t>();
+        const auto height = reader.get<std::uint16_t>();
+        arc::core::Grid grid(width, height);
+        const char* pixels = reader.take(grid.pixels.size());
+        if (!reader.ok()) break;
+        std::memcpy(grid.pixels.data(), pixels, grid.pixels.size());
+        result.answers.push_back(std::move(grid));
+    }
+    result.peakHeapBytes = reader.get<std::int64_t>();
+    result.perfAvailable = reader.get<std::uint8_t>() != 0;
+    result.stageTimes = reader.get<StageTimes>();
+    result.allocations = reader.get<decltype(result.allocations)>();
+    result.perfCounters = reader.get<arc::core::PerfStageCounts>();
+    return reader.ok();
+}
+
+// ============================================================================
+// BatchJournal
+// ============================================================================
+
+BatchJournal::BatchJournal(const std::string& path, std::uint64_t solverFingerprint, const Config& config)
+    : path_(path), solverFingerprint_(solverFingerprint), config_(config),
+      lastSync_(std::chrono::steady_clock::now()) {
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("无法打开批量运行日志: " + path_);
+    }
+    if (::flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+        ::close(fd_);
+        throw std::runtime_error("批量运行日志正被其他进程使用: " + path_);
+    }
+
+    try {
+        load();
+    } catch (...) {
+        ::close(fd_);
+        throw;
+    }
+}
+
+BatchJournal::~BatchJournal() {
+    if (fd_ >= 0) {
+        ::fsync(fd_);
+        ::close(fd_);   // 关闭描述符同时释放flock
+    }
+}
+
+void BatchJournal::load() {
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        throw std::runtime_error("无法读取批量运行日志信息: " + path_);
+    }
+
+    std::size_t validEnd = 0;
+    if (st.st_size > 0) {
+        arc::io::MappedFile file(path_);
+        JournalHeader header;
+        if (file.size() >= sizeof(header)) {
+            std::memcpy(&header, file.data(), sizeof(header));
+            if (std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+                header.version != JOURNAL_VERSION) {
+                throw std::runtime_error("不是批量运行日志或版本不兼容: " + path_);
+            }
+            if (header.solverFingerprint != solverFingerprint_) {
+                throw std::runtime_error("批量运行日志由不同的求解器配置写入，删除它或换一个日志路径: " + path_);
+            }
+            validEnd = sizeof(header);
+        }
+
+        while (validEnd != 0 && validEnd + sizeof(EntryHeader) <= file.size()) {
+            EntryHeader entryHeader;
+            std::memcpy(&entryHeader, file.data() + validEnd, sizeof(entryHeader));
+            const char* payload = file.data() + validEnd + sizeof(entryHeader);
+            const std::size_t end = validEnd + sizeof(entryHeader) + entryHeader.payloadBytes;
+            Entry entry;
+            if (entryHeader.magic != ENTRY_MAGIC || end > file.size() ||
+                fnv1a(payload, entryHeader.payloadBytes) != entryHeader.checksum ||
+                !decodeTaskResult(payload, entryHeader.payloadBytes, entry.taskId, entry.testIndex, entry.result)) {
+                break;
+            }
+            index_[{entry.taskId, entry.testIndex}] = entries_.size();
+            entries_.push_back(std::move(entry));
+            validEnd = end;
+        }
+
+        if (validEnd < file.size()) {
+            ARC_LOG_WARN("批量运行日志尾部有 " << (file.size() - validEnd) << " 字节残缺记录，已截断");
+            if (::ftruncate(fd_, static_cast<off_t>(validEnd)) != 0) {
+                throw std::runtime_error("无法截断批量运行日志: " + path_);
+            }
+        }
+    }
+
+    if (validEnd == 0) {
+        JournalHeader header{};
+        std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+        header.version = JOURNAL_VERSION;
+        header.solverFingerprint = solverFingerprint_;
+        std::string bytes;
+        put(bytes, header);
+        writeAll(fd_, bytes);
+        ::fsync(fd_);
+    }
+}
+
+const SolveResult* BatchJournal::find(const std::string& taskId, std::size_t testIndex) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find({taskId, testIndex});
+    return it == index_.end() ? nullptr : &entries_[it->second].result;
+}
+
+std::vector<std::size_t> BatchJournal::restore(const std::vector<ARCTask>& tasks,
+                                               std::vector<SolveResult>& results) const {
+    std::vector<std::size_t> pending;
+    results.resize(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        if (const SolveResult* recorded = find(tasks[i].taskId, tasks[i].testIndex)) {
+            results[i] = *recorded;
+        } else {
+            pending.push_back(i);
+        }
+    }
+    return pending;
+}
+
+void BatchJournal::append(const ARCTask& task, const SolveResult& result) {
+    const std::string record = encodeEntry(task, result);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    writeAll(fd_, record);
+
+    Entry entry;
+    entry.taskId = task.taskId;
+    entry.testIndex = task.testIndex;
+    entry.result = result;
+    index_[{entry.taskId, entry.testIndex}] = entries_.size();
+    entries_.push_back(std::move(entry));
+
+    // 按条数或时间批量fsync，崩溃最多丢失最近一批
+    const auto now = std::chrono::steady_clock::now();
+    if (++unsynced_ >= config_.syncEvery ||
+        std::chrono::duration<double>(now - lastSync_).count() >= config_.syncInterval) {
+        ::fdatasync(fd_);
+        unsynced_ = 0;
+        lastSync_ = now;
+    }
+}
+
+void BatchJournal::sync() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ::fsync(fd_);
+    unsynced_ = 0;
+    lastSync_ = std::chrono::steady_clock::now();
+}
+
+std::size_t BatchJournal::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+}
+
+void BatchJournal::writeSubmission(const std::string& path, const std::vector<ARCTask>& tasks) const {
+    // 按taskId首次出现的顺序分组，每个任务的test数取任务列表中最大的testIndex + 1
+    std::vector<std::string> taskOrder;
+    std::map<std::string, std::size_t> testCounts;
+    for (const auto& task : tasks) {
+        auto [it, inserted] = testCounts.emplace(task.taskId, 0);
+        if (inserted) {
+            taskOrder.push_back(task.taskId);
+        }
+        it->second = std::max(it->second, task.testIndex + 1);
+    }
+
+    // 先写临时文件再rename，中途失败不会留下半个submission
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("无法写入 " + tmpPath);
+        }
+
+        const arc::core::Grid empty(1, 1);
+        out << '{';
+        bool firstTask = true;
+        for (const auto& taskId : taskOrder) {
+            if (!firstTask) out << ',';
+            firstTask = false;
+            out << "\n\"" << taskId << "\": [";
+
+            // 日志中没有记录的test（预算跳过、尚未求解或失败）用1x1空网格占位
+            const std::size_t testCount = testCounts[taskId];
+            for (std::size_t t = 0; t < testCount; ++t) {
+                if (t > 0) out << ", ";
+                const SolveResult* recorded = find(taskId, t);
+                const std::vector<arc::core::Grid>* answers = recorded ? &recorded->answers : nullptr;
+                const arc::core::Grid& first = answers && !answers->empty() ? (*answers)[0] : empty;
+                const arc::core::Grid& second = answers && answers->size() > 1 ? (*answers)[1] : first;
+                out << "{\"attempt_1\": ";
+                writeGridJson(out, first);
+                out << ", \"attempt_2\": ";
+                writeGridJson(out, second);
+                out << '}';
+            }
+            out << ']';
+        }
+        out << "\n}\n";
+        if (!out.good()) {
+            throw std::runtime_error("写入 " + tmpPath + " 失败");
+        }
+    }
+
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("无法替换 " + path);
+    }
+}
+
+} // namespace arc::solver
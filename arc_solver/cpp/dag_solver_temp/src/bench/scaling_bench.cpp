@@ -0,0 +1,159 @@
+// 扩展性基准：分别扫描网格尺寸、训练对数、颜色数、连通块数，输出各阶段耗时曲线
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench/synthetic.hpp"
+
+using namespace arc::solver;
+using arc::bench::SyntheticTaskSpec;
+
+namespace {
+
+struct Sweep {
+    std::string dimension;
+    std::vector<int> values;
+    std::function<void(SyntheticTaskSpec&, int)> apply;
+};
+
+struct SweepPoint {
+    std::string dimension;
+    int value = 0;
+    int tasks = 0;
+    int correct = 0;
+    StageTimes times;          // 各任务平均
+    double total = 0.0;
+    double pieces = 0.0;
+    double candidates = 0.0;
+};
+
+std::vector<Sweep> defaultSweeps() {
+    return {
+        {"size", {5, 10, 15, 20, 25, 30}, [](SyntheticTaskSpec& s, int v) { s.width = v; s.height = v; }},
+        {"pairs", {1, 2, 3, 4, 5, 6}, [](SyntheticTaskSpec& s, int v) { s.trainPairs = v; }},
+        {"colors", {1, 2, 3, 5, 7, 9}, [](SyntheticTaskSpec& s, int v) { s.colors = v; }},
+        {"components", {1, 2, 4, 8, 12, 16}, [](SyntheticTaskSpec& s, int v) { s.components = v; }},
+    };
+}
+
+SweepPoint runPoint(const Sweep& sweep, int value, const SyntheticTaskSpec& base, int samples,
+                    const arc::bench::SyntheticTaskGenerator& generator, const SolverConfig& config) {
+    SweepPoint point;
+    point.dimension = sweep.dimension;
+    point.value = value;
+
+    ARCSolver solver(config);
+    for (int s = 0; s < samples; ++s) {
+        SyntheticTaskSpec spec = base;
+        sweep.apply(spec, value);
+        spec.seed = base.seed + static_cast<std::uint64_t>(s);
+
+        arc::bench::SyntheticTask synthetic;
+        try {
+            synthetic = generator.generate(spec);
+        } catch (const std::exception&) {
+            continue;
+        }
+
+        SolveResult result = solver.solve(synthetic.task);
+        point.tasks++;
+        point.correct += result.verdict == SolveResult::Verdict::Correct;
+        point.times.sizePrediction += result.stageTimes.sizePrediction;
+        point.times.dagBuild += result.stageTimes.dagBuild;
+        point.times.pieceExtraction += result.stageTimes.pieceExtraction;
+        point.times.composition += result.stageTimes.composition;
+        point.times.evaluation += result.stageTimes.evaluation;
+        point.total += result.solvingTime;
+        point.pieces += result.totalPieces;
+        point.candidates += result.totalCandidates;
+    }
+
+    if (point.tasks > 0) {
+        const double n = point.tasks;
+        point.times.sizePrediction /= n;
+        point.times.dagBuild /= n;
+        point.times.pieceExtraction /= n;
+        point.times.composition /= n;
+        point.times.evaluation /= n;
+        point.total /= n;
+        point.pieces /= n;
+        point.candidates /= n;
+    }
+    return point;
+}
+
+void writeCsvRow(std::ostream& out, const SweepPoint& p) {
+    out << p.dimension << ',' << p.value << ',' << p.tasks << ',' << p.correct << ','
+        << p.times.sizePrediction << ',' << p.times.dagBuild << ',' << p.times.pieceExtraction << ','
+        << p.times.composition << ',' << p.times.evaluation << ',' << p.total << ','
+        << p.pieces << ',' << p.candidates << '\n';
+}
+
+void printUsage(const char* programName) {
+    std::cout << "用法: " << programName << " [选项]" << std::endl;
+    std::cout << "  --dimension NAME   只扫描size/pairs/colors/components之一 (默认: 全部)" << std::endl;
+    std::cout << "  --samples N        每个取值的任务数 (默认: 5)" << std::endl;
+    std::cout << "  --seed S           起始随机种子 (默认: 1)" << std::endl;
+    std::cout << "  --program-length N 变换程序长度 (默认: 2)" << std::endl;
+    std::cout << "  --budget SEC       每个任务的时间预算" << std::endl;
+    std::cout << "  --csv FILE         写出CSV曲线数据" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string onlyDimension;
+    std::string csvPath;
+    int samples = 5;
+    SyntheticTaskSpec base;
+    SolverConfig config;
+    config.scoringThreads = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--dimension" && i + 1 < argc) {
+            onlyDimension = argv[++i];
+        } else if (arg == "--samples" && i + 1 < argc) {
+            samples = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            base.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--program-length" && i + 1 < argc) {
+            base.programLength = std::atoi(argv[++i]);
+        } else if (arg == "--budget" && i + 1 < argc) {
+            config.timeBudget = std::atof(argv[++i]);
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    arc::bench::SyntheticTaskGenerator generator;
+    std::ofstream csv;
+    if (!csvPath.empty()) {
+        csv.open(csvPath, std::ios::trunc);
+        if (!csv.is_open()) {
+            std::cerr << "无法写入 " << csvPath << std::endl;
+            return 1;
+        }
+    }
+
+    const char* header = "dimension,value,tasks,correct,size_prediction,dag_build,piece_extraction,"
+                         "composition,evaluation,total,pieces,candidates\n";
+    std::cout << header;
+    if (csv.is_open()) csv << header;
+
+    for (const Sweep& sweep : defaultSweeps()) {
+        if (!onlyDimension.empty() && sweep.dimension != onlyDimension) continue;
+        for (int value : sweep.values) {
+            SweepPoint point = runPoint(sweep, value, base, samples, generator, config);
+            writeCsvRow(std::cout, point);
+            if (csv.is_open()) writeCsvRow(csv, point);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "bench/synthetic.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace arc::bench {
+
+SyntheticTaskGenerator::SyntheticTaskGenerator(const Config& config) : config_(config) {
+    arc::transform::initializeTransformFunctions();
+    // 注册顺序固定，函数表即确定
+    functions_ = arc::transform::TransformLibrary::instance().getListedFunctions();
+}
+
+arc::core::Grid SyntheticTaskGenerator::randomInput(const SyntheticTaskSpec& spec, std::mt19937_64& rng) {
+    arc::core::Grid grid(spec.width, spec.height);
+    const int colors = std::clamp(spec.colors, 1, 9);
+    std::uniform_int_distribution<int> colorDist(1, colors);
+
+    for (int c = 0; c < spec.components; ++c) {
+        // 块边长不超过网格的三分之一，块多时允许重叠
+        int maxW = std::max(1, spec.width / 3);
+        int maxH = std::max(1, spec.height / 3);
+        int w = std::uniform_int_distribution<int>(1, maxW)(rng);
+        int h = std::uniform_int_distribution<int>(1, maxH)(rng);
+        int x = std::uniform_int_distribution<int>(0, spec.width - w)(rng);
+        int y = std::uniform_int_distribution<int>(0, spec.height - h)(rng);
+        std::uint8_t color = static_cast<std::uint8_t>(colorDist(rng));
+        for (int r = y; r < y + h; ++r) {
+            for (int col = x; col < x + w; ++col) {
+                grid(r, col) = color;
+            }
+        }
+    }
+    return grid;
+}
+
+bool SyntheticTaskGenerator::applyProgram(
+    const std::vector<std::uint16_t>& program,
+    const arc::core::Grid& input,
+    arc::core::Grid& output
+) const {
+    const auto& lib = arc::transform::TransformLibrary::instance();
+    arc::core::State state(input, 0);
+    for (std::uint16_t id : program) {
+        arc::core::State next;
+        try {
+            if (!lib.getFunction(id).func(state, next)) return false;
+        } catch (const std::exception&) {
+            return false;
+        }
+        if (next.isVector || next.images.size() != 1) return false;
+        state = std::move(next);
+    }
+
+    output = state.images[0];
+    output.x = 0;
+    output.y = 0;
+    return output.width > 0 && output.height > 0 &&
+           output.width <= config_.maxOutputSide && output.height <= config_.maxOutputSide;
+}
+
+SyntheticTask SyntheticTaskGenerator::generate(const SyntheticTaskSpec& spec) const {
+    if (spec.width <= 0 || spec.height <= 0 || spec.trainPairs <= 0 || functions_.empty()) {
+        throw std::invalid_argument("无效的合成任务参数");
+    }
+
+    std::mt19937_64 rng(spec.seed);
+    std::vector<arc::core::Grid> inputs;
+    for (int i = 0; i <= spec.trainPairs; ++i) {
+        inputs.push_back(randomInput(spec, rng));
+    }
+
+    std::uniform_int_distribution<std::size_t> functionDist(0, functions_.size() - 1);
+    for (int attempt = 0; attempt < config_.maxProgramAttempts; ++attempt) {
+        std::vector<std::uint16_t> program;
+        for (int k = 0; k < std::max(1, spec.programLength); ++k) {
+            program.push_back(functions_[functionDist(rng)]);
+        }
+
+        // 程序必须在所有输入上有效，且至少改变一个输入，否则任务退化为恒等
+        std::vector<arc::core::Grid> outputs(inputs.size());
+        bool valid = true;
+        bool changes = false;
+        for (std::size_t i = 0; i < inputs.size() && valid; ++i) {
+            valid = applyProgram(program, inputs[i], outputs[i]);
+            changes = changes || (valid && outputs[i] != inputs[i]);
+        }
+        if (!valid || !changes) continue;
+
+        SyntheticTask result;
+        const auto& lib = arc::transform::TransformLibrary::instance();
+        for (std::uint16_t id : program) {
+            result.program.push_back(lib.getFunction(id).name);
+        }
+
+        arc::solver::ARCTask& task = result.task;
+        task.taskId = "synthetic_" + std::to_string(spec.width) + "x" + std::to_string(spec.height) +
+                      "_p" + std::to_string(spec.trainPairs) + "_c" + std::to_string(spec.colors) +
+                      "_k" + std::to_string(spec.components) + "_s" + std::to_string(spec.seed);
+        for (int i = 0; i < spec.trainPairs; ++i) {
+            task.trainingExamples.emplace_back(inputs[i], outputs[i]);
+        }
+        task.testInput = inputs.back();
+        task.testOutput = outputs.back();
+        return result;
+    }
+
+    throw std::runtime_error("无法为合成任务找到有效的变换程序");
+}
+
+} // namespace arc::bench
@@ -1,5 +1,7 @@
 #include "candidate/candidate.hpp"
 #include "transform/transform.hpp"
+#include "core/log.hpp"
+#include "core/trace.hpp"
 #include <algorithm>
 #include <iostream>
 #include <chrono>
@@ -86,6 +88,20 @@ std::uint64_t CompactBitset::hash() const {
 // GreedyComposer 实现
 // ============================================================================
 
+namespace {
+
+// 将组合工作集展开为候选解使用的普通图像
+std::vector<arc::core::Grid> unpackImages(const std::vector<arc::core::PackedGrid>& images) {
+    std::vector<arc::core::Grid> result;
+    result.reserve(images.size());
+    for (const auto& image : images) {
+        result.push_back(image.unpack());
+    }
+    return result;
+}
+
+} // namespace
+
 GreedyComposer::GreedyComposer(const Config& config) : config_(config) {}
 
 // 对应icecuber的popcount64d
@@ -151,10 +167,12 @@ std::uint64_t GreedyComposer::hashImage(const arc::core::Grid& image) const {
 }
 
 // 预处理pieces数据 - 对应icecuber的复杂内存预处理
+// piece图像先压缩为4位写入pieceTable，active/bad位图由4位比较内核直接生成
 void GreedyComposer::preprocessPieces(
     const arc::piece::PieceCollection& pieces,
     const std::vector<arc::core::Grid>& targets,
-    const std::vector<arc::core::Grid>& initialImages,
+    const std::vector<arc::core::PackedGrid>& initialImages,
+    PackedPieceTable& pieceTable,
     std::vector<std::uint64_t>& activeMem,
     std::vector<std::uint64_t>& badMem,
     std::vector<std::size_t>& activeIndices,
@@ -164,76 +182,91 @@ void GreedyComposer::preprocessPieces(
 ) {
     std::size_t numPieces = pieces.getPieceCount();
     std::size_t numDAGs = pieces.getDAGCount();
+    ARC_TRACE_SPAN(span, "preprocess_pieces");
+    ARC_TRACE_COUNTER(span, "pieces", numPieces);
     
-    // 计算图像尺寸
+    // 计算图像尺寸，目标图像只压缩一次
     imageSizes.clear();
+    std::vector<arc::core::PackedGrid> packedTargets;
     std::size_t totalSize = 0;
     for (std::size_t dagIdx = 0; dagIdx < numDAGs; ++dagIdx) {
-        const auto& img = (dagIdx < targets.size()) ? targets[dagIdx] : initialImages[dagIdx];
-        std::size_t imageSize = img.width * img.height;
+        if (dagIdx < targets.size()) {
+            packedTargets.emplace_back(targets[dagIdx]);
+        } else {
+            packedTargets.push_back(initialImages[dagIdx]);
+        }
+        std::size_t imageSize = packedTargets.back().size();
         imageSizes.push_back(imageSize);
         totalSize += imageSize;
     }
     
     const std::size_t blocksPerBitset = (totalSize + 63) / 64;
     
+    // piece图像表布局
+    pieceTable.imageOffsets.clear();
+    pieceTable.rowBytes = 0;
+    std::size_t maxImageSize = 0;
+    for (std::size_t imageSize : imageSizes) {
+        pieceTable.imageOffsets.push_back(pieceTable.rowBytes);
+        pieceTable.rowBytes += arc::core::packedBytes(imageSize);
+        maxImageSize = std::max(maxImageSize, imageSize);
+    }
+    const std::uint8_t unfilledByte = arc::core::UNFILLED_PIXEL | arc::core::UNFILLED_PIXEL << 4;
+    pieceTable.data.assign(numPieces * pieceTable.rowBytes, unfilledByte);
+    
     // 为每个piece预处理数据
-    activeMem.reserve(numPieces * blocksPerBitset);
-    badMem.reserve(numPieces * blocksPerBitset);
+    activeMem.assign(numPieces * blocksPerBitset, 0);
+    badMem.assign(numPieces * blocksPerBitset, 0);
     activeIndices.reserve(numPieces);
     badIndices.reserve(numPieces);
     imageIndices.reserve(numPieces);
     
+    std::vector<std::uint64_t> scratchBits((maxImageSize + 63) / 64);
+    std::vector<std::uint8_t> paddedPixels;
+    
     for (std::size_t pieceIdx = 0; pieceIdx < numPieces; ++pieceIdx) {
-        CompactBitset activeBitset(totalSize);
-        CompactBitset badBitset(totalSize);
+        std::uint64_t* activeRow = &activeMem[pieceIdx * blocksPerBitset];
+        std::uint64_t* badRow = &badMem[pieceIdx * blocksPerBitset];
         
         std::size_t globalIndex = 0;
         
         for (std::size_t dagIdx = 0; dagIdx < numDAGs; ++dagIdx) {
+            std::size_t imageSize = imageSizes[dagIdx];
+            std::uint8_t* packedPiece = pieceTable.image(pieceIdx, dagIdx);
+            
             try {
                 const arc::core::Grid& pieceImage = pieces.getPieceImage(pieceIdx, dagIdx);
-                const arc::core::Grid& targetImage = (dagIdx < targets.size()) ? 
-                    targets[dagIdx] : initialImages[dagIdx];
-                
-                std::size_t imageSize = imageSizes[dagIdx];
                 
                 // 确保图像尺寸匹配
-                if (pieceImage.width * pieceImage.height == imageSize &&
-                    targetImage.width * targetImage.height == imageSize) {
+                if (pieceImage.pixels.size() == imageSize) {
+                    arc::core::packNibbles(pieceImage.pixels.data(), imageSize, packedPiece);
                     
-                    for (std::size_t pixelIdx = 0; pixelIdx < imageSize; ++pixelIdx) {
-                        std::uint8_t piecePixel = pieceImage.pixels[pixelIdx];
-                        std::uint8_t targetPixel = targetImage.pixels[pixelIdx];
-                        
-                        // active: piece中的非零像素
-                        activeBitset.set(globalIndex, piecePixel != 0);
-                        
-                        // bad: piece与target不匹配的像素
-                        badBitset.set(globalIndex, piecePixel != targetPixel);
-                        
-                        globalIndex++;
-                    }
+                    // active: piece中的非零像素
+                    arc::core::nibbleNonZeroMask(packedPiece, imageSize, scratchBits.data());
+                    arc::core::orBitsAt(activeRow, globalIndex, scratchBits.data(), imageSize);
+                    
+                    // bad: piece与target不匹配的像素
+                    arc::core::nibbleNotEqualMask(packedPiece, packedTargets[dagIdx].nibbles.data(),
+                                                  imageSize, scratchBits.data());
+                    arc::core::orBitsAt(badRow, globalIndex, scratchBits.data(), imageSize);
                 } else {
-                    // 尺寸不匹配，跳过这些像素
-                    globalIndex += imageSize;
+                    // 尺寸不匹配，不产生位图；图像按行优先截断，其余保持未填充
+                    paddedPixels.assign(imageSize, arc::core::UNFILLED_PIXEL);
+                    std::copy_n(pieceImage.pixels.begin(), std::min(imageSize, pieceImage.pixels.size()),
+                                paddedPixels.begin());
+                    arc::core::packNibbles(paddedPixels.data(), imageSize, packedPiece);
                 }
             } catch (const std::exception&) {
-                // 如果无法获取piece图像，跳过
-                globalIndex += imageSizes[dagIdx];
+                // 如果无法获取piece图像，保持未填充
             }
+            
+            globalIndex += imageSize;
         }
         
         // 存储预处理的数据
         imageIndices.push_back(pieceIdx);
-        
-        activeIndices.push_back(activeMem.size());
-        const auto& activeData = activeBitset.getData();
-        activeMem.insert(activeMem.end(), activeData.begin(), activeData.end());
-        
-        badIndices.push_back(badMem.size());
-        const auto& badData = badBitset.getData();
-        badMem.insert(badMem.end(), badData.begin(), badData.end());
+        activeIndices.push_back(pieceIdx * blocksPerBitset);
+        badIndices.push_back(pieceIdx * blocksPerBitset);
     }
 }
 
@@ -242,8 +275,9 @@ int GreedyComposer::greedyComposeCore(
     CompactBitset& current,
     const CompactBitset& careMask,
     int pieceDepthThreshold,
-    std::vector<arc::core::Grid>& result,
+    std::vector<arc::core::PackedGrid>& result,
     const arc::piece::PieceCollection& pieces,
+    const PackedPieceTable& pieceTable,
     const std::vector<std::size_t>& imageSizes,
     const std::vector<std::uint64_t>& activeMem,
     const std::vector<std::uint64_t>& badMem,
@@ -336,30 +370,26 @@ int GreedyComposer::greedyComposeCore(
     if (selectedPieceIdx < pieces.getPieceCount()) {
         depth = pieces.pieces[selectedPieceIdx].depth;
         
-        // 更新结果图像
+        // 更新结果图像 - 直接从压缩piece图像表读取像素
         std::size_t globalBitIndex = 0;
         for (std::size_t dagIdx = 0; dagIdx < result.size(); ++dagIdx) {
-            try {
-                const arc::core::Grid& pieceImage = pieces.getPieceImage(selectedPieceIdx, dagIdx);
-                std::size_t imageSize = imageSizes[dagIdx];
+            std::size_t imageSize = imageSizes[dagIdx];
+            arc::core::PackedGrid& image = result[dagIdx];
+            
+            for (std::size_t pixelIdx = 0; pixelIdx < imageSize && pixelIdx < image.size(); ++pixelIdx) {
+                std::size_t blockIdx = globalBitIndex / 64;
+                std::size_t bitIdx = globalBitIndex % 64;
                 
-                for (std::size_t pixelIdx = 0; pixelIdx < imageSize && pixelIdx < pieceImage.pixels.size(); ++pixelIdx) {
-                    std::size_t blockIdx = globalBitIndex / 64;
-                    std::size_t bitIdx = globalBitIndex % 64;
-                    
-                    if (blockIdx < bestActive.size() && 
-                        (bestActive[blockIdx] >> bitIdx & 1) && 
-                        result[dagIdx].pixels[pixelIdx] == 10) { // 未填充的像素
-                        
-                        result[dagIdx].pixels[pixelIdx] = pieceImage.pixels[pixelIdx];
-                    }
+                if (blockIdx < bestActive.size() && 
+                    (bestActive[blockIdx] >> bitIdx & 1) && 
+                    image.get(pixelIdx) == arc::core::UNFILLED_PIXEL) { // 未填充的像素
                     
-                    globalBitIndex++;
+                    image.set(pixelIdx, pieceTable.pixel(selectedPieceIdx, dagIdx, pixelIdx));
                 }
-            } catch (const std::exception&) {
-                // 如果无法应用piece，跳过
-                globalBitIndex += imageSizes[dagIdx];
+                
+                globalBitIndex++;
             }
+            globalBitIndex += imageSize - std::min(imageSize, image.size());
         }
     }
     
@@ -386,28 +416,27 @@ std::vector<Candidate> GreedyComposer::compose(
         return {};
     }
     
+    ARC_TRACE_SPAN(span, "compose");
     std::vector<Candidate> results;
     
-    // 创建初始图像
-    std::vector<arc::core::Grid> initialImages;
+    // 创建初始图像 - 组合过程中以4位压缩格式存储
+    std::vector<arc::core::PackedGrid> initialImages;
     std::vector<std::size_t> imageSizes;
     
     for (std::size_t i = 0; i < pieces.getDAGCount(); ++i) {
         arc::core::Point size = (i < outputSizes.size()) ? outputSizes[i] : arc::core::Point{10, 10};
-        arc::core::Grid initialImg(size.x, size.y);
         
         // 填充为未定义值（用10表示）
-        std::fill(initialImg.pixels.begin(), initialImg.pixels.end(), 10);
-        
-        initialImages.push_back(initialImg);
+        initialImages.emplace_back(size.x, size.y, arc::core::UNFILLED_PIXEL);
         imageSizes.push_back(size.x * size.y);
     }
     
     // 预处理pieces数据
+    PackedPieceTable pieceTable;
     std::vector<std::uint64_t> activeMem, badMem;
     std::vector<std::size_t> activeIndices, badIndices, imageIndices;
     
-    preprocessPieces(pieces, targets, initialImages, activeMem, badMem,
+    preprocessPieces(pieces, targets, initialImages, pieceTable, activeMem, badMem,
                     activeIndices, badIndices, imageIndices, imageSizes);
     
     // 计算总的位数
@@ -422,102 +451,115 @@ std::vector<Candidate> GreedyComposer::compose(
         maxPieceDepth = std::max(maxPieceDepth, static_cast<int>(piece.depth));
     }
     
+    // 训练子集调度 - 对应icecuber的mask枚举，训练对较多时代价为线性
+    MaskScheduler::Config scheduleConfig;
+    scheduleConfig.strategy = config_.maskStrategy;
+    scheduleConfig.exhaustiveLimit = config_.exhaustiveMaskLimit;
+    scheduleConfig.maxSubsetSize = config_.maxMaskSubsetSize;
+    const std::vector<MaskJob> maskJobs = MaskScheduler(scheduleConfig).schedule(targets);
+    
     // 多种策略组合
     for (int pieceDepthThreshold = maxPieceDepth % 10; 
          pieceDepthThreshold <= maxPieceDepth; 
          pieceDepthThreshold += 10) {
+        ARC_TRACE_SPAN(roundSpan, "compose_round");
+        ARC_TRACE_COUNTER(roundSpan, "depth_threshold", pieceDepthThreshold);
+        ARC_TRACE_COUNTER(roundSpan, "mask_jobs", maskJobs.size());
         
-        for (int iteration = 0; iteration < 10; ++iteration) {
-            for (int mask = 1; mask < std::min(1 << targets.size(), 1 << 5); ++mask) {
-                std::vector<int> maskVector;
-                for (std::size_t j = 0; j < targets.size(); ++j) {
-                    if (mask >> j & 1) {
-                        maskVector.push_back(static_cast<int>(j));
+        for (const MaskJob& job : maskJobs) {
+            // 任务预算用尽时保留已生成的候选解
+            if (config_.deadline.expired()) {
+                goto composition_complete;
+            }
+            
+            std::vector<bool> inMask(imageSizes.size(), false);
+            for (int member : job.members) {
+                inMask[member] = true;
+            }
+            
+            // 初始化位集合
+            CompactBitset current(totalBits);
+            CompactBitset careMaskBitset(totalBits);
+            
+            // 设置关心的区域
+            std::size_t baseBit = 0;
+            for (std::size_t j = 0; j < imageSizes.size(); ++j) {
+                if (!inMask[j]) {
+                    // 不关心的区域标记为已填充
+                    for (std::size_t k = 0; k < imageSizes[j]; ++k) {
+                        current.set(baseBit + k, true);
                     }
                 }
-                
-                if (iteration >= maskVector.size()) {
-                    continue;
+                if (static_cast<int>(j) == job.careIndex) {
+                    // 关心的区域
+                    for (std::size_t k = 0; k < imageSizes[j]; ++k) {
+                        careMaskBitset.set(baseBit + k, true);
+                    }
                 }
+                baseBit += imageSizes[j];
+            }
+            
+            // 贪心组合
+            std::vector<arc::core::PackedGrid> candidateResult = initialImages;
+            int pieceCount = 0;
+            int sumDepth = 0;
+            int maxDepth = 0;
+            
+            for (int iter = 0; iter < config_.maxIterations; ++iter) {
+                int depth = greedyComposeCore(current, careMaskBitset, pieceDepthThreshold,
+                                            candidateResult, pieces, pieceTable, imageSizes,
+                                            activeMem, badMem, activeIndices, 
+                                            badIndices, imageIndices);
                 
-                int careMask = 1 << maskVector[iteration];
+                if (depth == -1) break;
                 
-                // 初始化位集合
-                CompactBitset current(totalBits);
-                CompactBitset careMaskBitset(totalBits);
+                pieceCount++;
+                sumDepth += depth;
+                maxDepth = std::max(maxDepth, depth);
                 
-                // 设置关心的区域
-                std::size_t baseBit = 0;
-                for (std::size_t j = 0; j < imageSizes.size(); ++j) {
-                    if (!(mask >> j & 1)) {
-                        // 不关心的区域标记为已填充
-                        for (std::size_t k = 0; k < imageSizes[j]; ++k) {
-                            current.set(baseBit + k, true);
-                        }
-                    }
-                    if (careMask >> j & 1) {
-                        // 关心的区域
-                        for (std::size_t k = 0; k < imageSizes[j]; ++k) {
-                            careMaskBitset.set(baseBit + k, true);
+                // 应用贪心填充
+                if (config_.enableGreedyFill) {
+                    std::vector<arc::core::Grid> filledResult = unpackImages(candidateResult);
+                    
+                    // 填充未定义的像素并验证
+                    bool isValid = true;
+                    for (auto& img : filledResult) {
+                        img = greedyFillBlack(img);
+                        if (img.width * img.height == 0) {
+                            isValid = false;
+                            break;
                         }
                     }
-                    baseBit += imageSizes[j];
-                }
-                
-                // 贪心组合
-                std::vector<arc::core::Grid> candidateResult = initialImages;
-                int pieceCount = 0;
-                int sumDepth = 0;
-                int maxDepth = 0;
-                
-                for (int iter = 0; iter < config_.maxIterations; ++iter) {
-                    int depth = greedyComposeCore(current, careMaskBitset, pieceDepthThreshold,
-                                                candidateResult, pieces, imageSizes,
-                                                activeMem, badMem, activeIndices, 
-                                                badIndices, imageIndices);
-                    
-                    if (depth == -1) break;
                     
-                    pieceCount++;
-                    sumDepth += depth;
-                    maxDepth = std::max(maxDepth, depth);
-                    
-                    // 应用贪心填充
-                    if (config_.enableGreedyFill) {
-                        std::vector<arc::core::Grid> filledResult = candidateResult;
-                        
-                        // 填充未定义的像素并验证
-                        bool isValid = true;
-                        for (auto& img : filledResult) {
-                            img = greedyFillBlack(img);
-                            if (img.width * img.height == 0) {
-                                isValid = false;
-                                break;
-                            }
-                        }
+                    if (isValid) {
+                        results.emplace_back(filledResult, pieceCount, sumDepth, maxDepth);
+                        config_.deadline.chargeMemory(candidateBytes(results.back()));
                         
-                        if (isValid) {
-                            results.emplace_back(filledResult, pieceCount, sumDepth, maxDepth);
-                            
-                            if (results.size() >= config_.maxCandidates) {
-                                goto composition_complete;
-                            }
+                        if (results.size() >= config_.maxCandidates) {
+                            goto composition_complete;
                         }
                     }
                 }
-                
-                // 添加未完全填充的候选解
-                results.emplace_back(candidateResult, pieceCount, sumDepth, maxDepth);
-                
-                if (results.size() >= config_.maxCandidates) {
-                    goto composition_complete;
-                }
             }
+            
+            // 添加未完全填充的候选解
+            results.emplace_back(unpackImages(candidateResult), pieceCount, sumDepth, maxDepth);
+            config_.deadline.chargeMemory(candidateBytes(results.back()));
+            
+            if (results.size() >= config_.maxCandidates) {
+                goto composition_complete;
+            }
+        }
+        
+        ARC_TRACE_COUNTER(roundSpan, "candidates", results.size());
+        if (config_.onRoundComplete) {
+            config_.onRoundComplete(results);
         }
     }
     
 composition_complete:
-    std::cout << "贪心组合完成，生成了 " << results.size() << " 个候选解" << std::endl;
+    ARC_TRACE_COUNTER(span, "candidates", results.size());
+    ARC_LOG_DEBUG("贪心组合完成，生成了 " << results.size() << " 个候选解");
     return results;
 }
 
@@ -582,11 +624,18 @@ int CandidateComposer::calculateTrainingMatches(
 
 std::vector<Candidate> CandidateComposer::evaluateCandidates(
     const std::vector<Candidate>& candidates,
-    const std::vector<std::pair<arc::core::Grid, arc::core::Grid>>& trainingPairs
+    const std::vector<std::pair<arc::core::Grid, arc::core::Grid>>& trainingPairs,
+    const arc::core::Deadline& deadline
 ) {
+    ARC_TRACE_SPAN(span, "evaluate_candidates");
+    ARC_TRACE_COUNTER(span, "candidates", candidates.size());
     std::vector<Candidate> evaluatedCandidates;
     
     for (const Candidate& candidate : candidates) {
+        if (!evaluatedCandidates.empty() && deadline.expired()) {
+            break;
+        }
+        
         if (candidate.maxDepth < 0 || candidate.pieceCount < 0) {
             continue; // 跳过无效的候选解
         }
@@ -617,6 +666,7 @@ std::vector<Candidate> CandidateComposer::evaluateCandidates(
     
     // 按分数排序 - 对应icecuber的sort
     std::sort(evaluatedCandidates.begin(), evaluatedCandidates.end());
+    ARC_TRACE_COUNTER(span, "evaluated", evaluatedCandidates.size());
     
     return evaluatedCandidates;
 }
@@ -740,6 +790,14 @@ std::vector<Candidate> AdvancedCandidateGenerator::fuseCandidates(
 // 辅助函数实现
 // ============================================================================
 
+std::size_t candidateBytes(const Candidate& candidate) {
+    std::size_t bytes = sizeof(Candidate);
+    for (const auto& image : candidate.images) {
+        bytes += sizeof(arc::core::Grid) + image.pixels.size();
+    }
+    return bytes;
+}
+
 std::vector<Candidate> createTestCandidates(const std::vector<arc::core::Grid>& images) {
     std::vector<Candidate> candidates;
     
@@ -0,0 +1,218 @@
+#include "candidate/mask_scheduler.hpp"
+#include "core/log.hpp"
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+namespace arc::candidate {
+
+// ============================================================================
+// MaskScheduler 实现
+// ============================================================================
+
+namespace {
+
+// 目标图像的信息量（比特）：面积 * 颜色分布熵
+double informationBits(const arc::core::Grid& target) {
+    int counts[16] = {0};
+    for (std::uint8_t pixel : target.pixels) {
+        counts[pixel & 15]++;
+    }
+
+    const double total = static_cast<double>(target.pixels.size());
+    if (total == 0.0) return 0.0;
+
+    double entropy = 0.0;
+    for (int c : counts) {
+        if (c > 0) {
+            double p = c / total;
+            entropy -= p * std::log2(p);
+        }
+    }
+    return entropy * total;
+}
+
+int colorMask(const arc::core::Grid& target) {
+    int mask = 0;
+    for (std::uint8_t pixel : target.pixels) {
+        if (pixel < 10) mask |= 1 << pixel;
+    }
+    return mask;
+}
+
+} // namespace
+
+MaskScheduler::MaskScheduler(const Config& config) : config_(config) {}
+
+std::vector<int> MaskScheduler::orderByInformationGain(const std::vector<arc::core::Grid>& targets) {
+    const int count = static_cast<int>(targets.size());
+
+    std::vector<double> bits(count);
+    std::vector<int> masks(count);
+    for (int i = 0; i < count; ++i) {
+        bits[i] = informationBits(targets[i]);
+        masks[i] = colorMask(targets[i]);
+    }
+
+    auto gainOf = [&](int i, int coveredColors) {
+        int newColors = __builtin_popcount(masks[i] & ~coveredColors);
+        return bits[i] + static_cast<double>(newColors) * targets[i].pixels.size();
+    };
+
+    // 贪心：每次选择边际增益最大的训练对，增益相同时选下标小的。
+    // 已覆盖的颜色只增不减，增益只会下降，因此堆中的旧增益是上界（惰性贪心）：
+    // 堆顶按当前覆盖重新计算后仍不小于下一个上界即可选中。覆盖颜色最多变化10次，
+    // 每个训练对最多重算11次，总代价O(n log n)
+    struct Entry {
+        double gain;
+        int index;
+        int coveredAt;     // 计算gain时的已覆盖颜色
+    };
+    auto before = [](const Entry& a, const Entry& b) {
+        return a.gain < b.gain || (a.gain == b.gain && a.index > b.index);
+    };
+
+    std::vector<Entry> heap;
+    heap.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        heap.push_back({gainOf(i, 0), i, 0});
+    }
+    std::make_heap(heap.begin(), heap.end(), before);
+
+    std::vector<int> order;
+    order.reserve(count);
+    int coveredColors = 0;
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), before);
+        Entry top = heap.back();
+        heap.pop_back();
+
+        if (top.coveredAt != coveredColors) {
+            top.gain = gainOf(top.index, coveredColors);
+            top.coveredAt = coveredColors;
+            if (!heap.empty() && before(top, heap.front())) {
+                heap.push_back(top);
+                std::push_heap(heap.begin(), heap.end(), before);
+                continue;
+            }
+        }
+
+        coveredColors |= masks[top.index];
+        order.push_back(top.index);
+    }
+
+    return order;
+}
+
+void MaskScheduler::appendExhaustive(int count, std::vector<MaskJob>& jobs) const {
+    // 对应icecuber的原始枚举顺序：外层为子集内的第iteration个训练对，内层为子集
+    for (int iteration = 0; iteration < count; ++iteration) {
+        for (int mask = 1; mask < (1 << count); ++mask) {
+            std::vector<int> members;
+            for (int j = 0; j < count; ++j) {
+                if (mask >> j & 1) members.push_back(j);
+            }
+            if (iteration < static_cast<int>(members.size())) {
+                jobs.push_back({members, members[iteration]});
+            }
+        }
+    }
+}
+
+void MaskScheduler::appendAllPairs(int count, std::vector<MaskJob>& jobs) const {
+    std::vector<int> members(count);
+    for (int j = 0; j < count; ++j) members[j] = j;
+
+    for (int care = 0; care < count; ++care) {
+        jobs.push_back({members, care});
+    }
+}
+
+void MaskScheduler::appendLeaveOneOut(int count, std::vector<MaskJob>& jobs) const {
+    if (count < 2) return;
+
+    // 留出第i个训练对，关心第(i+1)个，保证每个训练对恰好作一次careIndex
+    for (int left = 0; left < count; ++left) {
+        std::vector<int> members;
+        members.reserve(count - 1);
+        for (int j = 0; j < count; ++j) {
+            if (j != left) members.push_back(j);
+        }
+        jobs.push_back({std::move(members), (left + 1) % count});
+    }
+}
+
+void MaskScheduler::appendGreedyInfoGain(const std::vector<int>& order, std::vector<MaskJob>& jobs) const {
+    // 第p个训练对与排在它之前的至多maxSubsetSize-1个组成子集并作为careIndex：
+    // 前maxSubsetSize个即前缀子集{p1}, {p1,p2}, ...，之后为滑动窗口，成员总数O(n * maxSubsetSize)
+    const std::size_t window = static_cast<std::size_t>(std::max(1, config_.maxSubsetSize));
+    for (std::size_t p = 0; p < order.size(); ++p) {
+        const std::size_t first = p + 1 > window ? p + 1 - window : 0;
+        std::vector<int> members(order.begin() + first, order.begin() + p + 1);
+        std::sort(members.begin(), members.end());
+        jobs.push_back({std::move(members), order[p]});
+    }
+}
+
+void MaskScheduler::appendLinear(const std::vector<arc::core::Grid>& targets, std::vector<MaskJob>& jobs) const {
+    const auto order = orderByInformationGain(targets);
+    appendGreedyInfoGain(order, jobs);
+
+    // 全集只组合一次，关心信息量最大的训练对，保证存在与全部训练对一致的候选解
+    std::vector<int> members(targets.size());
+    for (std::size_t j = 0; j < members.size(); ++j) members[j] = static_cast<int>(j);
+    jobs.push_back({std::move(members), order.front()});
+}
+
+std::vector<MaskJob> MaskScheduler::schedule(const std::vector<arc::core::Grid>& targets) const {
+    const int count = static_cast<int>(targets.size());
+    std::vector<MaskJob> jobs;
+    if (count == 0) return jobs;
+
+    switch (config_.strategy) {
+        case MaskStrategy::Exhaustive:
+            // 指数级，仅适用于小任务；训练对过多时不截断，改用线性调度
+            if (count <= MAX_EXHAUSTIVE_PAIRS) {
+                appendExhaustive(count, jobs);
+            } else {
+                ARC_LOG_WARN("训练对数 " << count << " 超过穷举上限 " << MAX_EXHAUSTIVE_PAIRS
+                             << "，改用线性子集调度");
+                appendLinear(targets, jobs);
+            }
+            break;
+        case MaskStrategy::AllPairs:
+            appendAllPairs(count, jobs);
+            break;
+        case MaskStrategy::LeaveOneOut:
+            appendLeaveOneOut(count, jobs);
+            // 单个训练对无法留出，退化为全集
+            if (jobs.empty()) appendAllPairs(count, jobs);
+            break;
+        case MaskStrategy::GreedyInfoGain:
+            appendGreedyInfoGain(orderByInformationGain(targets), jobs);
+            break;
+        case MaskStrategy::Auto:
+        default:
+            if (count <= std::min(config_.exhaustiveLimit, MAX_EXHAUSTIVE_PAIRS)) {
+                appendExhaustive(count, jobs);
+            } else {
+                appendLinear(targets, jobs);
+            }
+            break;
+    }
+
+    // 去重（不同策略可能生成相同的任务），保持首次出现的顺序
+    std::set<std::pair<std::vector<int>, int>> seen;
+    std::vector<MaskJob> unique;
+    unique.reserve(jobs.size());
+    for (auto& job : jobs) {
+        if (seen.insert({job.members, job.careIndex}).second) {
+            unique.push_back(std::move(job));
+        }
+    }
+
+    return unique;
+}
+
+} // namespace arc::candidate
@@ -0,0 +1,83 @@
+// 替换全局operator new/delete以统计分配，只在CLI和benchmark构建中以ARC_ALLOC_ACCOUNTING编译链接。
+// 字节数取malloc_usable_size，分配和释放两侧一致，不依赖sized delete
+#include "core/alloc_stats.hpp"
+
+#if defined(ARC_ALLOC_ACCOUNTING)
+
+#include <algorithm>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+namespace {
+
+const bool hooksInstalled = (arc::core::markAllocHooksInstalled(), true);
+
+void* allocate(std::size_t size) noexcept {
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr) {
+        arc::core::recordAllocation(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) noexcept {
+    void* ptr = nullptr;
+    std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    if (posix_memalign(&ptr, align, size == 0 ? 1 : size) != 0) {
+        return nullptr;
+    }
+    arc::core::recordAllocation(malloc_usable_size(ptr));
+    return ptr;
+}
+
+void release(void* ptr) noexcept {
+    if (ptr) {
+        arc::core::recordFree(malloc_usable_size(ptr));
+        std::free(ptr);
+    }
+}
+
+void* allocateOrThrow(std::size_t size) {
+    for (;;) {
+        if (void* ptr = allocate(size)) return ptr;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* allocateAlignedOrThrow(std::size_t size, std::align_val_t alignment) {
+    for (;;) {
+        if (void* ptr = allocateAligned(size, alignment)) return ptr;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t al) { return allocateAlignedOrThrow(size, al); }
+void* operator new[](std::size_t size, std::align_val_t al) { return allocateAlignedOrThrow(size, al); }
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return allocateAligned(size, al); }
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return allocateAligned(size, al); }
+
+void operator delete(void* ptr) noexcept { release(ptr); }
+void operator delete[](void* ptr) noexcept { release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { release(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { release(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { release(ptr); }
+
+#endif
@@ -0,0 +1,105 @@
+#include "core/alloc_stats.hpp"
+#include <algorithm>
+#include <atomic>
+
+namespace arc::core {
+
+namespace {
+
+// 只含平凡成员，线程局部变量常量初始化，在operator new中访问不会再分配
+struct ThreadAllocState {
+    AllocCounters stages[SOLVE_STAGE_COUNT];
+    std::int64_t liveBytes;
+    std::int64_t peakBytes;
+    int stage;
+};
+
+thread_local ThreadAllocState threadState{};
+std::atomic<bool> hooksInstalled{false};
+
+} // namespace
+
+AllocCounters& AllocCounters::operator+=(const AllocCounters& other) {
+    allocations += other.allocations;
+    frees += other.frees;
+    bytesAllocated += other.bytesAllocated;
+    bytesFreed += other.bytesFreed;
+    return *this;
+}
+
+AllocCounters AllocCounters::operator-(const AllocCounters& other) const {
+    AllocCounters result;
+    result.allocations = allocations - other.allocations;
+    result.frees = frees - other.frees;
+    result.bytesAllocated = bytesAllocated - other.bytesAllocated;
+    result.bytesFreed = bytesFreed - other.bytesFreed;
+    return result;
+}
+
+AllocCounters AllocSnapshot::total() const {
+    AllocCounters sum;
+    for (const auto& counters : stages) {
+        sum += counters;
+    }
+    return sum;
+}
+
+bool allocAccountingEnabled() {
+    return hooksInstalled.load(std::memory_order_relaxed);
+}
+
+AllocSnapshot threadAllocSnapshot() {
+    AllocSnapshot snapshot;
+    std::copy(std::begin(threadState.stages), std::end(threadState.stages), snapshot.stages.begin());
+    snapshot.liveBytes = threadState.liveBytes;
+    snapshot.peakBytes = threadState.peakBytes;
+    return snapshot;
+}
+
+void markAllocHooksInstalled() noexcept {
+    hooksInstalled.store(true, std::memory_order_relaxed);
+}
+
+void recordAllocation(std::size_t bytes) noexcept {
+    AllocCounters& counters = threadState.stages[threadState.stage];
+    ++counters.allocations;
+    counters.bytesAllocated += bytes;
+    threadState.liveBytes += static_cast<std::int64_t>(bytes);
+    threadState.peakBytes = std::max(threadState.peakBytes, threadState.liveBytes);
+}
+
+void recordFree(std::size_t bytes) noexcept {
+    AllocCounters& counters = threadState.stages[threadState.stage];
+    ++counters.frees;
+    counters.bytesFreed += bytes;
+    threadState.liveBytes -= static_cast<std::int64_t>(bytes);
+}
+
+// ============================================================================
+// 作用域
+// ============================================================================
+
+SolveStage enterAllocStage(SolveStage stage) noexcept {
+    SolveStage previous = static_cast<SolveStage>(threadState.stage);
+    threadState.stage = static_cast<int>(stage);
+    return previous;
+}
+
+AllocTaskScope::AllocTaskScope() noexcept {
+    threadState.peakBytes = threadState.liveBytes;
+    baseline_ = threadAllocSnapshot();
+}
+
+std::array<AllocCounters, SOLVE_STAGE_COUNT> AllocTaskScope::stageDelta() const {
+    std::array<AllocCounters, SOLVE_STAGE_COUNT> delta;
+    for (std::size_t i = 0; i < SOLVE_STAGE_COUNT; ++i) {
+        delta[i] = threadState.stages[i] - baseline_.stages[i];
+    }
+    return delta;
+}
+
+std::int64_t AllocTaskScope::peakBytes() const {
+    return std::max<std::int64_t>(0, threadState.peakBytes - baseline_.liveBytes);
+}
+
+} // namespace arc::core
@@ -1,4 +1,6 @@
 #include "core/dag.hpp"
+#include "core/stage.hpp"
+#include "core/trace.hpp"
 #include <algorithm>
 #include <stdexcept>
 #include <chrono>
@@ -246,6 +248,7 @@ NodeID DAG::addNode(const State& state, bool force) {
     // 创建新节点
     NodeID nodeId = static_cast<NodeID>(nodes_.size());
     nodes_.push_back(std::make_unique<Node>(state));
+    config_.deadline.chargeMemory(sizeof(Node) + state.totalPixels());
     
     return nodeId;
 }
@@ -267,6 +270,7 @@ std::vector<NodeID> DAG::expandNode(NodeID nodeId) {
     
     const Node& parentNode = *nodes_[nodeId];
     if (parentNode.state.depth >= config_.maxDepth) {
+        frontier_.push_back(nodeId);
         return {};
     }
     
@@ -274,9 +278,12 @@ std::vector<NodeID> DAG::expandNode(NodeID nodeId) {
     newNodes.reserve(functions_.getListedCount());
     
     // 对每个已注册的函数尝试变换
+    // 只返回新建的节点：已有节点（去重命中或子节点映射命中）在创建时已入队，
+    // 重复入队会重新遍历它的整棵子树，加深时从边界重新扩展也依赖这一点
     for (std::uint16_t funcId : functions_.getListedFunctions()) {
+        const std::size_t before = nodes_.size();
         NodeID childId = applyFunction(nodeId, funcId);
-        if (childId != INVALID_NODE) {
+        if (childId != INVALID_NODE && childId >= before) {
             newNodes.push_back(childId);
         }
     }
@@ -307,6 +314,14 @@ NodeID DAG::applyFunction(NodeID nodeId, std::uint16_t funcId) {
         return INVALID_NODE;
     }
     
+    // 代价大于1的函数可能越过深度上限，父节点留在边界上，加深后重试
+    if (newState.depth > config_.maxDepth) {
+        if (frontier_.empty() || frontier_.back() != nodeId) {
+            frontier_.push_back(nodeId);
+        }
+        return INVALID_NODE;
+    }
+    
     // 创建新节点
     NodeID childId = addNode(newState);
     if (childId != INVALID_NODE) {
@@ -320,8 +335,6 @@ NodeID DAG::applyFunction(NodeID nodeId, std::uint16_t funcId) {
 }
 
 void DAG::buildDAG() {
-    auto startTime = std::chrono::high_resolution_clock::now();
-    
     std::vector<NodeID> currentLevel;
     
     // 收集当前所有根节点
@@ -329,20 +342,58 @@ void DAG::buildDAG() {
         currentLevel.push_back(static_cast<NodeID>(i));
     }
     
+    frontier_.clear();
+    buildTime_ = 0.0;
+    expandLevels(std::move(currentLevel));
+}
+
+bool DAG::extendDepth(std::size_t newMaxDepth) {
+    if (newMaxDepth <= config_.maxDepth && frontier_.empty()) {
+        return false;
+    }
+    config_.maxDepth = std::max(config_.maxDepth, newMaxDepth);
+    
+    // 边界节点可能重复记录（深度截断和预算截断各一次），子节点映射会让重复扩展直接命中缓存
+    std::vector<NodeID> currentLevel;
+    currentLevel.swap(frontier_);
+    std::sort(currentLevel.begin(), currentLevel.end());
+    currentLevel.erase(std::unique(currentLevel.begin(), currentLevel.end()), currentLevel.end());
+    
+    const std::size_t before = nodes_.size();
+    expandLevels(std::move(currentLevel));
+    return nodes_.size() > before;
+}
+
+void DAG::expandLevels(std::vector<NodeID> currentLevel) {
+    ARC_STAGE_SPAN(span, "build_dag", SolveStage::DAGBuild);
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
     // 层次化构建DAG
-    while (!currentLevel.empty() && nodes_.size() < config_.maxNodes) {
+    bool outOfBudget = false;
+    while (!currentLevel.empty() && nodes_.size() < config_.maxNodes && !outOfBudget) {
         std::vector<NodeID> nextLevel;
         
-        for (NodeID nodeId : currentLevel) {
-            auto newNodes = expandNode(nodeId);
+        std::size_t expanded = 0;
+        for (; expanded < currentLevel.size(); ++expanded) {
+            auto newNodes = expandNode(currentLevel[expanded]);
             nextLevel.insert(nextLevel.end(), newNodes.begin(), newNodes.end());
             
             // 检查节点数限制
             if (nodes_.size() >= config_.maxNodes) {
+                ++expanded;
+                break;
+            }
+            
+            // 任务预算用尽时保留已构建的节点
+            if (config_.deadline.expired()) {
+                ++expanded;
+                outOfBudget = true;
                 break;
             }
         }
         
+        // 提前停止时本层剩余节点留待下次扩展
+        frontier_.insert(frontier_.end(), currentLevel.begin() + expanded, currentLevel.end());
         currentLevel = std::move(nextLevel);
         
         // 检查时间限制
@@ -352,9 +403,11 @@ void DAG::buildDAG() {
             break;
         }
     }
+    frontier_.insert(frontier_.end(), currentLevel.begin(), currentLevel.end());
     
     auto endTime = std::chrono::high_resolution_clock::now();
-    buildTime_ = std::chrono::duration<double>(endTime - startTime).count();
+    buildTime_ += std::chrono::duration<double>(endTime - startTime).count();
+    ARC_TRACE_COUNTER(span, "nodes", nodes_.size());
 }
 
 bool DAG::isValidExpansion(const State& newState) const {
@@ -422,6 +475,7 @@ void DAG::clear() {
     nodes_.clear();
     hashMap_.clear();
     givenNodes_ = 0;
+    frontier_.clear();
     expandCalls_ = duplicateHits_ = 0;
     buildTime_ = 0.0;
 }
@@ -0,0 +1,53 @@
+#include "core/deadline.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace arc::core {
+
+Deadline::Deadline()
+    : start_(Clock::now()), end_(Clock::time_point::max()), shared_(std::make_shared<Shared>()) {}
+
+Deadline::Deadline(double seconds, std::size_t memoryLimit) : Deadline() {
+    if (seconds > 0.0) {
+        timeLimited_ = true;
+        end_ = start_ + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    }
+    shared_->memoryLimit = memoryLimit;
+}
+
+double Deadline::elapsed() const {
+    return std::chrono::duration<double>(Clock::now() - start_).count();
+}
+
+double Deadline::remaining() const {
+    if (!timeLimited_) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return std::max(0.0, std::chrono::duration<double>(end_ - Clock::now()).count());
+}
+
+bool Deadline::memoryExceeded() const {
+    return shared_->memoryLimit > 0 &&
+           shared_->memoryUsed.load(std::memory_order_relaxed) > shared_->memoryLimit;
+}
+
+void Deadline::releaseMemory(std::size_t bytes) const {
+    std::size_t used = shared_->memoryUsed.load(std::memory_order_relaxed);
+    while (!shared_->memoryUsed.compare_exchange_weak(used, used - std::min(used, bytes),
+                                                      std::memory_order_relaxed)) {
+    }
+}
+
+Deadline Deadline::stage(double share) const {
+    Deadline child = *this;
+    child.start_ = Clock::now();
+    if (timeLimited_) {
+        share = std::clamp(share, 0.0, 1.0);
+        auto slice = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(remaining() * share));
+        child.end_ = std::min(end_, child.start_ + slice);
+    }
+    return child;
+}
+
+} // namespace arc::core
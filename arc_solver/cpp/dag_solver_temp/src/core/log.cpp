@@ -0,0 +1,100 @@
+#include "core/log.hpp"
+#include <iostream>
+#include <mutex>
+#include <string>
+
+namespace arc::core {
+
+namespace detail {
+std::atomic<int> runtimeLogLevel{static_cast<int>(LogLevel::Warn)};
+}
+
+namespace {
+
+constexpr std::size_t THREAD_BUFFER_LIMIT = 4096;
+
+std::mutex& sinkMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::ostream*& sink() {
+    static std::ostream* stream = &std::cerr;
+    return stream;
+}
+
+const char* levelTag(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "[trace] ";
+        case LogLevel::Debug: return "[debug] ";
+        case LogLevel::Info: return "[info] ";
+        case LogLevel::Warn: return "[warn] ";
+        case LogLevel::Error: return "[error] ";
+        default: return "";
+    }
+}
+
+// 每线程缓冲区，线程退出时写出剩余内容
+struct ThreadLogBuffer {
+    std::string text;
+
+    void flush() {
+        if (text.empty()) return;
+        std::lock_guard<std::mutex> lock(sinkMutex());
+        sink()->write(text.data(), static_cast<std::streamsize>(text.size()));
+        sink()->flush();
+        text.clear();
+    }
+
+    ~ThreadLogBuffer() { flush(); }
+};
+
+ThreadLogBuffer& threadBuffer() {
+    thread_local ThreadLogBuffer buffer;
+    return buffer;
+}
+
+} // namespace
+
+void setLogLevel(LogLevel level) {
+    detail::runtimeLogLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel getLogLevel() {
+    return static_cast<LogLevel>(detail::runtimeLogLevel.load(std::memory_order_relaxed));
+}
+
+LogLevel parseLogLevel(const std::string& name, LogLevel fallback) {
+    if (name == "trace") return LogLevel::Trace;
+    if (name == "debug") return LogLevel::Debug;
+    if (name == "info") return LogLevel::Info;
+    if (name == "warn") return LogLevel::Warn;
+    if (name == "error") return LogLevel::Error;
+    if (name == "off") return LogLevel::Off;
+    return fallback;
+}
+
+void setLogStream(std::ostream& stream) {
+    flushLog();
+    std::lock_guard<std::mutex> lock(sinkMutex());
+    sink() = &stream;
+}
+
+void flushLog() {
+    threadBuffer().flush();
+}
+
+LogLine::LogLine(LogLevel level) : level_(level) {
+    stream_ << levelTag(level);
+}
+
+LogLine::~LogLine() {
+    ThreadLogBuffer& buffer = threadBuffer();
+    buffer.text += stream_.str();
+    buffer.text += '\n';
+    if (level_ >= LogLevel::Warn || buffer.text.size() >= THREAD_BUFFER_LIMIT) {
+        buffer.flush();
+    }
+}
+
+} // namespace arc::core
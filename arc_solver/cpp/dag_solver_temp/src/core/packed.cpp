@@ -0,0 +1,149 @@
+#include "core/packed.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ARC_PACKED_SSE2 1
+#endif
+
+namespace arc::core {
+
+// ============================================================================
+// 打包 / 解包
+// ============================================================================
+
+void packNibbles(const std::uint8_t* src, std::size_t count, std::uint8_t* dst) {
+    std::size_t i = 0;
+
+#ifdef ARC_PACKED_SSE2
+    // 32个像素 -> 16字节：每个16位通道 b0 | b1<<8 变为 b0 | b1<<4
+    const __m128i lowMask = _mm_set1_epi16(0x000F);
+    const __m128i highMask = _mm_set1_epi16(0x00F0);
+    for (; i + 32 <= count; i += 32) {
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+        __m128i p0 = _mm_or_si128(_mm_and_si128(v0, lowMask), _mm_and_si128(_mm_srli_epi16(v0, 4), highMask));
+        __m128i p1 = _mm_or_si128(_mm_and_si128(v1, lowMask), _mm_and_si128(_mm_srli_epi16(v1, 4), highMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i / 2), _mm_packus_epi16(p0, p1));
+    }
+#endif
+
+    for (; i + 1 < count; i += 2) {
+        dst[i / 2] = static_cast<std::uint8_t>((src[i] & 15) | (src[i + 1] & 15) << 4);
+    }
+    if (i < count) {
+        dst[i / 2] = static_cast<std::uint8_t>(src[i] & 15);
+    }
+}
+
+void unpackNibbles(const std::uint8_t* src, std::size_t count, std::uint8_t* dst) {
+    std::size_t i = 0;
+
+#ifdef ARC_PACKED_SSE2
+    // 16字节 -> 32个像素：分离高低4位后按字节交错
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    for (; i + 32 <= count; i += 32) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i / 2));
+        __m128i lo = _mm_and_si128(v, nibbleMask);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibbleMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(lo, hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 16), _mm_unpackhi_epi8(lo, hi));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        dst[i] = (src[i >> 1] >> ((i & 1) << 2)) & 15;
+    }
+}
+
+// ============================================================================
+// 逐像素比较内核
+// ============================================================================
+
+namespace {
+
+// 对每个字节的两个4位判断是否非零，按像素顺序写入位掩码
+template <typename ByteAt>
+void nibbleNonZeroBits(ByteAt byteAt, std::size_t count, std::uint64_t* bits) {
+    const std::size_t words = (count + 63) / 64;
+    std::memset(bits, 0, words * sizeof(std::uint64_t));
+
+    std::size_t i = 0;
+
+#ifdef ARC_PACKED_SSE2
+    // 每次处理32个像素（16字节），得到32位掩码
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 32 <= count; i += 32) {
+        __m128i v = byteAt.load(i / 2);
+        __m128i lo = _mm_cmpeq_epi8(_mm_and_si128(v, nibbleMask), zero);
+        __m128i hi = _mm_cmpeq_epi8(_mm_and_si128(_mm_srli_epi16(v, 4), nibbleMask), zero);
+        std::uint32_t zeroLo = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_unpacklo_epi8(lo, hi)));
+        std::uint32_t zeroHi = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_unpackhi_epi8(lo, hi)));
+        std::uint64_t nonZero = ~(static_cast<std::uint64_t>(zeroLo) | static_cast<std::uint64_t>(zeroHi) << 16) & 0xFFFFFFFFULL;
+        bits[i / 64] |= nonZero << (i % 64);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        std::uint8_t nibble = (byteAt.scalar(i >> 1) >> ((i & 1) << 2)) & 15;
+        if (nibble != 0) {
+            bits[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+}
+
+struct SingleSource {
+    const std::uint8_t* a;
+#ifdef ARC_PACKED_SSE2
+    __m128i load(std::size_t byte) const {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + byte));
+    }
+#endif
+    std::uint8_t scalar(std::size_t byte) const { return a[byte]; }
+};
+
+struct XorSource {
+    const std::uint8_t* a;
+    const std::uint8_t* b;
+#ifdef ARC_PACKED_SSE2
+    __m128i load(std::size_t byte) const {
+        return _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + byte)),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + byte)));
+    }
+#endif
+    std::uint8_t scalar(std::size_t byte) const { return a[byte] ^ b[byte]; }
+};
+
+} // namespace
+
+void nibbleNotEqualMask(const std::uint8_t* a, const std::uint8_t* b, std::size_t count, std::uint64_t* bits) {
+    nibbleNonZeroBits(XorSource{a, b}, count, bits);
+}
+
+void nibbleNonZeroMask(const std::uint8_t* a, std::size_t count, std::uint64_t* bits) {
+    nibbleNonZeroBits(SingleSource{a}, count, bits);
+}
+
+void orBitsAt(std::uint64_t* dst, std::size_t dstOffset, const std::uint64_t* src, std::size_t count) {
+    const std::size_t words = (count + 63) / 64;
+    const std::size_t shift = dstOffset % 64;
+    std::uint64_t* out = dst + dstOffset / 64;
+
+    for (std::size_t w = 0; w < words; ++w) {
+        std::uint64_t word = src[w];
+        if (w + 1 == words && count % 64 != 0) {
+            word &= (1ULL << (count % 64)) - 1;
+        }
+        if (word == 0) continue;
+
+        out[w] |= word << shift;
+        if (shift != 0) {
+            std::uint64_t carry = word >> (64 - shift);
+            if (carry != 0) out[w + 1] |= carry;
+        }
+    }
+}
+
+} // namespace arc::core
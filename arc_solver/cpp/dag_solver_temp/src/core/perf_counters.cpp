@@ -0,0 +1,173 @@
+#include "core/perf_counters.hpp"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace arc::core {
+
+namespace {
+
+constexpr int COUNTER_COUNT = 4;
+
+// 每线程计数器组；fds[0]为组长（周期），打开失败的成员为-1
+class ThreadCounterGroup {
+public:
+    ThreadCounterGroup() {
+#if defined(__linux__)
+        const std::uint64_t configs[COUNTER_COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES
+        };
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            fds_[i] = openCounter(configs[i], i == 0 ? -1 : fds_[0]);
+            if (i == 0 && fds_[0] < 0) {
+                return;
+            }
+        }
+        ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    ~ThreadCounterGroup() {
+#if defined(__linux__)
+        for (int i = COUNTER_COUNT - 1; i >= 0; --i) {
+            if (fds_[i] >= 0) close(fds_[i]);
+        }
+#endif
+    }
+
+    bool available() const { return fds_[0] >= 0; }
+
+    PerfCounts read() const {
+        PerfCounts counts;
+#if defined(__linux__)
+        if (!available()) return counts;
+        // PERF_FORMAT_GROUP：{nr, values[nr]}，顺序为成功打开的成员顺序
+        std::uint64_t buffer[1 + COUNTER_COUNT] = {};
+        if (::read(fds_[0], buffer, sizeof(buffer)) <= 0) return counts;
+        std::uint64_t* fields[COUNTER_COUNT] = {
+            &counts.cycles, &counts.instructions, &counts.cacheMisses, &counts.branchMisses
+        };
+        std::uint64_t next = 0;
+        for (int i = 0; i < COUNTER_COUNT && next < buffer[0]; ++i) {
+            if (fds_[i] >= 0) {
+                *fields[i] = buffer[1 + next++];
+            }
+        }
+#endif
+        return counts;
+    }
+
+private:
+    int fds_[COUNTER_COUNT] = {-1, -1, -1, -1};
+
+#if defined(__linux__)
+    static int openCounter(std::uint64_t config, int groupFd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = groupFd < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;     // perf_event_paranoid <= 2时无特权也可打开
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+        return static_cast<int>(fd);
+    }
+#endif
+};
+
+struct ThreadPerfState {
+    bool active = false;
+    SolveStage stage = SolveStage::Other;
+    PerfCounts lastReading;
+    PerfStageCounts totals{};
+};
+
+thread_local ThreadPerfState perfState;
+
+ThreadCounterGroup& threadGroup() {
+    thread_local ThreadCounterGroup group;
+    return group;
+}
+
+// 把上次读取以来的计数记到当前阶段
+void accumulate() {
+    PerfCounts now = threadGroup().read();
+    perfState.totals[static_cast<std::size_t>(perfState.stage)] += now - perfState.lastReading;
+    perfState.lastReading = now;
+}
+
+} // namespace
+
+PerfCounts& PerfCounts::operator+=(const PerfCounts& other) {
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cacheMisses += other.cacheMisses;
+    branchMisses += other.branchMisses;
+    return *this;
+}
+
+PerfCounts PerfCounts::operator-(const PerfCounts& other) const {
+    PerfCounts result;
+    result.cycles = cycles - other.cycles;
+    result.instructions = instructions - other.instructions;
+    result.cacheMisses = cacheMisses - other.cacheMisses;
+    result.branchMisses = branchMisses - other.branchMisses;
+    return result;
+}
+
+// ============================================================================
+// 作用域
+// ============================================================================
+
+PerfTaskScope::PerfTaskScope(bool enabled) : previousActive_(perfState.active) {
+    if (!enabled || !threadGroup().available()) {
+        return;
+    }
+    active_ = true;
+    if (perfState.active) {
+        accumulate();
+    } else {
+        perfState.lastReading = threadGroup().read();
+        perfState.active = true;
+    }
+    baseline_ = perfState.totals;
+}
+
+PerfTaskScope::~PerfTaskScope() {
+    if (active_) {
+        accumulate();
+        perfState.active = previousActive_;
+    }
+}
+
+PerfStageCounts PerfTaskScope::stageDelta() const {
+    PerfStageCounts delta{};
+    if (!active_) return delta;
+    accumulate();
+    for (std::size_t i = 0; i < SOLVE_STAGE_COUNT; ++i) {
+        delta[i] = perfState.totals[i] - baseline_[i];
+    }
+    return delta;
+}
+
+SolveStage enterPerfStage(SolveStage stage) {
+    SolveStage previous = perfState.stage;
+    if (perfState.active) {
+        accumulate();
+    }
+    perfState.stage = stage;
+    return previous;
+}
+
+} // namespace arc::core
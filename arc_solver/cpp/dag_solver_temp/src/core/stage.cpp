@@ -0,0 +1,27 @@
+#include "core/stage.hpp"
+#include "core/alloc_stats.hpp"
+#include "core/perf_counters.hpp"
+
+namespace arc::core {
+
+const char* solveStageName(SolveStage stage) {
+    switch (stage) {
+        case SolveStage::Other: return "other";
+        case SolveStage::SizePrediction: return "size_prediction";
+        case SolveStage::DAGBuild: return "dag_build";
+        case SolveStage::PieceExtraction: return "piece_extraction";
+        case SolveStage::Composition: return "composition";
+        case SolveStage::Evaluation: return "evaluation";
+        default: return "unknown";
+    }
+}
+
+StageScope::StageScope(SolveStage stage)
+    : previousAlloc_(enterAllocStage(stage)), previousPerf_(enterPerfStage(stage)) {}
+
+StageScope::~StageScope() {
+    enterPerfStage(previousPerf_);
+    enterAllocStage(previousAlloc_);
+}
+
+} // namespace arc::core
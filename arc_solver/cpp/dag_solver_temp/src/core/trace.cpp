@@ -0,0 +1,169 @@
+#include "core/trace.hpp"
+
+#if defined(ARC_ENABLE_TRACING)
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace arc::core {
+
+namespace {
+
+void writeJsonString(std::ostream& out, const std::string& value) {
+    out << '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out << escaped;
+                } else {
+                    out << c;
+                }
+                break;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+    }
+    epoch_ = std::chrono::steady_clock::now();
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop() {
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+std::int64_t Tracer::now() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - epoch_).count();
+}
+
+Tracer::ThreadBuffer& Tracer::localBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer->threadId = static_cast<std::uint32_t>(buffers_.size() + 1);
+        buffers_.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Tracer::record(TraceEvent&& event) {
+    ThreadBuffer& buffer = localBuffer();
+    event.threadId = buffer.threadId;
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back(std::move(event));
+}
+
+std::size_t Tracer::eventCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t count = 0;
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+void Tracer::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("无法写入trace文件: " + path);
+    }
+
+    const long pid = static_cast<long>(::getpid());
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        if (buffer->events.empty()) continue;
+
+        // 线程名元数据，Perfetto中按worker分行显示
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+            << ",\"tid\":" << buffer->threadId << ",\"args\":{\"name\":\"worker-" << buffer->threadId << "\"}}";
+        first = false;
+
+        for (const TraceEvent& event : buffer->events) {
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"cat\":";
+            writeJsonString(out, event.category);
+            out << ",\"ph\":\"X\",\"ts\":" << event.start << ",\"dur\":" << event.duration
+                << ",\"pid\":" << pid << ",\"tid\":" << event.threadId;
+            if (!event.counters.empty() || !event.labels.empty()) {
+                out << ",\"args\":{";
+                bool firstArg = true;
+                for (const auto& [key, value] : event.counters) {
+                    out << (firstArg ? "" : ",");
+                    writeJsonString(out, key);
+                    out << ':' << value;
+                    firstArg = false;
+                }
+                for (const auto& [key, value] : event.labels) {
+                    out << (firstArg ? "" : ",");
+                    writeJsonString(out, key);
+                    out << ':';
+                    writeJsonString(out, value);
+                    firstArg = false;
+                }
+                out << '}';
+            }
+            out << '}';
+        }
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        throw std::runtime_error("写入trace文件失败: " + path);
+    }
+}
+
+// ============================================================================
+// TraceSpan 实现
+// ============================================================================
+
+TraceSpan::TraceSpan(const char* name, const char* category)
+    : active_(Tracer::instance().enabled()) {
+    if (active_) {
+        event_.name = name;
+        event_.category = category;
+        event_.start = Tracer::instance().now();
+    }
+}
+
+TraceSpan::~TraceSpan() {
+    if (active_) {
+        Tracer& tracer = Tracer::instance();
+        event_.duration = std::max<std::int64_t>(0, tracer.now() - event_.start);
+        tracer.record(std::move(event_));
+    }
+}
+
+} // namespace arc::core
+
+#endif
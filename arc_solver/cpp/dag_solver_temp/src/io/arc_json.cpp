@@ -0,0 +1,282 @@
+#include "io/arc_json.hpp"
+#include <stdexcept>
+#include <unordered_map>
+
+namespace arc::io {
+
+namespace {
+
+// ============================================================================
+// 只前进的JSON游标 - 只实现ARC文件用到的子集，其余值直接跳过
+// ============================================================================
+
+class Cursor {
+public:
+    Cursor(const char* data, std::size_t size) : begin_(data), p_(data), end_(data + size) {}
+
+    void skipWhitespace() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+    }
+
+    bool peek(char c) {
+        skipWhitespace();
+        return p_ < end_ && *p_ == c;
+    }
+
+    bool consume(char c) {
+        if (!peek(c)) return false;
+        ++p_;
+        return true;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) fail(std::string("期望 '") + c + "'");
+    }
+
+    void expectEnd() {
+        skipWhitespace();
+        if (p_ != end_) fail("多余的内容");
+    }
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("JSON解析错误 (偏移 " + std::to_string(p_ - begin_) + "): " + what);
+    }
+
+    // 对象成员逐个回调fn(key)，fn负责消费值
+    template <typename Fn>
+    void parseObject(Fn&& fn) {
+        expect('{');
+        if (consume('}')) return;
+        do {
+            std::string key = parseString();
+            expect(':');
+            fn(key);
+        } while (consume(','));
+        expect('}');
+    }
+
+    // 数组元素逐个回调fn()
+    template <typename Fn>
+    void parseArray(Fn&& fn) {
+        expect('[');
+        if (consume(']')) return;
+        do {
+            fn();
+        } while (consume(','));
+        expect(']');
+    }
+
+    std::string parseString() {
+        expect('"');
+        std::string out;
+        const char* start = p_;
+        while (p_ < end_ && *p_ != '"') {
+            if (*p_ != '\\') {
+                ++p_;
+                continue;
+            }
+            out.append(start, p_);
+            if (++p_ >= end_) break;
+            switch (*p_) {
+                case 'n': out.push_back('\n'); break;
+                case 't': out.push_back('\t'); break;
+                case 'r': out.push_back('\r'); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'u': appendUnicodeEscape(out); break;
+                default: out.push_back(*p_); break;
+            }
+            start = ++p_;
+        }
+        if (p_ >= end_) fail("字符串未结束");
+        out.append(start, p_);
+        ++p_;
+        return out;
+    }
+
+    int parseInt() {
+        skipWhitespace();
+        bool negative = p_ < end_ && *p_ == '-';
+        if (negative) ++p_;
+        if (p_ >= end_ || *p_ < '0' || *p_ > '9') fail("期望整数");
+        int value = 0;
+        while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+            value = value * 10 + (*p_ - '0');
+            if (value > 1000000) fail("整数过大");
+            ++p_;
+        }
+        return negative ? -value : value;
+    }
+
+    // 网格：行数组，每行是像素数组，必须是矩形
+    arc::core::Grid parseGrid() {
+        arc::core::Grid grid;
+        int width = -1;
+        parseArray([&] {
+            int rowWidth = 0;
+            parseArray([&] {
+                int value = parseInt();
+                if (value < 0 || value > 255) fail("像素值越界");
+                grid.pixels.push_back(static_cast<std::uint8_t>(value));
+                ++rowWidth;
+            });
+            if (width < 0) {
+                width = rowWidth;
+            } else if (rowWidth != width) {
+                fail("网格不是矩形");
+            }
+            ++grid.height;
+        });
+        grid.width = width < 0 ? 0 : width;
+        return grid;
+    }
+
+    void skipValue() {
+        skipWhitespace();
+        if (p_ >= end_) fail("期望值");
+        switch (*p_) {
+            case '{': parseObject([&](const std::string&) { skipValue(); }); break;
+            case '[': parseArray([&] { skipValue(); }); break;
+            case '"': parseString(); break;
+            default:
+                while (p_ < end_ && *p_ != ',' && *p_ != ']' && *p_ != '}' &&
+                       *p_ != ' ' && *p_ != '\n' && *p_ != '\r' && *p_ != '\t') {
+                    ++p_;
+                }
+                break;
+        }
+    }
+
+private:
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+
+    void appendUnicodeEscape(std::string& out) {
+        if (end_ - p_ < 5) fail("无效的\\u转义");
+        unsigned code = 0;
+        for (int i = 1; i <= 4; ++i) {
+            char h = p_[i];
+            code <<= 4;
+            if (h >= '0' && h <= '9') code |= h - '0';
+            else if (h >= 'a' && h <= 'f') code |= h - 'a' + 10;
+            else if (h >= 'A' && h <= 'F') code |= h - 'A' + 10;
+            else fail("无效的\\u转义");
+        }
+        p_ += 4;
+        // 只需要BMP范围，编码为UTF-8
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+};
+
+// {"input": grid, "output": grid}，output可选
+void parseExample(Cursor& cursor, arc::core::Grid& input, arc::core::Grid& output, bool& hasOutput) {
+    bool hasInput = false;
+    hasOutput = false;
+    cursor.parseObject([&](const std::string& key) {
+        if (key == "input") {
+            input = cursor.parseGrid();
+            hasInput = true;
+        } else if (key == "output") {
+            output = cursor.parseGrid();
+            hasOutput = true;
+        } else {
+            cursor.skipValue();
+        }
+    });
+    if (!hasInput) cursor.fail("样例缺少input");
+}
+
+void parseTaskBody(Cursor& cursor, TaskRecord& task) {
+    cursor.parseObject([&](const std::string& key) {
+        if (key == "train") {
+            cursor.parseArray([&] {
+                arc::core::Grid input, output;
+                bool hasOutput = false;
+                parseExample(cursor, input, output, hasOutput);
+                if (!hasOutput) cursor.fail("训练样例缺少output");
+                task.train.emplace_back(std::move(input), std::move(output));
+            });
+        } else if (key == "test") {
+            cursor.parseArray([&] {
+                arc::core::Grid input, output;
+                bool hasOutput = false;
+                parseExample(cursor, input, output, hasOutput);
+                // 按位置记录output，部分test没有output时后面的不会错位
+                task.testInputs.push_back(std::move(input));
+                task.testOutputs.emplace_back();
+                if (hasOutput) task.testOutputs.back() = std::move(output);
+            });
+        } else {
+            cursor.skipValue();
+        }
+    });
+}
+
+} // namespace
+
+TaskRecord parseTaskJson(const char* data, std::size_t size, const std::string& id) {
+    Cursor cursor(data, size);
+    TaskRecord task;
+    task.id = id;
+    parseTaskBody(cursor, task);
+    cursor.expectEnd();
+    return task;
+}
+
+std::vector<TaskRecord> parseChallengesJson(const char* data, std::size_t size) {
+    Cursor cursor(data, size);
+    std::vector<TaskRecord> tasks;
+    cursor.parseObject([&](const std::string& key) {
+        tasks.emplace_back();
+        tasks.back().id = key;
+        parseTaskBody(cursor, tasks.back());
+    });
+    cursor.expectEnd();
+    return tasks;
+}
+
+void applySolutionsJson(const char* data, std::size_t size, std::vector<TaskRecord>& tasks) {
+    std::unordered_map<std::string, std::size_t> indexById;
+    indexById.reserve(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        indexById.emplace(tasks[i].id, i);
+    }
+
+    Cursor cursor(data, size);
+    cursor.parseObject([&](const std::string& key) {
+        auto it = indexById.find(key);
+        if (it == indexById.end()) {
+            cursor.skipValue();
+            return;
+        }
+        auto& outputs = tasks[it->second].testOutputs;
+        outputs.clear();
+        cursor.parseArray([&] { outputs.push_back(cursor.parseGrid()); });
+    });
+    cursor.expectEnd();
+}
+
+std::vector<TaskRecord> parseArcJson(const char* data, std::size_t size, const std::string& defaultId) {
+    // 用游标副本预读第一个键
+    Cursor probe(data, size);
+    probe.expect('{');
+    if (probe.consume('}')) return {};
+    std::string firstKey = probe.parseString();
+
+    if (firstKey == "train" || firstKey == "test") {
+        return {parseTaskJson(data, size, defaultId)};
+    }
+    return parseChallengesJson(data, size);
+}
+
+} // namespace arc::io
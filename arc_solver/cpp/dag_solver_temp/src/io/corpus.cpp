@@ -0,0 +1,316 @@
+#include "io/corpus.hpp"
+#include "core/packed.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace arc::io {
+
+namespace {
+
+constexpr std::uint64_t PAYLOAD_ALIGNMENT = 16;
+constexpr std::uint64_t GRID_INDEX_ALIGNMENT = alignof(CorpusGridEntry);
+
+inline std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+inline std::size_t payloadBytes(std::size_t pixels, bool nibbles) {
+    return nibbles ? arc::core::packedBytes(pixels) : pixels;
+}
+
+bool hasAnyOutput(const TaskRecord& task) {
+    for (const auto& output : task.testOutputs) {
+        if (output) return true;
+    }
+    return false;
+}
+
+// 按语料中的顺序列出一个任务的全部网格，缺少output的test为nullptr
+std::vector<const arc::core::Grid*> taskGrids(const TaskRecord& task) {
+    std::vector<const arc::core::Grid*> grids;
+    grids.reserve(2 * task.train.size() + 2 * task.testInputs.size());
+    for (const auto& [input, output] : task.train) {
+        grids.push_back(&input);
+        grids.push_back(&output);
+    }
+    for (const auto& grid : task.testInputs) grids.push_back(&grid);
+    if (hasAnyOutput(task)) {
+        for (std::size_t i = 0; i < task.testInputs.size(); ++i) {
+            const bool present = i < task.testOutputs.size() && task.testOutputs[i];
+            grids.push_back(present ? &*task.testOutputs[i] : nullptr);
+        }
+    }
+    return grids;
+}
+
+} // namespace
+
+void writeCorpus(const std::vector<TaskRecord>& tasks, const std::string& path, bool packNibbles) {
+    std::vector<CorpusTaskEntry> taskEntries;
+    std::vector<CorpusGridEntry> gridEntries;
+    std::string strings;
+    std::uint64_t payloadSize = 0;
+
+    taskEntries.reserve(tasks.size());
+    for (const auto& task : tasks) {
+        if (task.train.size() > std::numeric_limits<std::uint16_t>::max() ||
+            task.testInputs.size() > std::numeric_limits<std::uint16_t>::max() ||
+            task.testOutputs.size() > task.testInputs.size()) {
+            throw std::runtime_error("任务样例数超出语料格式范围: " + task.id);
+        }
+
+        CorpusTaskEntry entry{};
+        entry.idOffset = static_cast<std::uint32_t>(strings.size());
+        entry.idLength = static_cast<std::uint32_t>(task.id.size());
+        entry.firstGrid = static_cast<std::uint32_t>(gridEntries.size());
+        entry.trainCount = static_cast<std::uint16_t>(task.train.size());
+        entry.testCount = static_cast<std::uint16_t>(task.testInputs.size());
+        entry.testOutputCount = static_cast<std::uint16_t>(hasAnyOutput(task) ? task.testInputs.size() : 0);
+        strings += task.id;
+        taskEntries.push_back(entry);
+
+        for (const arc::core::Grid* grid : taskGrids(task)) {
+            CorpusGridEntry gridEntry{};
+            if (grid == nullptr) {
+                gridEntry.payloadOffset = payloadSize;
+                gridEntry.flags = CORPUS_GRID_ABSENT;
+                gridEntries.push_back(gridEntry);
+                continue;
+            }
+            if (grid->width > std::numeric_limits<std::uint16_t>::max() ||
+                grid->height > std::numeric_limits<std::uint16_t>::max()) {
+                throw std::runtime_error("网格尺寸超出语料格式范围: " + task.id);
+            }
+            // 4位压缩只能表示0-15，解析器接受到255，不能静默截断
+            if (packNibbles) {
+                for (std::uint8_t pixel : grid->pixels) {
+                    if (pixel > 15) {
+                        throw std::runtime_error("像素值 " + std::to_string(pixel) +
+                                                 " 超出4位压缩范围(0-15): " + task.id);
+                    }
+                }
+            }
+            gridEntry.payloadOffset = payloadSize;
+            gridEntry.width = static_cast<std::uint16_t>(grid->width);
+            gridEntry.height = static_cast<std::uint16_t>(grid->height);
+            gridEntries.push_back(gridEntry);
+            payloadSize = alignUp(payloadSize + payloadBytes(grid->pixels.size(), packNibbles), PAYLOAD_ALIGNMENT);
+        }
+    }
+
+    CorpusHeader header{};
+    std::memcpy(header.magic, CORPUS_MAGIC, sizeof(header.magic));
+    header.version = CORPUS_VERSION;
+    header.flags = packNibbles ? CORPUS_FLAG_NIBBLES : 0;
+    header.taskCount = static_cast<std::uint32_t>(taskEntries.size());
+    header.gridCount = static_cast<std::uint32_t>(gridEntries.size());
+    header.taskIndexOffset = sizeof(CorpusHeader);
+    header.gridIndexOffset = alignUp(header.taskIndexOffset + taskEntries.size() * sizeof(CorpusTaskEntry),
+                                     GRID_INDEX_ALIGNMENT);
+    header.stringsOffset = header.gridIndexOffset + gridEntries.size() * sizeof(CorpusGridEntry);
+    header.payloadOffset = alignUp(header.stringsOffset + strings.size(), PAYLOAD_ALIGNMENT);
+    header.fileSize = header.payloadOffset + payloadSize;
+
+    // 像素区在内存中拼好后一次写出
+    std::vector<std::uint8_t> payload(payloadSize, 0);
+    std::size_t gridIndex = 0;
+    for (const auto& task : tasks) {
+        for (const arc::core::Grid* grid : taskGrids(task)) {
+            std::uint8_t* dst = payload.data() + gridEntries[gridIndex++].payloadOffset;
+            if (grid == nullptr) {
+                continue;
+            } else if (packNibbles) {
+                arc::core::packNibbles(grid->pixels.data(), grid->pixels.size(), dst);
+            } else if (!grid->pixels.empty()) {
+                std::memcpy(dst, grid->pixels.data(), grid->pixels.size());
+            }
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("无法写入语料文件: " + path);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(taskEntries.data()), taskEntries.size() * sizeof(CorpusTaskEntry));
+    std::string indexPadding(header.gridIndexOffset - header.taskIndexOffset -
+                             taskEntries.size() * sizeof(CorpusTaskEntry), '\0');
+    out.write(indexPadding.data(), indexPadding.size());
+    out.write(reinterpret_cast<const char*>(gridEntries.data()), gridEntries.size() * sizeof(CorpusGridEntry));
+    out.write(strings.data(), strings.size());
+    std::string padding(header.payloadOffset - header.stringsOffset - strings.size(), '\0');
+    out.write(padding.data(), padding.size());
+    out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    if (!out) {
+        throw std::runtime_error("写入语料文件失败: " + path);
+    }
+}
+
+std::size_t convertJsonToCorpus(
+    const std::string& jsonPath,
+    const std::string& corpusPath,
+    const std::string& solutionsPath,
+    bool packNibbles
+) {
+    MappedFile json(jsonPath);
+    std::string defaultId = std::filesystem::path(jsonPath).stem().string();
+    std::vector<TaskRecord> tasks = parseArcJson(json.data(), json.size(), defaultId);
+    if (!solutionsPath.empty()) {
+        MappedFile solutions(solutionsPath);
+        applySolutionsJson(solutions.data(), solutions.size(), tasks);
+    }
+    writeCorpus(tasks, corpusPath, packNibbles);
+    return tasks.size();
+}
+
+// ============================================================================
+// CorpusReader 实现
+// ============================================================================
+
+CorpusReader::CorpusReader(const std::string& path) : file_(path) {
+    attach(file_.data(), file_.size(), path);
+}
+
+CorpusReader::CorpusReader(const char* data, std::size_t size) {
+    attach(data, size, "内存缓冲区");
+}
+
+void CorpusReader::attach(const char* data, std::size_t size, const std::string& path) {
+    if (size < sizeof(CorpusHeader)) {
+        throw std::runtime_error("语料文件过小: " + path);
+    }
+    // 索引按结构体直接访问，缓冲区本身必须满足最严格的对齐要求
+    if (reinterpret_cast<std::uintptr_t>(data) % GRID_INDEX_ALIGNMENT != 0) {
+        throw std::runtime_error("语料缓冲区未按8字节对齐: " + path);
+    }
+    header_ = reinterpret_cast<const CorpusHeader*>(data);
+    if (std::memcmp(header_->magic, CORPUS_MAGIC, sizeof(CORPUS_MAGIC)) != 0) {
+        throw std::runtime_error("不是有效的语料文件: " + path);
+    }
+    if (header_->version != CORPUS_VERSION) {
+        throw std::runtime_error("语料格式版本 " + std::to_string(header_->version) + " 不受支持（当前为 " +
+                                 std::to_string(CORPUS_VERSION) + "），请重新转换: " + path);
+    }
+    if (header_->fileSize != size ||
+        header_->taskIndexOffset != sizeof(CorpusHeader) ||
+        header_->gridIndexOffset != alignUp(header_->taskIndexOffset +
+                                            std::uint64_t{header_->taskCount} * sizeof(CorpusTaskEntry),
+                                            GRID_INDEX_ALIGNMENT) ||
+        header_->stringsOffset != header_->gridIndexOffset + std::uint64_t{header_->gridCount} * sizeof(CorpusGridEntry) ||
+        header_->payloadOffset < header_->stringsOffset || header_->payloadOffset > size) {
+        throw std::runtime_error("语料文件已损坏: " + path);
+    }
+
+    tasks_ = reinterpret_cast<const CorpusTaskEntry*>(data + header_->taskIndexOffset);
+    grids_ = reinterpret_cast<const CorpusGridEntry*>(data + header_->gridIndexOffset);
+    strings_ = data + header_->stringsOffset;
+    payload_ = reinterpret_cast<const std::uint8_t*>(data + header_->payloadOffset);
+
+    // 一次性检查所有索引，之后的访问不再检查边界
+    const std::uint64_t payloadSize = header_->fileSize - header_->payloadOffset;
+    const std::uint64_t stringsSize = header_->payloadOffset - header_->stringsOffset;
+    for (std::size_t i = 0; i < header_->gridCount; ++i) {
+        std::uint64_t bytes = payloadBytes(std::size_t{grids_[i].width} * grids_[i].height, isPacked());
+        // 分开比较，避免损坏的payloadOffset使加法回绕而通过检查
+        if (grids_[i].payloadOffset > payloadSize || bytes > payloadSize - grids_[i].payloadOffset) {
+            throw std::runtime_error("语料文件已损坏: " + path);
+        }
+    }
+    for (std::size_t i = 0; i < header_->taskCount; ++i) {
+        const CorpusTaskEntry& entry = tasks_[i];
+        std::uint64_t grids = 2ull * entry.trainCount + entry.testCount + entry.testOutputCount;
+        if (std::uint64_t{entry.idOffset} + entry.idLength > stringsSize ||
+            entry.firstGrid + grids > header_->gridCount ||
+            (entry.testOutputCount != 0 && entry.testOutputCount != entry.testCount)) {
+            throw std::runtime_error("语料文件已损坏: " + path);
+        }
+    }
+}
+
+TaskView CorpusReader::task(std::size_t index) const {
+    if (index >= taskCount()) {
+        throw std::out_of_range("任务索引越界");
+    }
+    const CorpusTaskEntry& entry = tasks_[index];
+    TaskView view;
+    view.id.assign(strings_ + entry.idOffset, entry.idLength);
+    view.firstGrid = entry.firstGrid;
+    view.trainCount = entry.trainCount;
+    view.testCount = entry.testCount;
+    view.testOutputCount = entry.testOutputCount;
+    return view;
+}
+
+GridView CorpusReader::gridView(std::size_t gridIndex) const {
+    if (gridIndex >= gridCount()) {
+        throw std::out_of_range("网格索引越界");
+    }
+    const CorpusGridEntry& entry = grids_[gridIndex];
+    return GridView{entry.width, entry.height, payload_ + entry.payloadOffset};
+}
+
+bool CorpusReader::hasGrid(std::size_t gridIndex) const {
+    if (gridIndex >= gridCount()) {
+        throw std::out_of_range("网格索引越界");
+    }
+    return (grids_[gridIndex].flags & CORPUS_GRID_ABSENT) == 0;
+}
+
+void CorpusReader::loadGridInto(std::size_t gridIndex, std::uint8_t* out) const {
+    GridView view = gridView(gridIndex);
+    if (isPacked()) {
+        arc::core::unpackNibbles(view.pixels, view.pixelCount(), out);
+    } else if (view.pixelCount() > 0) {
+        std::memcpy(out, view.pixels, view.pixelCount());
+    }
+}
+
+arc::core::Grid CorpusReader::loadGrid(std::size_t gridIndex) const {
+    GridView view = gridView(gridIndex);
+    arc::core::Grid grid;
+    grid.width = view.width;
+    grid.height = view.height;
+    if (isPacked()) {
+        grid.pixels.resize(view.pixelCount());
+        arc::core::unpackNibbles(view.pixels, view.pixelCount(), grid.pixels.data());
+    } else {
+        grid.pixels.assign(view.pixels, view.pixels + view.pixelCount());
+    }
+    return grid;
+}
+
+TaskRecord CorpusReader::loadTask(std::size_t index) const {
+    TaskView view = task(index);
+    TaskRecord record;
+    record.id = view.id;
+    record.train.reserve(view.trainCount);
+    for (std::size_t i = 0; i < view.trainCount; ++i) {
+        record.train.emplace_back(loadGrid(view.trainInputGrid(i)), loadGrid(view.trainOutputGrid(i)));
+    }
+    record.testInputs.reserve(view.testCount);
+    for (std::size_t i = 0; i < view.testCount; ++i) {
+        record.testInputs.push_back(loadGrid(view.testInputGrid(i)));
+    }
+    record.testOutputs.reserve(view.testOutputCount);
+    for (std::size_t i = 0; i < view.testOutputCount; ++i) {
+        record.testOutputs.emplace_back();
+        if (hasGrid(view.testOutputGrid(i))) {
+            record.testOutputs.back() = loadGrid(view.testOutputGrid(i));
+        }
+    }
+    return record;
+}
+
+std::vector<TaskRecord> CorpusReader::loadAll() const {
+    std::vector<TaskRecord> records;
+    records.reserve(taskCount());
+    for (std::size_t i = 0; i < taskCount(); ++i) {
+        records.push_back(loadTask(i));
+    }
+    return records;
+}
+
+} // namespace arc::io
@@ -1,7 +1,23 @@
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
 #include <string>
 #include "solver.hpp"
+#include "process_pool.hpp"
+#include "batch_journal.hpp"
+#include "result_cache.hpp"
+#include "solver_daemon.hpp"
+#include "work_queue.hpp"
+#include "shared_store.hpp"
+#include "io/corpus.hpp"
+#include "core/log.hpp"
+#include "core/parallel.hpp"
+#include "core/trace.hpp"
 
 using namespace arc::solver;
 
@@ -10,11 +26,345 @@ void printUsage(const char* programName) {
     std::cout << "选项:" << std::endl;
     std::cout << "  -h, --help     显示帮助信息" << std::endl;
     std::cout << "  -d DEPTH       设置最大搜索深度 (默认: 20)" << std::endl;
+    std::cout << "  --fixed-depth  直接搜索到最大深度，不做迭代加深" << std::endl;
     std::cout << "  -f, --fast     使用快速模式" << std::endl;
     std::cout << "  -a, --accurate 使用高精度模式" << std::endl;
     std::cout << "  -t, --times    显示计时信息" << std::endl;
     std::cout << "  -m, --memory   显示内存使用信息" << std::endl;
     std::cout << "  --demo         运行演示" << std::endl;
+    std::cout << "  --convert JSON CORPUS  将ARC JSON转换为二进制语料" << std::endl;
+    std::cout << "  --batch PATH           批量评估：challenges JSON、任务目录或二进制语料" << std::endl;
+    std::cout << "  --solutions FILE       合并solutions.json（批量评估与转换）" << std::endl;
+    std::cout << "  -j, --threads N        批量评估的工作线程数 (默认: 硬件并发数)" << std::endl;
+    std::cout << "  --budget SEC           每个任务的时间预算" << std::endl;
+    std::cout << "  --deadline SEC         整批的墙钟预算，按预测耗时为每个任务分配时间和节点预算" << std::endl;
+    std::cout << "  --report FILE          批量评估结果写入JSON"  << std::endl;
+    std::cout << "  --isolate              批量评估在fork出的工作进程中进行，崩溃或超限的任务记为失败" << std::endl;
+    std::cout << "  --worker-rss MB        每个工作进程的常驻内存上限，超出即杀死（需--isolate）" << std::endl;
+    std::cout << "  --worker-as MB         每个工作进程的地址空间上限RLIMIT_AS（需--isolate）" << std::endl;
+    std::cout << "  --task-timeout SEC     单任务墙钟上限，超出即杀死工作进程（需--isolate）" << std::endl;
+    std::cout << "  --cache FILE           持久化结果缓存，相同配置下重复求解直接复用" << std::endl;
+    std::cout << "  --journal FILE         批量评估日志，每完成一个任务追加一条，中断后重跑跳过已完成的任务" << std::endl;
+    std::cout << "  --submission FILE      由日志生成Kaggle格式的submission.json（未指定--journal时使用FILE.journal）" << std::endl;
+    std::cout << "  --coordinator PORT     批量评估由协调进程通过TCP分发给工作进程（需--batch）" << std::endl;
+    std::cout << "  --bind ADDR            协调进程的监听地址 (默认: 127.0.0.1，其他机器上的工作进程需显式指定，如0.0.0.0)" << std::endl;
+    std::cout << "  --worker HOST:PORT     作为工作进程向协调进程领取任务（需与协调进程相同的--batch）" << std::endl;
+    std::cout << "  --lease-timeout SEC    工作进程多久没有心跳即收回其任务 (默认: 30)" << std::endl;
+    std::cout << "  --shm-create NAME      把--batch指定的二进制语料载入命名共享内存段" << std::endl;
+    std::cout << "  --shm-worker NAME      附加到共享内存段，领取并求解任务，结果写回段内槽位" << std::endl;
+    std::cout << "  --shm-collect NAME     读回共享内存段内的结果，写出--report/--submission并追加到日志" << std::endl;
+    std::cout << "  --shm-unlink NAME      删除共享内存段（先--shm-collect，否则结果随段一起丢失）" << std::endl;
+    std::cout << "  --serve SOCKET         作为常驻守护进程监听Unix socket（-j为求解线程数）" << std::endl;
+    std::cout << "  --remote SOCKET        将--batch指定的JSON或语料文件交给守护进程求解" << std::endl;
+    std::cout << "  --nibble               转换时按4位压缩像素" << std::endl;
+    std::cout << "  --perf                 按阶段采集硬件性能计数器（Linux perf_event）" << std::endl;
+    std::cout << "  --log-level LEVEL      日志级别: trace/debug/info/warn/error/off (默认: warn)" << std::endl;
+    std::cout << "  --trace FILE           将各阶段耗时写入Chrome trace JSON（需ARC_ENABLE_TRACING编译）" << std::endl;
+}
+
+// 按路径类型加载批量任务：challenges JSON、任务目录或二进制语料
+bool loadBatchTasks(const std::string& batchPath, const std::string& solutionsPath, std::vector<ARCTask>& tasks) {
+    try {
+        if (std::filesystem::is_directory(batchPath)) {
+            tasks = TaskLoader::loadFromDirectory(batchPath);
+        } else if (std::filesystem::path(batchPath).extension() == ".json") {
+            tasks = TaskLoader::loadChallenges(batchPath, solutionsPath);
+        } else {
+            tasks = TaskLoader::loadCorpus(batchPath);
+        }
+    } catch (const std::exception& e) {
+        std::cout << colorRed("加载任务失败: ") << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 批量评估：多线程、多进程或由协调进程分发求解，并输出摘要
+int runBatch(ARCSolver& solver, const std::string& batchPath, const std::string& solutionsPath,
+             const std::string& reportPath, const std::string& submissionPath,
+             const ProcessPool::Config* isolation, const BatchCoordinator::Config* coordination) {
+    std::vector<ARCTask> tasks;
+    if (!loadBatchTasks(batchPath, solutionsPath, tasks)) {
+        return 1;
+    }
+    
+    const std::size_t threads = arc::core::resolveThreadCount(solver.getConfig().batchThreads, tasks.size());
+    std::cout << "已加载 " << tasks.size() << " 个测试输入";
+    if (!coordination) {
+        std::cout << "，使用 " << threads << (isolation ? " 个工作进程" : " 个线程");
+    }
+    std::cout << std::endl;
+    
+    auto start = std::chrono::steady_clock::now();
+    std::vector<SolveResult> results;
+    const std::string& journalPath = solver.getConfig().journalPath;
+    if (coordination) {
+        std::cout << "协调进程监听端口 " << coordination->port << "，等待工作进程" << std::endl;
+        BatchCoordinator coordinator(*coordination);
+        try {
+            results = coordinator.run(solver, tasks);
+        } catch (const std::exception& e) {
+            std::cout << colorRed("协调进程失败: ") << e.what() << std::endl;
+            return 1;
+        }
+        for (const auto& failure : coordinator.failures()) {
+            std::cout << colorYellow("失败: ") << tasks[failure.index].taskId << " - " << failure.reason << std::endl;
+        }
+        std::cout << "共 " << coordinator.workersSeen() << " 个工作连接，重新分发 "
+                  << coordinator.reassignments() << " 次" << std::endl;
+    } else if (isolation) {
+        // 任务和函数库已加载，工作进程以写时复制方式共享
+        ProcessPool pool(*isolation);
+        std::vector<std::size_t> pending;
+        try {
+            if (journalPath.empty()) {
+                results = pool.run(solver, tasks);
+                pending.resize(tasks.size());
+                std::iota(pending.begin(), pending.end(), std::size_t{0});
+            } else {
+                // 工作进程池不经过solveBatch，在这里恢复日志并追加新结果
+                BatchJournal journal(journalPath, solverFingerprint(solver.getConfig()));
+                pending = journal.restore(tasks, results);
+                std::vector<ARCTask> pendingTasks;
+                for (std::size_t i = 0, next = 0; i < tasks.size(); ++i) {
+                    if (next < pending.size() && pending[next] == i) {
+                        pendingTasks.push_back(tasks[i]);
+                        ++next;
+                    } else {
+                        solver.recordResult(results[i]);
+                    }
+                }
+                std::cout << "从日志恢复 " << (tasks.size() - pending.size()) << " 个任务" << std::endl;
+                
+                auto solved = pool.run(solver, pendingTasks, [&](std::size_t i, const SolveResult& result) {
+                    journal.append(pendingTasks[i], result);
+                });
+                for (std::size_t i = 0; i < pending.size(); ++i) {
+                    results[pending[i]] = std::move(solved[i]);
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cout << colorRed("工作进程池失败: ") << e.what() << std::endl;
+            return 1;
+        }
+        for (const auto& failure : pool.failures()) {
+            std::cout << colorYellow("失败: ") << tasks[pending[failure.index]].taskId << " - " << failure.reason << std::endl;
+        }
+        if (pool.restarts() > 0) {
+            std::cout << "重启工作进程 " << pool.restarts() << " 次" << std::endl;
+        }
+    } else {
+        try {
+            results = solver.solveBatch(tasks);
+        } catch (const std::exception& e) {
+            std::cout << colorRed("批量求解失败: ") << e.what() << std::endl;
+            return 1;
+        }
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    BatchSummary summary = summarizeBatch(tasks, results, wallSeconds, threads);
+    printBatchSummary(summary);
+    printStatistics(solver.getStatistics());
+    
+    if (!reportPath.empty()) {
+        try {
+            writeBatchReportJson(reportPath, summary, tasks, results);
+            std::cout << "报告已写入 " << reportPath << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << colorRed("写入报告失败: ") << e.what() << std::endl;
+            return 1;
+        }
+    }
+    
+    // 由日志而不是本次的results生成，包含之前被中断的运行中完成的任务；
+    // 没有结果的任务也写占位答案，保证submission覆盖全部任务
+    if (!submissionPath.empty()) {
+        try {
+            BatchJournal journal(journalPath, solverFingerprint(solver.getConfig()));
+            journal.writeSubmission(submissionPath, tasks);
+            std::cout << "submission已写入 " << submissionPath << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << colorRed("写入submission失败: ") << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 工作进程模式：加载与协调进程相同的任务，领取并求解直到全部完成
+int runWorker(const SolverConfig& solverConfig, const BatchWorker::Config& workerConfig,
+              const std::string& batchPath, const std::string& solutionsPath) {
+    std::vector<ARCTask> tasks;
+    if (!loadBatchTasks(batchPath, solutionsPath, tasks)) {
+        return 1;
+    }
+    
+    std::cout << "连接协调进程 " << workerConfig.host << ":" << workerConfig.port << std::endl;
+    try {
+        BatchWorker worker(workerConfig);
+        std::size_t solved = worker.run(solverConfig, tasks);
+        std::cout << "本进程求解 " << solved << " 个任务" << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << colorRed("工作进程失败: ") << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// 共享内存工作进程：任意多个进程可同时附加到同一个段
+int runSharedWorker(const SolverConfig& solverConfig, const std::string& name) {
+    try {
+        auto store = SharedTaskStore::attach(name);
+        ARCSolver solver(solverConfig);
+        std::size_t solved = solveFromStore(solver, *store);
+        std::cout << "本进程求解 " << solved << " 个任务，段内已完成 " << store->completed()
+                  << "/" << store->slotCount() << std::endl;
+        printStatistics(solver.getStatistics());
+    } catch (const std::exception& e) {
+        std::cout << colorRed("共享内存工作进程失败: ") << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// 汇总共享内存段：读回全部结果槽位，输出摘要、报告，并追加到日志以便生成submission
+// 尚无结果的槽位（未领取、仍在求解或工作进程崩溃）不写日志，在摘要中计为Nothing
+int runSharedCollect(const SolverConfig& solverConfig, const std::string& name,
+                     const std::string& reportPath, const std::string& submissionPath) {
+    std::vector<ARCTask> tasks;
+    std::vector<SolveResult> results;
+    std::vector<bool> present;
+    try {
+        auto store = SharedTaskStore::attach(name);
+        tasks.reserve(store->slotCount());
+        results.resize(store->slotCount());
+        present.resize(store->slotCount());
+        for (std::size_t slot = 0; slot < store->slotCount(); ++slot) {
+            tasks.push_back(store->loadTask(slot));
+            present[slot] = store->loadResult(slot, results[slot]);
+        }
+    } catch (const std::exception& e) {
+        std::cout << colorRed("读取共享内存段失败: ") << e.what() << std::endl;
+        return 1;
+    }
+    const std::size_t collected = std::count(present.begin(), present.end(), true);
+    std::cout << "已读回 " << collected << "/" << tasks.size() << " 个结果" << std::endl;
+    
+    BatchSummary summary = summarizeBatch(tasks, results, 0.0, 0);
+    printBatchSummary(summary);
+    
+    if (!reportPath.empty()) {
+        try {
+            writeBatchReportJson(reportPath, summary, tasks, results);
+            std::cout << "报告已写入 " << reportPath << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << colorRed("写入报告失败: ") << e.what() << std::endl;
+            return 1;
+        }
+    }
+    
+    if (!solverConfig.journalPath.empty()) {
+        try {
+            BatchJournal journal(solverConfig.journalPath, solverFingerprint(solverConfig));
+            for (std::size_t i = 0; i < tasks.size(); ++i) {
+                if (present[i]) {
+                    journal.append(tasks[i], results[i]);
+                }
+            }
+            journal.sync();
+            std::cout << "已追加到日志 " << solverConfig.journalPath << std::endl;
+            if (!submissionPath.empty()) {
+                journal.writeSubmission(submissionPath, tasks);
+                std::cout << "submission已写入 " << submissionPath << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cout << colorRed("写入日志失败: ") << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 守护进程模式：SIGINT/SIGTERM时停止接受连接并退出
+SolverDaemon* activeDaemon = nullptr;
+
+void stopDaemon(int) {
+    if (activeDaemon) {
+        activeDaemon->stop();
+    }
+}
+
+int runDaemon(const SolverConfig& solverConfig, const SolverDaemon::Config& daemonConfig) {
+    SolverDaemon daemon(solverConfig, daemonConfig);
+    activeDaemon = &daemon;
+    
+    // 不设SA_RESTART，accept()被信号打断后立即检查停止标志
+    struct sigaction action{};
+    action.sa_handler = stopDaemon;
+    sigemptyset(&action.sa_mask);
+    ::sigaction(SIGINT, &action, nullptr);
+    ::sigaction(SIGTERM, &action, nullptr);
+    
+    int status = 0;
+    try {
+        std::cout << "守护进程监听 " << daemonConfig.socketPath << std::endl;
+        daemon.run();
+        std::cout << "已处理 " << daemon.requestsServed() << " 个请求、" << daemon.tasksSolved() << " 个任务" << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << colorRed("守护进程失败: ") << e.what() << std::endl;
+        status = 1;
+    }
+    activeDaemon = nullptr;
+    return status;
+}
+
+// 把任务文件整个发给守护进程，结果到达时逐个打印
+int runRemote(const std::string& socketPath, const std::string& batchPath, double timeBudget) {
+    std::ifstream in(batchPath, std::ios::binary);
+    if (!in.is_open()) {
+        std::cout << colorRed("无法打开 ") << batchPath << std::endl;
+        return 1;
+    }
+    std::string payload((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const RequestFormat format = std::filesystem::path(batchPath).extension() == ".json"
+        ? RequestFormat::Json : RequestFormat::Corpus;
+    
+    auto start = std::chrono::steady_clock::now();
+    try {
+        SolverClient client(socketPath);
+        int index = 0;
+        std::size_t received = client.solve(payload, format, timeBudget,
+            [&](const std::string& taskId, std::size_t, const SolveResult& result) {
+                printResult(index++, taskId, result);
+            });
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "收到 " << received << " 个结果，用时 " << seconds << "s" << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << colorRed("远程求解失败: ") << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// 开始/结束追踪，未编译追踪支持时只给出提示
+void startTrace(const std::string& tracePath) {
+    if (tracePath.empty()) return;
+#if defined(ARC_ENABLE_TRACING)
+    arc::core::Tracer::instance().start();
+#else
+    std::cout << "未启用追踪支持，请以 -DARC_ENABLE_TRACING 重新编译" << std::endl;
+#endif
+}
+
+void finishTrace(const std::string& tracePath) {
+    if (tracePath.empty()) return;
+#if defined(ARC_ENABLE_TRACING)
+    auto& tracer = arc::core::Tracer::instance();
+    tracer.stop();
+    tracer.writeChromeTrace(tracePath);
+    std::cout << "已写入 " << tracer.eventCount() << " 个trace事件 -> " << tracePath << std::endl;
+#endif
 }
 
 ARCTask createDemoTask() {
@@ -150,6 +500,25 @@ int main(int argc, char* argv[]) {
     bool runDemoMode = false;
     bool fastMode = false;
     bool accurateMode = false;
+    std::string convertInput;
+    std::string convertOutput;
+    std::string solutionsPath;
+    std::string tracePath;
+    std::string batchPath;
+    std::string reportPath;
+    std::string submissionPath;
+    std::string serveSocket;
+    bool coordinate = false;
+    BatchCoordinator::Config coordinatorConfig;
+    std::string workerAddress;
+    std::string shmCreate;
+    std::string shmWorker;
+    std::string shmCollect;
+    std::string shmUnlink;
+    std::string remoteSocket;
+    bool isolate = false;
+    ProcessPool::Config poolConfig;
+    bool packNibbles = false;
     
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -159,6 +528,8 @@ int main(int argc, char* argv[]) {
         } else if (arg == "-d" && i + 1 < argc) {
             config.maxDepth = std::atoi(argv[++i]);
             std::cout << "设置最大深度: " << config.maxDepth << std::endl;
+        } else if (arg == "--fixed-depth") {
+            config.iterativeDeepening = false;
         } else if (arg == "-f" || arg == "--fast") {
             fastMode = true;
         } else if (arg == "-a" || arg == "--accurate") {
@@ -169,6 +540,64 @@ int main(int argc, char* argv[]) {
             config.printMemory = true;
         } else if (arg == "--demo") {
             runDemoMode = true;
+        } else if (arg == "--convert" && i + 2 < argc) {
+            convertInput = argv[++i];
+            convertOutput = argv[++i];
+        } else if (arg == "--solutions" && i + 1 < argc) {
+            solutionsPath = argv[++i];
+        } else if (arg == "--coordinator" && i + 1 < argc) {
+            coordinate = true;
+            coordinatorConfig.port = std::atoi(argv[++i]);
+        } else if (arg == "--worker" && i + 1 < argc) {
+            workerAddress = argv[++i];
+        } else if (arg == "--bind" && i + 1 < argc) {
+            coordinatorConfig.bindAddress = argv[++i];
+        } else if (arg == "--lease-timeout" && i + 1 < argc) {
+            coordinatorConfig.leaseTimeout = std::atof(argv[++i]);
+        } else if (arg == "--shm-create" && i + 1 < argc) {
+            shmCreate = argv[++i];
+        } else if (arg == "--shm-worker" && i + 1 < argc) {
+            shmWorker = argv[++i];
+        } else if (arg == "--shm-collect" && i + 1 < argc) {
+            shmCollect = argv[++i];
+        } else if (arg == "--shm-unlink" && i + 1 < argc) {
+            shmUnlink = argv[++i];
+        } else if (arg == "--serve" && i + 1 < argc) {
+            serveSocket = argv[++i];
+        } else if (arg == "--remote" && i + 1 < argc) {
+            remoteSocket = argv[++i];
+        } else if (arg == "--nibble") {
+            packNibbles = true;
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batchPath = argv[++i];
+        } else if ((arg == "-j" || arg == "--threads") && i + 1 < argc) {
+            config.batchThreads = static_cast<std::size_t>(std::atoi(argv[++i]));
+        } else if (arg == "--budget" && i + 1 < argc) {
+            config.timeBudget = std::atof(argv[++i]);
+        } else if (arg == "--deadline" && i + 1 < argc) {
+            config.batchDeadline = std::atof(argv[++i]);
+        } else if (arg == "--report" && i + 1 < argc) {
+            reportPath = argv[++i];
+        } else if (arg == "--isolate") {
+            isolate = true;
+        } else if (arg == "--worker-rss" && i + 1 < argc) {
+            poolConfig.rssLimit = static_cast<std::size_t>(std::atof(argv[++i]) * 1024 * 1024);
+        } else if (arg == "--worker-as" && i + 1 < argc) {
+            poolConfig.addressSpaceLimit = static_cast<std::size_t>(std::atof(argv[++i]) * 1024 * 1024);
+        } else if (arg == "--task-timeout" && i + 1 < argc) {
+            poolConfig.taskTimeout = std::atof(argv[++i]);
+        } else if (arg == "--cache" && i + 1 < argc) {
+            config.resultCachePath = argv[++i];
+        } else if (arg == "--journal" && i + 1 < argc) {
+            config.journalPath = argv[++i];
+        } else if (arg == "--submission" && i + 1 < argc) {
+            submissionPath = argv[++i];
+        } else if (arg == "--perf") {
+            config.perfCounters = true;
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            arc::core::setLogLevel(arc::core::parseLogLevel(argv[++i]));
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
         } else {
             std::cout << "未知参数: " << arg << std::endl;
             showHelp = true;
@@ -180,11 +609,59 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
+    startTrace(tracePath);
+    
     if (runDemoMode) {
         runDemo();
+        finishTrace(tracePath);
+        return 0;
+    }
+    
+    if (!convertInput.empty()) {
+        try {
+            std::size_t count = arc::io::convertJsonToCorpus(convertInput, convertOutput, solutionsPath, packNibbles);
+            std::cout << "已转换 " << count << " 个任务 -> " << convertOutput << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << colorRed("转换失败: ") << e.what() << std::endl;
+            return 1;
+        }
         return 0;
     }
     
+    if (!shmCreate.empty()) {
+        try {
+            auto store = SharedTaskStore::create(shmCreate, batchPath);
+            std::cout << "已创建共享内存段 " << shmCreate << "，" << store->slotCount() << " 个测试输入" << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << colorRed("创建共享内存段失败: ") << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    
+    if (!shmUnlink.empty()) {
+        try {
+            SharedTaskStore::unlink(shmUnlink);
+        } catch (const std::exception& e) {
+            std::cout << colorRed("删除共享内存段失败: ") << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    
+    if (!remoteSocket.empty()) {
+        if (batchPath.empty()) {
+            std::cout << colorRed("--remote需要--batch指定任务文件") << std::endl;
+            return 1;
+        }
+        return runRemote(remoteSocket, batchPath, config.timeBudget);
+    }
+    
+    if ((!workerAddress.empty() || coordinate) && batchPath.empty()) {
+        std::cout << colorRed("--worker/--coordinator需要--batch指定任务文件") << std::endl;
+        return 1;
+    }
+    
     // 创建求解器
     std::unique_ptr<ARCSolver> solver;
     
@@ -199,6 +676,67 @@ int main(int argc, char* argv[]) {
         solver = SolverFactory::createFromConfig(config);
     }
     
+    if (!batchPath.empty() || !serveSocket.empty() || !shmWorker.empty() || !shmCollect.empty()) {
+        // 预设模式之上保留命令行的并行与预算参数；多线程时逐任务打印会交错，关闭
+        SolverConfig batchConfig = solver->getConfig();
+        batchConfig.batchThreads = config.batchThreads;
+        batchConfig.timeBudget = config.timeBudget;
+        batchConfig.batchDeadline = config.batchDeadline;
+        batchConfig.iterativeDeepening = config.iterativeDeepening;
+        batchConfig.resultCachePath = config.resultCachePath;
+        batchConfig.journalPath = config.journalPath;
+        if (batchConfig.journalPath.empty() && !submissionPath.empty()) {
+            batchConfig.journalPath = submissionPath + ".journal";
+        }
+        batchConfig.perfCounters = config.perfCounters;
+        batchConfig.printTimes = false;
+        batchConfig.printMemory = false;
+        
+        if (!serveSocket.empty()) {
+            SolverDaemon::Config daemonConfig;
+            daemonConfig.socketPath = serveSocket;
+            daemonConfig.workers = config.batchThreads;
+            int status = runDaemon(batchConfig, daemonConfig);
+            finishTrace(tracePath);
+            return status;
+        }
+        
+        if (!shmWorker.empty()) {
+            int status = runSharedWorker(batchConfig, shmWorker);
+            finishTrace(tracePath);
+            return status;
+        }
+        
+        // 与工作进程使用相同的预设和参数，日志的求解器指纹才能对上
+        if (!shmCollect.empty()) {
+            int status = runSharedCollect(batchConfig, shmCollect, reportPath, submissionPath);
+            finishTrace(tracePath);
+            return status;
+        }
+        
+        if (!workerAddress.empty()) {
+            BatchWorker::Config workerConfig;
+            const std::size_t colon = workerAddress.rfind(':');
+            if (colon == std::string::npos) {
+                std::cout << colorRed("--worker需要HOST:PORT") << std::endl;
+                return 1;
+            }
+            workerConfig.host = workerAddress.substr(0, colon);
+            workerConfig.port = std::atoi(workerAddress.c_str() + colon + 1);
+            workerConfig.threads = config.batchThreads;
+            int status = runWorker(batchConfig, workerConfig, batchPath, solutionsPath);
+            finishTrace(tracePath);
+            return status;
+        }
+        solver = SolverFactory::createFromConfig(batchConfig);
+        
+        poolConfig.workers = config.batchThreads;
+        int status = runBatch(*solver, batchPath, solutionsPath, reportPath, submissionPath,
+                              isolate ? &poolConfig : nullptr, coordinate ? &coordinatorConfig : nullptr);
+        finishTrace(tracePath);
+        return status;
+    }
+    
     // 如果没有指定演示模式，运行默认演示
     if (!runDemoMode) {
         std::cout << "\n未指定输入文件，运行默认演示" << std::endl;
@@ -215,5 +753,6 @@ int main(int argc, char* argv[]) {
         printStatistics(stats);
     }
     
+    finishTrace(tracePath);
     return 0;
 } 
\ No newline at end of file
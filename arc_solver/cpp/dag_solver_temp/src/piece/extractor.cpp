@@ -1,6 +1,9 @@
 #include "piece/piece.hpp"
 #include "transform/transform.hpp"
+#include "core/log.hpp"
+#include "core/trace.hpp"
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <unordered_set>
 #include <chrono>
@@ -12,6 +15,34 @@ namespace arc::piece {
 // PieceCollection 实现
 // ============================================================================
 
+namespace {
+
+std::uint64_t nextCollectionGeneration() {
+    static std::atomic<std::uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // namespace
+
+PieceCollection::PieceCollection() : generation_(nextCollectionGeneration()) {}
+
+PieceCollection::PieceCollection(PieceCollection&& other) noexcept
+    : dags(std::move(other.dags)), pieces(std::move(other.pieces)), memory(std::move(other.memory)),
+      generation_(other.generation_) {
+    other.generation_ = nextCollectionGeneration();
+}
+
+PieceCollection& PieceCollection::operator=(PieceCollection&& other) noexcept {
+    if (this != &other) {
+        dags = std::move(other.dags);
+        pieces = std::move(other.pieces);
+        memory = std::move(other.memory);
+        generation_ = other.generation_;
+        other.generation_ = nextCollectionGeneration();
+    }
+    return *this;
+}
+
 arc::core::NodeID PieceCollection::getPieceNodeId(std::size_t pieceIndex, std::size_t dagIndex) const {
     if (pieceIndex >= pieces.size() || dagIndex >= dags.size()) {
         throw std::out_of_range("Invalid piece or DAG index");
@@ -120,6 +151,7 @@ bool PieceExtractor::addPieceCandidate(
             memory.push_back(nodeId);
         }
         depthMemory.push_back(depth);
+        config_.deadline.chargeMemory(nodeIds.size() * sizeof(arc::core::NodeID) + sizeof(std::uint16_t));
     }
     
     // 如果是新的或者找到了更短的路径，加入队列
@@ -278,6 +310,7 @@ PieceCollection PieceExtractor::extractPieces(std::vector<std::unique_ptr<arc::c
         throw std::invalid_argument("DAG vector cannot be empty");
     }
     
+    ARC_TRACE_SPAN(span, "extract_pieces");
     PieceCollection collection;
     collection.dags = std::move(dags);
     
@@ -308,6 +341,11 @@ PieceCollection PieceExtractor::extractPieces(std::vector<std::unique_ptr<arc::c
     
     for (std::uint16_t depth = 0; depth < depthQueues.size() && depth <= config_.maxDepth; ++depth) {
         while (!depthQueues[depth].empty()) {
+            // 任务预算用尽时保留已提取的pieces
+            if (config_.deadline.expired()) {
+                goto extraction_complete;
+            }
+            
             std::uint32_t memoryIndex = depthQueues[depth].front();
             depthQueues[depth].pop();
             
@@ -332,7 +370,7 @@ PieceCollection PieceExtractor::extractPieces(std::vector<std::unique_ptr<arc::c
                 
                 // 检查piece数量限制
                 if (collection.pieces.size() >= config_.maxPieces) {
-                    std::cout << "达到最大piece数量限制: " << config_.maxPieces << std::endl;
+                    ARC_LOG_DEBUG("达到最大piece数量限制: " << config_.maxPieces);
                     goto extraction_complete;
                 }
             }
@@ -381,13 +419,14 @@ PieceCollection PieceExtractor::extractPieces(std::vector<std::unique_ptr<arc::c
     }
     
 extraction_complete:
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-    
-    std::cout << "Piece提取完成:" << std::endl;
-    std::cout << "  - 总节点数: " << collection.getStatistics().totalNodes << std::endl;
-    std::cout << "  - 提取的pieces: " << collection.pieces.size() << std::endl;
-    std::cout << "  - 用时: " << duration.count() << "ms" << std::endl;
+    ARC_TRACE_COUNTER(span, "dags", dagCount);
+    ARC_TRACE_COUNTER(span, "pieces", collection.pieces.size());
+    ARC_TRACE_COUNTER(span, "memory", collection.memory.size());
+    // getStatistics()遍历全部DAG，只在调试级别开启时才调用
+    ARC_LOG_DEBUG("Piece提取完成: 总节点数=" << collection.getStatistics().totalNodes
+                  << ", pieces=" << collection.pieces.size()
+                  << ", 用时=" << std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::high_resolution_clock::now() - startTime).count() << "ms");
     
     // 验证结果
     if (config_.validateConsistency && !collection.validate()) {
@@ -403,8 +442,12 @@ PieceCollection PieceExtractor::buildFromTraining(
     const arc::core::Grid& testInput,
     const std::vector<arc::core::Point>& outputSizes
 ) {
-    // 为每个训练样本和测试输入创建DAG
+    // 为每个训练样本和测试输入创建DAG，共享任务预算
     std::vector<std::unique_ptr<arc::core::DAG>> dags;
+    arc::core::DAG::Config dagConfig;
+    dagConfig.deadline = config_.deadline;
+    dagConfig.maxNodes = config_.maxNodes;
+    dagConfig.maxDepth = config_.maxDepth;
     
     // 初始化变换函数
     arc::transform::initializeTransformFunctions();
@@ -412,28 +455,49 @@ PieceCollection PieceExtractor::buildFromTraining(
     
     // 为每个训练样本创建DAG
     for (const auto& [input, output] : trainingPairs) {
-        auto dag = std::make_unique<arc::core::DAG>();
+        auto dag = std::make_unique<arc::core::DAG>(dagConfig);
         
         // 添加输入作为根节点
         arc::core::State inputState(input, 0);
         dag->addRootNode(inputState);
         
         // 构建DAG
-        dag->buildDAG(transformLib, 3); // 限制深度为3
+        dag->buildDAG(transformLib, config_.maxDepth);
         
         dags.push_back(std::move(dag));
     }
     
     // 为测试输入创建DAG
-    auto testDAG = std::make_unique<arc::core::DAG>();
+    auto testDAG = std::make_unique<arc::core::DAG>(dagConfig);
     arc::core::State testState(testInput, 0);
     testDAG->addRootNode(testState);
-    testDAG->buildDAG(transformLib, 3);
+    testDAG->buildDAG(transformLib, config_.maxDepth);
     dags.push_back(std::move(testDAG));
     
     return extractPieces(std::move(dags));
 }
 
+bool PieceExtractor::deepen(PieceCollection& collection, std::uint16_t depth) {
+    bool grew = false;
+    for (auto& dag : collection.dags) {
+        dag->setDeadline(config_.deadline);
+        grew = dag->extendDepth(depth) || grew;
+    }
+    if (!grew) {
+        return false;
+    }
+    
+    // piece提取依赖全部DAG的节点对齐，新节点可能出现在任意层，整体重新提取
+    // 旧的piece记忆随之释放，先归还它的记账，避免重新提取时重复计入
+    // （DAG只对新增节点记账，extendDepth不会重复计入）
+    const std::size_t dagCount = collection.dags.size();
+    config_.deadline.releaseMemory(collection.memory.size() * sizeof(arc::core::NodeID) +
+                                   collection.memory.size() / dagCount * sizeof(std::uint16_t));
+    config_.maxDepth = std::max(config_.maxDepth, depth);
+    collection = extractPieces(std::move(collection.dags));
+    return true;
+}
+
 // ============================================================================
 // 辅助函数实现
 // ============================================================================
@@ -0,0 +1,317 @@
+#include "process_pool.hpp"
+#include "batch_journal.hpp"
+#include "core/log.hpp"
+#include "core/parallel.hpp"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace arc::solver {
+
+namespace {
+
+// ============================================================================
+// 管道读写（结果负载为encodeTaskResult的输出，见batch_journal.hpp）
+// ============================================================================
+
+bool readAll(int fd, void* data, std::size_t size) {
+    auto* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::read(fd, bytes, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        bytes += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool writeAll(int fd, const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::write(fd, bytes, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        bytes += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// 工作进程主循环，不返回
+[[noreturn]] void runWorker(int taskFd, int resultFd, const SolverConfig& config,
+                            const std::vector<ARCTask>& tasks, std::size_t addressSpaceLimit) {
+    if (addressSpaceLimit > 0) {
+        struct rlimit limit;
+        limit.rlim_cur = addressSpaceLimit;
+        limit.rlim_max = addressSpaceLimit;
+        ::setrlimit(RLIMIT_AS, &limit);
+    }
+
+    int status = 0;
+    {
+        // 变换函数库已在父进程初始化，这里只构造本进程的求解组件
+        ARCSolver solver(config);
+        std::uint32_t index = 0;
+        while (readAll(taskFd, &index, sizeof(index))) {
+            std::string payload;
+            try {
+                payload = encodeTaskResult(tasks[index], solver.solve(tasks[index]));
+            } catch (const std::exception& e) {
+                // RLIMIT_AS下分配失败等，让父进程记为失败
+                ARC_LOG_ERROR("工作进程求解任务 " << tasks[index].taskId << " 失败: " << e.what());
+                status = 2;
+                break;
+            }
+            std::uint32_t header[2] = {index, static_cast<std::uint32_t>(payload.size())};
+            if (!writeAll(resultFd, header, sizeof(header)) || !writeAll(resultFd, payload.data(), payload.size())) {
+                status = 1;
+                break;
+            }
+        }
+    }
+    arc::core::flushLog();
+    // 跳过父进程注册的atexit和静态析构
+    ::_exit(status);
+}
+
+std::string describeExit(int status) {
+    if (WIFSIGNALED(status)) {
+        return std::string("被信号终止: ") + ::strsignal(WTERMSIG(status));
+    }
+    if (WIFEXITED(status)) {
+        return "退出码 " + std::to_string(WEXITSTATUS(status));
+    }
+    return "未知状态";
+}
+
+} // namespace
+
+std::size_t processResidentBytes(pid_t pid) {
+    std::ifstream statm("/proc/" + std::to_string(pid) + "/statm");
+    std::size_t totalPages = 0;
+    std::size_t residentPages = 0;
+    if (!(statm >> totalPages >> residentPages)) {
+        return 0;
+    }
+    return residentPages * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+// ============================================================================
+// ProcessPool
+// ============================================================================
+
+ProcessPool::ProcessPool(const Config& config) : config_(config) {}
+
+void ProcessPool::spawn(std::vector<Worker>& workers, std::size_t slot, const SolverConfig& solverConfig,
+                        const std::vector<ARCTask>& tasks) {
+    int taskPipe[2];
+    int resultPipe[2];
+    if (::pipe(taskPipe) != 0) {
+        throw std::runtime_error("无法创建任务管道");
+    }
+    if (::pipe(resultPipe) != 0) {
+        ::close(taskPipe[0]);
+        ::close(taskPipe[1]);
+        throw std::runtime_error("无法创建结果管道");
+    }
+
+    // 避免缓冲区内容在子进程中被重复输出
+    arc::core::flushLog();
+    std::cout.flush();
+
+    pid_t pid = ::fork();
+    if (pid < 0) {
+        for (int fd : {taskPipe[0], taskPipe[1], resultPipe[0], resultPipe[1]}) ::close(fd);
+        throw std::runtime_error("fork失败");
+    }
+
+    if (pid == 0) {
+        ::close(taskPipe[1]);
+        ::close(resultPipe[0]);
+        // 兄弟进程的管道端必须关闭，否则父进程关闭任务管道后它们收不到EOF
+        for (const Worker& other : workers) {
+            if (other.taskFd >= 0) ::close(other.taskFd);
+            if (other.resultFd >= 0) ::close(other.resultFd);
+        }
+        runWorker(taskPipe[0], resultPipe[1], solverConfig, tasks, config_.addressSpaceLimit);
+    }
+
+    ::close(taskPipe[0]);
+    ::close(resultPipe[1]);
+    workers[slot] = Worker{};
+    workers[slot].pid = pid;
+    workers[slot].taskFd = taskPipe[1];
+    workers[slot].resultFd = resultPipe[0];
+}
+
+std::vector<SolveResult> ProcessPool::run(ARCSolver& solver, const std::vector<ARCTask>& tasks,
+                                         const TaskDoneCallback& onTaskDone) {
+    std::vector<SolveResult> results(tasks.size());
+    failures_.clear();
+    restarts_ = 0;
+    if (tasks.empty()) {
+        return results;
+    }
+
+    SolverConfig workerConfig = solver.getConfig();
+    workerConfig.batchThreads = 1;
+    workerConfig.scoringThreads = 1;
+
+    const std::size_t numWorkers = arc::core::resolveThreadCount(config_.workers, tasks.size());
+    const auto start = std::chrono::steady_clock::now();
+    auto now = [&]() { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+
+    // 子进程已退出时写任务管道返回EPIPE而不是杀死父进程
+    auto previousSigpipe = std::signal(SIGPIPE, SIG_IGN);
+
+    std::vector<Worker> workers(numWorkers);
+    std::size_t nextTask = 0;
+    std::size_t finished = 0;
+    std::size_t idleDeaths = 0;
+
+    // 回收一个已退出（或刚被杀死）的工作进程，记录其任务失败并按需重启
+    auto reap = [&](std::size_t slot) {
+        Worker& worker = workers[slot];
+        int status = 0;
+        ::waitpid(worker.pid, &status, 0);
+        ::close(worker.taskFd);
+        ::close(worker.resultFd);
+
+        const std::string reason = worker.killReason.empty() ? describeExit(status) : worker.killReason;
+        if (worker.task >= 0) {
+            const std::size_t index = static_cast<std::size_t>(worker.task);
+            ARC_LOG_WARN("任务 " << tasks[index].taskId << " 所在工作进程终止(" << reason << ")，记为失败");
+            SolveResult failed;
+            failed.solvingTime = now() - worker.taskStart;
+            results[index] = failed;
+            solver.recordResult(failed);
+            failures_.push_back({index, reason});
+            // 不回调onTaskDone：失败的任务不应写进日志，重跑时需要重新求解
+            ++finished;
+        } else if (++idleDeaths > 3 * numWorkers) {
+            throw std::runtime_error("工作进程反复在空闲时退出: " + reason);
+        }
+
+        workers[slot] = Worker{};
+        if (nextTask < tasks.size()) {
+            spawn(workers, slot, workerConfig, tasks);
+            ++restarts_;
+        }
+    };
+
+    auto kill = [&](std::size_t slot, const std::string& reason) {
+        workers[slot].killReason = reason;
+        ::kill(workers[slot].pid, SIGKILL);
+        reap(slot);
+    };
+
+    try {
+        for (std::size_t slot = 0; slot < numWorkers; ++slot) {
+            spawn(workers, slot, workerConfig, tasks);
+        }
+
+        while (finished < tasks.size()) {
+            // 分发
+            for (std::size_t slot = 0; slot < numWorkers; ++slot) {
+                Worker& worker = workers[slot];
+                if (worker.pid < 0 || worker.task >= 0 || nextTask >= tasks.size()) continue;
+                std::uint32_t index = static_cast<std::uint32_t>(nextTask);
+                if (writeAll(worker.taskFd, &index, sizeof(index))) {
+                    worker.task = static_cast<long>(nextTask++);
+                    worker.taskStart = now();
+                } else {
+                    reap(slot);   // 尚未领取任务就已退出，任务留在队列中
+                }
+            }
+
+            std::vector<pollfd> fds;
+            std::vector<std::size_t> slots;
+            for (std::size_t slot = 0; slot < numWorkers; ++slot) {
+                if (workers[slot].pid < 0) continue;
+                fds.push_back({workers[slot].resultFd, POLLIN, 0});
+                slots.push_back(slot);
+            }
+            if (fds.empty()) {
+                break;
+            }
+            ::poll(fds.data(), fds.size(), config_.pollIntervalMs);
+
+            // 收取结果；EOF说明进程已退出
+            for (std::size_t i = 0; i < fds.size(); ++i) {
+                if ((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) == 0) continue;
+                const std::size_t slot = slots[i];
+                Worker& worker = workers[slot];
+
+                std::uint32_t header[2];
+                std::string payload;
+                std::string taskId;
+                std::size_t testIndex = 0;
+                SolveResult result;
+                bool ok = readAll(worker.resultFd, header, sizeof(header));
+                if (ok) {
+                    payload.resize(header[1]);
+                    ok = readAll(worker.resultFd, payload.data(), payload.size()) &&
+                         static_cast<long>(header[0]) == worker.task &&
+                         decodeTaskResult(payload.data(), payload.size(), taskId, testIndex, result) &&
+                         taskId == tasks[header[0]].taskId && testIndex == tasks[header[0]].testIndex;
+                }
+                if (!ok) {
+                    reap(slot);
+                    continue;
+                }
+
+                results[header[0]] = std::move(result);
+                solver.recordResult(results[header[0]]);
+                if (onTaskDone) {
+                    onTaskDone(header[0], results[header[0]]);
+                }
+                worker.task = -1;
+                ++finished;
+            }
+
+            // 内存和超时检查
+            const double t = now();
+            for (std::size_t slot = 0; slot < numWorkers; ++slot) {
+                const Worker& worker = workers[slot];
+                if (worker.pid < 0 || worker.task < 0) continue;
+                if (config_.rssLimit > 0 && processResidentBytes(worker.pid) > config_.rssLimit) {
+                    kill(slot, "常驻内存超过上限");
+                } else if (config_.taskTimeout > 0.0 && t - worker.taskStart > config_.taskTimeout) {
+                    kill(slot, "单任务超时");
+                }
+            }
+        }
+    } catch (...) {
+        for (Worker& worker : workers) {
+            if (worker.pid < 0) continue;
+            ::kill(worker.pid, SIGKILL);
+            ::waitpid(worker.pid, nullptr, 0);
+            ::close(worker.taskFd);
+            ::close(worker.resultFd);
+        }
+        std::signal(SIGPIPE, previousSigpipe);
+        throw;
+    }
+
+    // 关闭任务管道，工作进程读到EOF后退出
+    for (Worker& worker : workers) {
+        if (worker.pid < 0) continue;
+        ::close(worker.taskFd);
+        ::close(worker.resultFd);
+        ::waitpid(worker.pid, nullptr, 0);
+    }
+    std::signal(SIGPIPE, previousSigpipe);
+    return results;
+}
+
+} // namespace arc::solver
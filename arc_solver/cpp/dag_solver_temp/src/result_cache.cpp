@@ -0,0 +1,424 @@
+#include "result_cache.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace arc::solver {
+
+namespace {
+
+// ============================================================================
+// 哈希
+// ============================================================================
+
+constexpr std::uint64_t FNV_OFFSET = 1469598103934665603ULL;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t hash = FNV_OFFSET) {
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// splitmix64的终结函数，用于派生与FNV独立的第二个哈希
+std::uint64_t mix64(std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+std::uint64_t checkHash(const std::string& bytes) {
+    std::uint64_t hash = 0x9e3779b97f4a7c15ULL;
+    for (unsigned char c : bytes) {
+        hash = mix64(hash + c);
+    }
+    return mix64(hash ^ bytes.size());
+}
+
+template <typename T>
+void hashValue(std::uint64_t& hash, const T& value) {
+    hash = fnv1a(&value, sizeof(value), hash);
+}
+
+// rigid变换的逆：旋转90与270互逆，其余自逆
+constexpr int INVERSE_RIGID[8] = {0, 3, 2, 1, 4, 5, 6, 7};
+
+// ============================================================================
+// 文件格式
+// ============================================================================
+
+constexpr char CACHE_MAGIC[8] = {'A', 'R', 'C', 'R', 'C', 'A', 'C', '1'};
+constexpr std::uint32_t CACHE_VERSION = 1;
+constexpr std::uint32_t RECORD_MAGIC = 0x44524352;   // "RCRD"
+
+struct CacheFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+
+struct CacheRecordHeader {
+    std::uint32_t magic;
+    std::uint32_t payloadBytes;
+    std::uint64_t taskHash;
+    std::uint64_t taskCheck;
+    std::uint64_t fingerprint;
+    std::uint64_t checksum;        // 负载的FNV-1a
+};
+
+struct CachePayloadHeader {
+    float bestScore;
+    std::int32_t searchDepth;
+    std::uint64_t totalPieces;
+    std::uint64_t totalCandidates;
+    double solvingTime;
+    std::uint32_t answerCount;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(CacheFileHeader) == 16, "CacheFileHeader布局必须固定");
+static_assert(sizeof(CacheRecordHeader) == 40, "CacheRecordHeader布局必须固定");
+static_assert(sizeof(CachePayloadHeader) == 40, "CachePayloadHeader布局必须固定");
+
+inline std::uint64_t indexKey(std::uint64_t taskHash, std::uint64_t fingerprint) {
+    return taskHash ^ mix64(fingerprint);
+}
+
+template <typename T>
+void appendRaw(std::string& buffer, const T& value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeAll(int fd, const std::string& buffer) {
+    std::size_t written = 0;
+    while (written < buffer.size()) {
+        ssize_t n = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            throw std::runtime_error("写入结果缓存失败");
+        }
+        written += static_cast<std::size_t>(n);
+    }
+}
+
+// 持有期间对整个文件加flock锁，默认排他
+class FileLock {
+public:
+    explicit FileLock(int fd, int operation = LOCK_EX) : fd_(fd) { ::flock(fd_, operation); }
+    ~FileLock() { ::flock(fd_, LOCK_UN); }
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+private:
+    int fd_;
+};
+
+} // namespace
+
+// ============================================================================
+// 规范化
+// ============================================================================
+
+CanonicalTask canonicalizeTask(const ARCTask& task) {
+    std::vector<const arc::core::Grid*> grids;
+    for (const auto& example : task.trainingExamples) {
+        grids.push_back(&example.input);
+        grids.push_back(&example.output);
+    }
+    grids.push_back(&task.testInput);
+
+    CanonicalTask best;
+    std::array<int, 256> bestMap{};
+    for (int t = 0; t < 8; ++t) {
+        std::array<int, 256> map;
+        map.fill(-1);
+        map[0] = 0;
+        int nextColor = 1;
+
+        std::string bytes;
+        appendRaw(bytes, static_cast<std::uint32_t>(task.trainingExamples.size()));
+        for (const arc::core::Grid* grid : grids) {
+            arc::core::Grid image = arc::transform::rigid(*grid, t);
+            appendRaw(bytes, static_cast<std::uint16_t>(image.width));
+            appendRaw(bytes, static_cast<std::uint16_t>(image.height));
+            for (std::uint8_t pixel : image.pixels) {
+                if (map[pixel] < 0) map[pixel] = nextColor++;
+                bytes.push_back(static_cast<char>(map[pixel]));
+            }
+        }
+
+        if (t == 0 || bytes < best.bytes) {
+            best.bytes = std::move(bytes);
+            best.transform = t;
+            bestMap = map;
+        }
+    }
+
+    // 未出现的颜色按升序补齐剩余编号，使colorMap成为完整置换
+    std::array<bool, 256> used{};
+    for (int c = 0; c < 256; ++c) {
+        if (bestMap[c] >= 0) used[bestMap[c]] = true;
+    }
+    int freeColor = 0;
+    for (int c = 0; c < 256; ++c) {
+        if (bestMap[c] < 0) {
+            while (used[freeColor]) ++freeColor;
+            bestMap[c] = freeColor;
+            used[freeColor] = true;
+        }
+        best.colorMap[c] = static_cast<std::uint8_t>(bestMap[c]);
+    }
+
+    best.hash = fnv1a(best.bytes.data(), best.bytes.size());
+    best.check = checkHash(best.bytes);
+    return best;
+}
+
+arc::core::Grid toCanonical(const arc::core::Grid& grid, const CanonicalTask& key) {
+    arc::core::Grid result = arc::transform::rigid(grid, key.transform);
+    for (std::uint8_t& pixel : result.pixels) {
+        pixel = key.colorMap[pixel];
+    }
+    return result;
+}
+
+arc::core::Grid fromCanonical(const arc::core::Grid& grid, const CanonicalTask& key) {
+    std::array<std::uint8_t, 256> inverse{};
+    for (int c = 0; c < 256; ++c) {
+        inverse[key.colorMap[c]] = static_cast<std::uint8_t>(c);
+    }
+    arc::core::Grid result = grid;
+    for (std::uint8_t& pixel : result.pixels) {
+        pixel = inverse[pixel];
+    }
+    return arc::transform::rigid(result, INVERSE_RIGID[key.transform]);
+}
+
+std::uint64_t solverFingerprint(const SolverConfig& config) {
+    std::uint64_t hash = FNV_OFFSET;
+    hashValue(hash, CACHE_VERSION);
+    hashValue(hash, config.maxDepth);
+    hashValue(hash, config.maxSide);
+    hashValue(hash, config.maxArea);
+    hashValue(hash, config.maxPixels);
+    hashValue(hash, config.maxNodes);   // 预设上限；调度逐任务分配的nodeBudget不计入
+    hashValue(hash, config.iterativeDeepening);
+    hashValue(hash, config.initialDepth);
+    hashValue(hash, config.maxPieces);
+    hashValue(hash, config.enablePieceOptimization);
+    hashValue(hash, config.maxCandidates);
+    hashValue(hash, config.maxIterations);
+    hashValue(hash, config.enableGreedyFill);
+    hashValue(hash, config.complexityPenalty);
+    hashValue(hash, config.maxAnswers);
+
+    const auto& lib = arc::transform::TransformLibrary::instance();
+    hashValue(hash, lib.getFunctionCount());
+    for (std::size_t id = 0; id < lib.getFunctionCount(); ++id) {
+        const auto& info = lib.getFunction(static_cast<std::uint16_t>(id));
+        hash = fnv1a(info.name.data(), info.name.size(), hash);
+        hashValue(hash, info.cost);
+        hashValue(hash, info.isListed);
+    }
+    return hash;
+}
+
+// ============================================================================
+// ResultCache
+// ============================================================================
+
+ResultCache::ResultCache(const std::string& path) : path_(path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh();
+}
+
+bool ResultCache::refresh() {
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return true;   // 尚未创建
+    }
+    try {
+        FileLock fileLock(fd, LOCK_SH);
+        const bool complete = refreshLocked();
+        ::close(fd);
+        return complete;
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+}
+
+bool ResultCache::refreshLocked() {
+    struct stat st;
+    if (::stat(path_.c_str(), &st) != 0) {
+        return true;   // 尚未创建
+    }
+    const std::size_t fileSize = static_cast<std::size_t>(st.st_size);
+    if (fileSize != file_.size()) {
+        file_ = arc::io::MappedFile(path_);
+    }
+    if (file_.size() < sizeof(CacheFileHeader)) {
+        return file_.empty();
+    }
+
+    if (indexedBytes_ == 0) {
+        CacheFileHeader header;
+        std::memcpy(&header, file_.data(), sizeof(header));
+        if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION) {
+            throw std::runtime_error("不是结果缓存文件或版本不兼容: " + path_);
+        }
+        indexedBytes_ = sizeof(CacheFileHeader);
+    }
+
+    // 逐条索引；残缺或正在写入的记录之后的部分留到下次
+    while (indexedBytes_ + sizeof(CacheRecordHeader) <= file_.size()) {
+        CacheRecordHeader record;
+        std::memcpy(&record, file_.data() + indexedBytes_, sizeof(record));
+        const std::size_t end = indexedBytes_ + sizeof(record) + record.payloadBytes;
+        if (record.magic != RECORD_MAGIC || end > file_.size() ||
+            fnv1a(file_.data() + indexedBytes_ + sizeof(record), record.payloadBytes) != record.checksum) {
+            break;
+        }
+        index_.emplace(indexKey(record.taskHash, record.fingerprint), indexedBytes_);
+        indexedBytes_ = end;
+    }
+    return indexedBytes_ == file_.size();
+}
+
+bool ResultCache::readRecord(std::size_t offset, const CanonicalTask& key, std::uint64_t fingerprint,
+                             CachedResult& result) const {
+    CacheRecordHeader record;
+    std::memcpy(&record, file_.data() + offset, sizeof(record));
+    if (record.taskHash != key.hash || record.taskCheck != key.check || record.fingerprint != fingerprint) {
+        return false;
+    }
+
+    const char* cursor = file_.data() + offset + sizeof(record);
+    const char* end = cursor + record.payloadBytes;
+    CachePayloadHeader payload;
+    if (cursor + sizeof(payload) > end) return false;
+    std::memcpy(&payload, cursor, sizeof(payload));
+    cursor += sizeof(payload);
+
+    CachedResult loaded;
+    loaded.bestScore = payload.bestScore;
+    loaded.searchDepth = payload.searchDepth;
+    loaded.totalPieces = payload.totalPieces;
+    loaded.totalCandidates = payload.totalCandidates;
+    loaded.solvingTime = payload.solvingTime;
+    for (std::uint32_t i = 0; i < payload.answerCount; ++i) {
+        std::uint16_t size[2];
+        if (cursor + sizeof(size) > end) return false;
+        std::memcpy(size, cursor, sizeof(size));
+        cursor += sizeof(size);
+
+        arc::core::Grid grid(size[0], size[1]);
+        if (cursor + grid.pixels.size() > end) return false;
+        std::memcpy(grid.pixels.data(), cursor, grid.pixels.size());
+        cursor += grid.pixels.size();
+        loaded.answers.push_back(std::move(grid));
+    }
+
+    result = std::move(loaded);
+    return true;
+}
+
+bool ResultCache::lookup(const CanonicalTask& key, std::uint64_t fingerprint, CachedResult& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::uint64_t k = indexKey(key.hash, fingerprint);
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        auto [begin, end] = index_.equal_range(k);
+        for (auto it = begin; it != end; ++it) {
+            if (readRecord(it->second, key, fingerprint, result)) {
+                return true;
+            }
+        }
+        // 未命中时看看其他工作者是否已写入
+        if (attempt == 0) refresh();
+    }
+    return false;
+}
+
+void ResultCache::store(const CanonicalTask& key, std::uint64_t fingerprint, const CachedResult& result) {
+    std::string payload;
+    CachePayloadHeader payloadHeader{};
+    payloadHeader.bestScore = result.bestScore;
+    payloadHeader.searchDepth = result.searchDepth;
+    payloadHeader.totalPieces = result.totalPieces;
+    payloadHeader.totalCandidates = result.totalCandidates;
+    payloadHeader.solvingTime = result.solvingTime;
+    payloadHeader.answerCount = static_cast<std::uint32_t>(result.answers.size());
+    appendRaw(payload, payloadHeader);
+    for (const auto& answer : result.answers) {
+        appendRaw(payload, static_cast<std::uint16_t>(answer.width));
+        appendRaw(payload, static_cast<std::uint16_t>(answer.height));
+        payload.append(reinterpret_cast<const char*>(answer.pixels.data()), answer.pixels.size());
+    }
+
+    CacheRecordHeader record{};
+    record.magic = RECORD_MAGIC;
+    record.payloadBytes = static_cast<std::uint32_t>(payload.size());
+    record.taskHash = key.hash;
+    record.taskCheck = key.check;
+    record.fingerprint = fingerprint;
+    record.checksum = fnv1a(payload.data(), payload.size());
+
+    std::string buffer;
+    appendRaw(buffer, record);
+    buffer += payload;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    int fd = ::open(path_.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("无法打开结果缓存: " + path_);
+    }
+
+    try {
+        FileLock fileLock(fd);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            throw std::runtime_error("无法读取结果缓存信息: " + path_);
+        }
+        if (st.st_size != 0 && !refreshLocked()) {
+            // 持有排他锁时没有其他写入者，无效尾部只可能是崩溃留下的残缺记录
+            if (::ftruncate(fd, static_cast<off_t>(indexedBytes_)) != 0) {
+                throw std::runtime_error("无法截断结果缓存: " + path_);
+            }
+        }
+        if (indexedBytes_ == 0) {
+            CacheFileHeader header{};
+            std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+            header.version = CACHE_VERSION;
+            std::string headerBytes;
+            appendRaw(headerBytes, header);
+            writeAll(fd, headerBytes);
+        }
+
+        writeAll(fd, buffer);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+std::size_t ResultCache::entryCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh();
+    return index_.size();
+}
+
+} // namespace arc::solver
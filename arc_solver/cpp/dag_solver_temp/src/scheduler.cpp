@@ -0,0 +1,129 @@
+#include "scheduler.hpp"
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <numeric>
+
+namespace arc::solver {
+
+// ============================================================================
+// 耗时预测
+// ============================================================================
+
+namespace {
+
+void addGrid(const arc::core::Grid& grid, TaskFeatures& features, std::bitset<256>& palette) {
+    features.pixels += static_cast<double>(grid.pixels.size());
+    features.maxSide = std::max({features.maxSide, grid.width, grid.height});
+    for (std::uint8_t color : grid.pixels) {
+        palette.set(color);
+    }
+}
+
+} // namespace
+
+TaskFeatures extractTaskFeatures(const ARCTask& task) {
+    TaskFeatures features;
+    std::bitset<256> palette;
+    for (const auto& example : task.trainingExamples) {
+        addGrid(example.input, features, palette);
+        addGrid(example.output, features, palette);
+    }
+    addGrid(task.testInput, features, palette);
+    features.trainPairs = static_cast<int>(task.trainingExamples.size());
+    features.paletteSize = static_cast<int>(palette.count());
+    return features;
+}
+
+double predictTaskCost(const TaskFeatures& features) {
+    // 每个DAG的规模约与像素数成正比，DAG个数为训练对数+1；
+    // 颜色相关的变换（filterCol、colShape等）按颜色展开，颜色多时分支更多
+    const double dags = static_cast<double>(features.trainPairs + 1);
+    const double colorFactor = 1.0 + 0.15 * std::max(0, features.paletteSize - 2);
+    return std::max(1.0, features.pixels) * dags * colorFactor;
+}
+
+double predictTaskCost(const ARCTask& task) {
+    return predictTaskCost(extractTaskFeatures(task));
+}
+
+// ============================================================================
+// BatchScheduler
+// ============================================================================
+
+BatchScheduler::BatchScheduler(const std::vector<ARCTask>& tasks, std::size_t workers, const Config& config)
+    : config_(config),
+      workers_(std::max<std::size_t>(1, workers)),
+      start_(std::chrono::steady_clock::now()),
+      costs_(tasks.size()),
+      pixelsPerDAG_(tasks.size()),
+      order_(tasks.size()),
+      running_(tasks.size()) {
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        TaskFeatures features = extractTaskFeatures(tasks[i]);
+        costs_[i] = predictTaskCost(features);
+        pixelsPerDAG_[i] = std::max(1.0, features.pixels / (features.trainPairs + 1));
+        remainingCost_ += costs_[i];
+    }
+
+    std::iota(order_.begin(), order_.end(), std::size_t{0});
+    std::stable_sort(order_.begin(), order_.end(), [&](std::size_t a, std::size_t b) {
+        return costs_[a] > costs_[b];
+    });
+}
+
+double BatchScheduler::elapsed() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+}
+
+bool BatchScheduler::next(Assignment& assignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (nextSlot_ >= order_.size()) {
+        return false;
+    }
+
+    const std::size_t index = order_[nextSlot_++];
+    const double now = elapsed();
+    const double wallRemaining = config_.totalBudget * (1.0 - config_.reserveFraction) - now;
+
+    assignment = Assignment{};
+    assignment.index = index;
+    assignment.predictedCost = costs_[index];
+
+    // 正在运行的任务还可能用掉的时间
+    double committed = 0.0;
+    for (const Running& r : running_) {
+        if (r.active) {
+            committed += std::max(0.0, r.budget - (now - r.start));
+        }
+    }
+
+    const double capacity = static_cast<double>(workers_) * wallRemaining - committed;
+    const double share = remainingCost_ > 0.0 ? capacity * costs_[index] / remainingCost_ : 0.0;
+    remainingCost_ = std::max(0.0, remainingCost_ - costs_[index]);
+
+    if (wallRemaining < config_.minTaskBudget) {
+        assignment.skipped = true;
+        return true;
+    }
+
+    // 单个任务不可能用到超过剩余墙钟时间
+    assignment.timeBudget = std::clamp(share, config_.minTaskBudget, wallRemaining);
+
+    const double nodes = config_.nodeRate * assignment.timeBudget / pixelsPerDAG_[index];
+    assignment.nodeBudget = std::clamp(
+        static_cast<std::size_t>(std::min(nodes, static_cast<double>(config_.maxNodes))),
+        std::min(config_.minNodes, config_.maxNodes), config_.maxNodes);
+
+    running_[index].start = now;
+    running_[index].budget = assignment.timeBudget;
+    running_[index].active = true;
+    return true;
+}
+
+void BatchScheduler::complete(const Assignment& assignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_[assignment.index].active = false;
+}
+
+} // namespace arc::solver
@@ -0,0 +1,179 @@
+#include "scoring/kernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ARC_SCORING_SSE2 1
+#endif
+
+namespace arc::scoring {
+
+namespace {
+
+#ifdef ARC_SCORING_SSE2
+// 每种颜色一个字节累加器，最多累加255次后用sad归约到32位计数
+class HistogramAccumulator {
+public:
+    explicit HistogramAccumulator(std::uint32_t* histogram) : histogram_(histogram) {
+        for (auto& acc : acc_) acc = _mm_setzero_si128();
+    }
+    ~HistogramAccumulator() { flush(); }
+
+    void add(__m128i pixels) {
+        for (int c = 0; c < NUM_COLORS; ++c) {
+            // cmpeq得到0xFF(-1)，相减即计数加1
+            acc_[c] = _mm_sub_epi8(acc_[c], _mm_cmpeq_epi8(pixels, _mm_set1_epi8(static_cast<char>(c))));
+        }
+        if (++pending_ == 255) flush();
+    }
+
+    void flush() {
+        if (pending_ == 0) return;
+        const __m128i zero = _mm_setzero_si128();
+        for (int c = 0; c < NUM_COLORS; ++c) {
+            __m128i sums = _mm_sad_epu8(acc_[c], zero);
+            histogram_[c] += static_cast<std::uint32_t>(_mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4));
+            acc_[c] = zero;
+        }
+        pending_ = 0;
+    }
+
+private:
+    __m128i acc_[NUM_COLORS];
+    std::uint32_t* histogram_;
+    int pending_ = 0;
+};
+
+inline int popcount16(int mask) { return __builtin_popcount(static_cast<unsigned>(mask) & 0xFFFFu); }
+#endif
+
+inline void histogramTail(const std::uint8_t* pixels, std::size_t begin, std::size_t end,
+                          std::uint32_t* histogram) {
+    for (std::size_t i = begin; i < end; ++i) {
+        if (pixels[i] < NUM_COLORS) histogram[pixels[i]]++;
+    }
+}
+
+} // namespace
+
+std::size_t countEqualPixels(const std::uint8_t* a, const std::uint8_t* b, std::size_t count) {
+    std::size_t equal = 0;
+    std::size_t i = 0;
+
+#ifdef ARC_SCORING_SSE2
+    for (; i + 16 <= count; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        equal += popcount16(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        equal += (a[i] == b[i]);
+    }
+    return equal;
+}
+
+void colorHistogram(const std::uint8_t* pixels, std::size_t count, std::uint32_t histogram[NUM_COLORS]) {
+    std::fill(histogram, histogram + NUM_COLORS, 0u);
+    std::size_t i = 0;
+
+#ifdef ARC_SCORING_SSE2
+    {
+        HistogramAccumulator acc(histogram);
+        for (; i + 16 <= count; i += 16) {
+            acc.add(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i)));
+        }
+    }
+#endif
+
+    histogramTail(pixels, i, count, histogram);
+}
+
+GridPairMetrics computeGridPairMetrics(const arc::core::Grid& predicted, const arc::core::Grid& target) {
+    GridPairMetrics metrics;
+    metrics.sameSize = predicted.width == target.width && predicted.height == target.height;
+    metrics.predictedPixels = predicted.pixels.size();
+    metrics.targetPixels = target.pixels.size();
+
+    if (!metrics.sameSize) {
+        // 尺寸不同时只有颜色分布有意义
+        colorHistogram(predicted.pixels.data(), metrics.predictedPixels, metrics.predictedHistogram);
+        colorHistogram(target.pixels.data(), metrics.targetPixels, metrics.targetHistogram);
+        return metrics;
+    }
+
+    const std::uint8_t* a = predicted.pixels.data();
+    const std::uint8_t* b = target.pixels.data();
+    const std::size_t count = metrics.predictedPixels;
+    std::size_t i = 0;
+
+#ifdef ARC_SCORING_SSE2
+    {
+        const __m128i zero = _mm_setzero_si128();
+        HistogramAccumulator predAcc(metrics.predictedHistogram);
+        HistogramAccumulator targAcc(metrics.targetHistogram);
+
+        for (; i + 16 <= count; i += 16) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+
+            int equalMask = _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+            int zeroA = _mm_movemask_epi8(_mm_cmpeq_epi8(va, zero));
+            int zeroB = _mm_movemask_epi8(_mm_cmpeq_epi8(vb, zero));
+
+            metrics.matchingPixels += popcount16(equalMask);
+            metrics.targetNonZero += popcount16(~zeroB);
+            metrics.sharedNonZero += popcount16(~(zeroA | zeroB));
+
+            predAcc.add(va);
+            targAcc.add(vb);
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        metrics.matchingPixels += (a[i] == b[i]);
+        metrics.targetNonZero += (b[i] != 0);
+        metrics.sharedNonZero += (a[i] != 0 && b[i] != 0);
+        if (a[i] < NUM_COLORS) metrics.predictedHistogram[a[i]]++;
+        if (b[i] < NUM_COLORS) metrics.targetHistogram[b[i]]++;
+    }
+
+    return metrics;
+}
+
+GridPairScores scoresFromMetrics(const GridPairMetrics& metrics,
+                                 const arc::core::Grid& predicted,
+                                 const arc::core::Grid& target) {
+    GridPairScores scores;
+
+    if (metrics.sameSize) {
+        scores.pixel = metrics.predictedPixels == 0 ? 1.0f :
+            static_cast<float>(metrics.matchingPixels) / metrics.predictedPixels;
+        scores.shape = metrics.targetNonZero == 0 ? 1.0f :
+            static_cast<float>(metrics.sharedNonZero) / metrics.targetNonZero;
+        scores.size = 1.0f;
+    } else {
+        float widthRatio = std::min(predicted.width, target.width) /
+                          static_cast<float>(std::max(predicted.width, target.width));
+        float heightRatio = std::min(predicted.height, target.height) /
+                           static_cast<float>(std::max(predicted.height, target.height));
+        scores.size = (widthRatio + heightRatio) / 2.0f;
+    }
+
+    float totalPred = static_cast<float>(metrics.predictedPixels);
+    float totalTarg = static_cast<float>(metrics.targetPixels);
+    float similarity = 0.0f;
+    for (int color = 0; color < NUM_COLORS; ++color) {
+        float predRatio = totalPred > 0 ? metrics.predictedHistogram[color] / totalPred : 0.0f;
+        float targRatio = totalTarg > 0 ? metrics.targetHistogram[color] / totalTarg : 0.0f;
+        similarity += 1.0f - std::abs(predRatio - targRatio);
+    }
+    scores.color = similarity / NUM_COLORS;
+
+    return scores;
+}
+
+} // namespace arc::scoring
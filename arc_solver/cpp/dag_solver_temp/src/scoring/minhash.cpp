@@ -0,0 +1,104 @@
+#include "scoring/minhash.hpp"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace arc::scoring {
+
+namespace {
+
+// splitmix64 - 用不同种子得到一族独立的哈希函数
+inline std::uint64_t mix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+} // namespace
+
+MinHashLSH::MinHashLSH(const Config& config) : config_(config) {
+    config_.bands = std::max(1, config_.bands);
+    config_.rowsPerBand = std::max(1, config_.rowsPerBand);
+}
+
+std::size_t MinHashLSH::add(const std::vector<std::uint64_t>& fingerprints) {
+    const int hashes = numHashes();
+    std::size_t offset = signatures_.size();
+    signatures_.resize(offset + hashes, std::numeric_limits<std::uint32_t>::max());
+    empty_.push_back(fingerprints.empty());
+    if (fingerprints.empty()) {
+        return count_++;
+    }
+
+    for (int k = 0; k < hashes; ++k) {
+        std::uint64_t hashSeed = mix64(config_.seed + static_cast<std::uint64_t>(k));
+        std::uint64_t minValue = std::numeric_limits<std::uint64_t>::max();
+        for (std::uint64_t fingerprint : fingerprints) {
+            minValue = std::min(minValue, mix64(fingerprint ^ hashSeed));
+        }
+        // 只保留高32位，碰撞概率可以忽略
+        signatures_[offset + k] = static_cast<std::uint32_t>(minValue >> 32);
+    }
+
+    return count_++;
+}
+
+float MinHashLSH::estimateSimilarity(std::size_t a, std::size_t b) const {
+    if (empty_[a] || empty_[b]) {
+        return 0.0f;
+    }
+    const std::uint32_t* sa = signature(a);
+    const std::uint32_t* sb = signature(b);
+    const int hashes = numHashes();
+    int equal = 0;
+    for (int k = 0; k < hashes; ++k) {
+        equal += (sa[k] == sb[k]);
+    }
+    return static_cast<float>(equal) / hashes;
+}
+
+std::vector<float> MinHashLSH::nearestSimilarities() const {
+    std::vector<float> nearest(count_, 0.0f);
+    if (count_ < 2) return nearest;
+
+    // 每个band把行值哈希成桶键；排序后相同键连续，桶内只比较相邻的maxBucketProbe个
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> entries;
+    entries.reserve(count_);
+    const std::size_t probe = std::max<std::size_t>(1, config_.maxBucketProbe);
+
+    for (int band = 0; band < config_.bands; ++band) {
+        entries.clear();
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (empty_[i]) continue;
+            const std::uint32_t* rows = signature(i) + band * config_.rowsPerBand;
+            std::uint64_t key = mix64(static_cast<std::uint64_t>(band));
+            for (int r = 0; r < config_.rowsPerBand; ++r) {
+                key = mix64(key ^ rows[r]);
+            }
+            entries.push_back({key, static_cast<std::uint32_t>(i)});
+        }
+        std::sort(entries.begin(), entries.end());
+
+        for (std::size_t begin = 0; begin < entries.size();) {
+            std::size_t end = begin + 1;
+            while (end < entries.size() && entries[end].first == entries[begin].first) ++end;
+
+            for (std::size_t i = begin; i < end; ++i) {
+                std::size_t last = std::min(end, i + 1 + probe);
+                for (std::size_t j = i + 1; j < last; ++j) {
+                    std::uint32_t a = entries[i].second;
+                    std::uint32_t b = entries[j].second;
+                    float similarity = estimateSimilarity(a, b);
+                    nearest[a] = std::max(nearest[a], similarity);
+                    nearest[b] = std::max(nearest[b], similarity);
+                }
+            }
+            begin = end;
+        }
+    }
+
+    return nearest;
+}
+
+} // namespace arc::scoring
@@ -1,9 +1,12 @@
 #include "scoring/score.hpp"
+#include "scoring/kernels.hpp"
+#include "scoring/minhash.hpp"
+#include "core/log.hpp"
+#include "core/parallel.hpp"
 #include <algorithm>
 #include <cmath>
 #include <numeric>
 #include <iostream>
-#include <unordered_map>
 
 namespace arc::scoring {
 
@@ -16,16 +19,10 @@ float pixelDiff(const arc::core::Grid& predicted, const arc::core::Grid& target)
         return 0.0f; // 尺寸不匹配，完全不相似
     }
     
-    int totalPixels = predicted.width * predicted.height;
+    std::size_t totalPixels = predicted.pixels.size();
     if (totalPixels == 0) return 1.0f;
     
-    int matchingPixels = 0;
-    for (int i = 0; i < totalPixels; ++i) {
-        if (predicted.pixels[i] == target.pixels[i]) {
-            matchingPixels++;
-        }
-    }
-    
+    std::size_t matchingPixels = countEqualPixels(predicted.pixels.data(), target.pixels.data(), totalPixels);
     return static_cast<float>(matchingPixels) / totalPixels;
 }
 
@@ -35,20 +32,7 @@ float shapeBonus(const arc::core::Grid& predicted, const arc::core::Grid& target
         return 0.0f;
     }
     
-    int totalNonZero = 0;
-    int matchingShape = 0;
-    
-    for (int i = 0; i < predicted.height; ++i) {
-        for (int j = 0; j < predicted.width; ++j) {
-            bool predNonZero = predicted(i, j) != 0;
-            bool targNonZero = target(i, j) != 0;
-            
-            if (targNonZero) totalNonZero++;
-            if (predNonZero && targNonZero) matchingShape++;
-        }
-    }
-    
-    return totalNonZero > 0 ? static_cast<float>(matchingShape) / totalNonZero : 1.0f;
+    return scoresFromMetrics(computeGridPairMetrics(predicted, target), predicted, target).shape;
 }
 
 float sizeMatchBonus(const arc::core::Grid& predicted, const arc::core::Grid& target) {
@@ -66,28 +50,23 @@ float sizeMatchBonus(const arc::core::Grid& predicted, const arc::core::Grid& ta
 }
 
 float colorDistributionSimilarity(const arc::core::Grid& predicted, const arc::core::Grid& target) {
-    std::unordered_map<int, int> predCounts, targCounts;
-    
-    // 统计颜色分布
-    for (std::uint8_t pixel : predicted.pixels) {
-        predCounts[pixel]++;
-    }
-    for (std::uint8_t pixel : target.pixels) {
-        targCounts[pixel]++;
-    }
+    // 统计颜色分布 - 10色直方图
+    std::uint32_t predCounts[NUM_COLORS], targCounts[NUM_COLORS];
+    colorHistogram(predicted.pixels.data(), predicted.pixels.size(), predCounts);
+    colorHistogram(target.pixels.data(), target.pixels.size(), targCounts);
     
     // 计算分布相似度
     float similarity = 0.0f;
-    float totalPred = predicted.width * predicted.height;
-    float totalTarg = target.width * target.height;
+    float totalPred = static_cast<float>(predicted.pixels.size());
+    float totalTarg = static_cast<float>(target.pixels.size());
     
-    for (int color = 0; color < 10; ++color) {
-        float predRatio = predCounts[color] / totalPred;
-        float targRatio = targCounts[color] / totalTarg;
+    for (int color = 0; color < NUM_COLORS; ++color) {
+        float predRatio = totalPred > 0 ? predCounts[color] / totalPred : 0.0f;
+        float targRatio = totalTarg > 0 ? targCounts[color] / totalTarg : 0.0f;
         similarity += 1.0f - std::abs(predRatio - targRatio);
     }
     
-    return similarity / 10.0f;
+    return similarity / NUM_COLORS;
 }
 
 // ============================================================================
@@ -157,13 +136,12 @@ float CandidateScorer::calculatePixelMatchScore(const arc::core::Grid& predicted
 }
 
 float CandidateScorer::calculateStructuralSimilarity(const arc::core::Grid& predicted, const arc::core::Grid& target) const {
-    float shapeScore = shapeBonus(predicted, target);
-    float sizeScore = sizeMatchBonus(predicted, target);
-    float colorScore = colorDistributionSimilarity(predicted, target);
+    // 融合内核：形状、尺寸、颜色分布一次遍历得到
+    GridPairScores scores = scoresFromMetrics(computeGridPairMetrics(predicted, target), predicted, target);
     
-    return (shapeScore * config_.shapeWeight + 
-            sizeScore * config_.sizeWeight + 
-            colorScore * config_.colorWeight) / 
+    return (scores.shape * config_.shapeWeight + 
+            scores.size * config_.sizeWeight + 
+            scores.color * config_.colorWeight) / 
            (config_.shapeWeight + config_.sizeWeight + config_.colorWeight);
 }
 
@@ -225,7 +203,7 @@ int AnswerScorer::scoreAnswers(
 ) {
     // 对应icecuber的assert：assert(answers.size() <= 3);
     if (answers.size() > 3) {
-        std::cerr << "Warning: Too many answers provided (expected <= 3)" << std::endl;
+        ARC_LOG_WARN("答案数量过多: " << answers.size() << " (最多3个)");
     }
     
     // 对应icecuber的循环检查：for (Image_ answer : answers)
@@ -254,7 +232,10 @@ float AnswerScorer::partialMatch(const arc::core::Grid& answer, const arc::core:
         return 0.0f;
     }
     
-    return pixelDiff(answer, target);
+    std::size_t totalPixels = answer.pixels.size();
+    if (totalPixels == 0) return 1.0f;
+    
+    return static_cast<float>(countEqualPixels(answer.pixels.data(), target.pixels.data(), totalPixels)) / totalPixels;
 }
 
 // ============================================================================
@@ -300,7 +281,7 @@ float PieceScorer::scoreSinglePiece(
     }
     
     // 多样性奖励
-    float diversity = calculateDiversity(piece, collection, pieceIndex);
+    float diversity = calculateDiversity(collection, pieceIndex);
     score += diversity * config_.diversityBonus;
     
     return std::max(0.0f, score);
@@ -326,23 +307,46 @@ float PieceScorer::calculateCoverage(
 }
 
 float PieceScorer::calculateDiversity(
-    const arc::piece::Piece& piece,
     const arc::piece::PieceCollection& collection,
     std::size_t pieceIndex
 ) {
-    // 基于深度的多样性评估
-    float diversityScore = 1.0f;
-    
-    // 检查与其他pieces的深度差异
+    // 索引按集合代数缓存，同一集合只构建一次，之后每个piece只是查表
+    if (indexedGeneration_ != collection.generation()) {
+        buildDiversityIndex(collection);
+    }
+    return pieceIndex < diversity_.size() ? diversity_[pieceIndex] : 0.0f;
+}
+
+void PieceScorer::buildDiversityIndex(const arc::piece::PieceCollection& collection) {
+    MinHashLSH::Config lshConfig;
+    lshConfig.bands = config_.minHashBands;
+    lshConfig.rowsPerBand = config_.minHashRowsPerBand;
+    lshConfig.maxBucketProbe = config_.maxBucketProbe;
+    MinHashLSH lsh(lshConfig);
+
+    // 每个piece的指纹集合：各DAG上的图像哈希，混入DAG编号以区分位置
+    std::vector<std::uint64_t> fingerprints;
+    std::vector<bool> hasFingerprint(collection.getPieceCount(), false);
     for (std::size_t i = 0; i < collection.getPieceCount(); ++i) {
-        if (i != pieceIndex) {
-            float depthDiff = std::abs(static_cast<float>(piece.depth) - 
-                                     static_cast<float>(collection.pieces[i].depth));
-            diversityScore += depthDiff * 0.1f;
+        fingerprints.clear();
+        for (std::size_t dagIdx = 0; dagIdx < collection.getDAGCount(); ++dagIdx) {
+            try {
+                std::uint64_t imageHash = arc::core::hashGrid(collection.getPieceImage(i, dagIdx));
+                fingerprints.push_back(imageHash ^ (static_cast<std::uint64_t>(dagIdx + 1) * 0x9E3779B97F4A7C15ULL));
+            } catch (const std::exception&) {
+                // 无效节点不贡献指纹
+            }
         }
+        hasFingerprint[i] = !fingerprints.empty();
+        lsh.add(fingerprints);
     }
-    
-    return diversityScore / collection.getPieceCount();
+
+    // 没有任何有效图像的piece无从比较，不给多样性奖励
+    diversity_ = lsh.nearestSimilarities();
+    for (std::size_t i = 0; i < diversity_.size(); ++i) {
+        diversity_[i] = hasFingerprint[i] ? 1.0f - diversity_[i] : 0.0f;
+    }
+    indexedGeneration_ = collection.generation();
 }
 
 // ============================================================================
@@ -354,6 +358,46 @@ IntegratedScorer::IntegratedScorer(const Config& config)
       candidateScorer_(config.candidateConfig),
       pieceScorer_(config.pieceConfig) {}
 
+namespace {
+
+// 每个线程一份的评分统计累加器，均值/方差用Welford算法，块之间按Chan公式合并
+struct StatisticsAccumulator {
+    std::size_t count = 0;
+    std::size_t valid = 0;
+    std::size_t exact = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double best = 0.0;
+    
+    void add(double score, bool isValid, bool isExact) {
+        best = count == 0 ? score : std::max(best, score);
+        ++count;
+        double delta = score - mean;
+        mean += delta / count;
+        m2 += delta * (score - mean);
+        valid += isValid;
+        exact += isExact;
+    }
+    
+    void merge(const StatisticsAccumulator& other) {
+        if (other.count == 0) return;
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        std::size_t total = count + other.count;
+        double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * count * other.count / total;
+        best = std::max(best, other.best);
+        valid += other.valid;
+        exact += other.exact;
+        count = total;
+    }
+};
+
+} // namespace
+
 std::vector<arc::candidate::Candidate> IntegratedScorer::scoreAndRank(
     std::vector<arc::candidate::Candidate> candidates,
     const arc::core::Grid& testInput,
@@ -361,29 +405,95 @@ std::vector<arc::candidate::Candidate> IntegratedScorer::scoreAndRank(
     const std::vector<std::pair<arc::core::Grid, arc::core::Grid>>& trainingPairs,
     const arc::piece::PieceCollection* pieces
 ) {
-    // 为每个候选解计算综合分数
-    for (auto& candidate : candidates) {
-        float candidateScore = candidateScorer_.scoreSingleCandidate(candidate, testOutput, trainingPairs);
+    // piece分数与候选解无关，只计算一次
+    float pieceScore = 0.0f;
+    if (pieces != nullptr) {
+        pieceScore = pieceScorer_.scorePieces(*pieces, testInput, testOutput, trainingPairs);
+    }
+    
+    const std::size_t count = candidates.size();
+    const bool hasTestOutput = testOutput.width > 0 && testOutput.height > 0;
+    const std::size_t numChunks = arc::core::resolveThreadCount(
+        config_.numThreads, count, config_.minCandidatesPerThread);
+    
+    // 分数越高越靠前，同分按原始顺序，保证结果与线程数无关
+    auto better = [&candidates](std::size_t a, std::size_t b) {
+        if (candidates[a].score != candidates[b].score) return candidates[a].score > candidates[b].score;
+        return a < b;
+    };
+    
+    // 只需要前keep名：每块部分排序出自己的前keep名，再对各块的头部做k路归并
+    const std::size_t keep = std::min(config_.maxReturnedAnswers, count);
+    std::vector<StatisticsAccumulator> accumulators(numChunks);
+    std::vector<std::size_t> order(count);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::vector<std::size_t> chunkCursors(numChunks, 0);
+    std::vector<std::size_t> chunkHeads(numChunks, 0);
+    
+    arc::core::parallelChunks(count, numChunks, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        StatisticsAccumulator& acc = accumulators[chunk];
         
-        float pieceScore = 0.0f;
-        if (pieces != nullptr) {
-            pieceScore = pieceScorer_.scorePieces(*pieces, testInput, testOutput, trainingPairs);
+        // 为每个候选解计算综合分数，同时累计统计信息
+        for (std::size_t i = begin; i < end; ++i) {
+            auto& candidate = candidates[i];
+            float candidateScore = candidateScorer_.scoreSingleCandidate(candidate, testOutput, trainingPairs);
+            
+            if (config_.enableMultiObjective) {
+                candidate.score = fuseMultiObjectiveScores(candidateScore, pieceScore, candidate);
+            } else {
+                candidate.score = candidateScore;
+            }
+            
+            bool hasAnswer = !candidate.images.empty();
+            bool isValid = hasAnswer && candidateScorer_.validateAnswer(candidate.images.back());
+            bool isExact = hasAnswer && hasTestOutput && answerScorer_.exactMatch(candidate.images.back(), testOutput);
+            acc.add(candidate.score, isValid, isExact);
         }
         
-        if (config_.enableMultiObjective) {
-            candidate.score = fuseMultiObjectiveScores(candidateScore, pieceScore, candidate);
-        } else {
-            candidate.score = candidateScore;
+        const std::size_t head = begin + std::min(keep, end - begin);
+        std::partial_sort(order.begin() + begin, order.begin() + head, order.begin() + end, better);
+        chunkCursors[chunk] = begin;
+        chunkHeads[chunk] = head;
+    });
+    
+    // 合并各块的统计
+    StatisticsAccumulator total;
+    for (const auto& acc : accumulators) {
+        total.merge(acc);
+    }
+    
+    // k路归并各块头部，块数和keep都很小，每次线性扫描各块即可
+    std::vector<std::size_t> top;
+    top.reserve(keep);
+    while (top.size() < keep) {
+        std::size_t bestChunk = numChunks;
+        for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+            if (chunkCursors[chunk] < chunkHeads[chunk] &&
+                (bestChunk == numChunks || better(order[chunkCursors[chunk]], order[chunkCursors[bestChunk]]))) {
+                bestChunk = chunk;
+            }
         }
+        if (bestChunk == numChunks) break;
+        top.push_back(order[chunkCursors[bestChunk]++]);
     }
     
-    // 排序 - 分数越高越好
-    std::sort(candidates.begin(), candidates.end());
+    lastStats_ = ScoringStatistics{};
+    lastStats_.totalCandidates = count;
+    if (total.count > 0) {
+        lastStats_.bestScore = static_cast<float>(total.best);
+        lastStats_.averageScore = static_cast<float>(total.mean);
+        lastStats_.scoreVariance = static_cast<float>(total.m2 / total.count);
+        lastStats_.validCandidates = total.valid;
+        lastStats_.exactMatches = total.exact;
+    }
     
-    // 计算统计信息
-    calculateStatistics(candidates);
+    std::vector<arc::candidate::Candidate> ranked;
+    ranked.reserve(top.size());
+    for (std::size_t index : top) {
+        ranked.push_back(std::move(candidates[index]));
+    }
     
-    return candidates;
+    return ranked;
 }
 
 std::vector<arc::core::Grid> IntegratedScorer::getBestAnswers(
@@ -405,38 +515,6 @@ std::vector<arc::core::Grid> IntegratedScorer::getBestAnswers(
     return answers;
 }
 
-void IntegratedScorer::calculateStatistics(const std::vector<arc::candidate::Candidate>& candidates) {
-    lastStats_ = ScoringStatistics{};
-    lastStats_.totalCandidates = candidates.size();
-    
-    if (candidates.empty()) return;
-    
-    float totalScore = 0.0f;
-    float minScore = candidates[0].score;
-    float maxScore = candidates[0].score;
-    
-    for (const auto& candidate : candidates) {
-        if (candidateScorer_.validateAnswer(candidate.images.back())) {
-            lastStats_.validCandidates++;
-        }
-        
-        totalScore += candidate.score;
-        minScore = std::min(minScore, candidate.score);
-        maxScore = std::max(maxScore, candidate.score);
-    }
-    
-    lastStats_.bestScore = candidates[0].score; // 已排序，第一个是最好的
-    lastStats_.averageScore = totalScore / candidates.size();
-    
-    // 计算方差
-    float variance = 0.0f;
-    for (const auto& candidate : candidates) {
-        float diff = candidate.score - lastStats_.averageScore;
-        variance += diff * diff;
-    }
-    lastStats_.scoreVariance = variance / candidates.size();
-}
-
 float IntegratedScorer::fuseMultiObjectiveScores(
     float candidateScore,
     float pieceScore,
@@ -451,12 +529,40 @@ float IntegratedScorer::fuseMultiObjectiveScores(
 
 AdvancedScoringStrategy::AdvancedScoringStrategy(const Config& config) : config_(config) {}
 
+AdvancedScoringStrategy::EvaluationCache::EvaluationCache(
+    const arc::candidate::Candidate& candidate,
+    const arc::core::Grid& target
+) : answer_(candidate.images.empty() ? nullptr : &candidate.images.back()),
+    target_(target) {}
+
+const GridPairScores& AdvancedScoringStrategy::EvaluationCache::pairScores() {
+    if (!metricsReady_) {
+        metrics_ = computeGridPairMetrics(*answer_, target_);
+        pairScores_ = scoresFromMetrics(metrics_, *answer_, target_);
+        metricsReady_ = true;
+    }
+    return pairScores_;
+}
+
+bool AdvancedScoringStrategy::EvaluationCache::exactMatch() {
+    pairScores();
+    return metrics_.sameSize && metrics_.matchingPixels == metrics_.predictedPixels;
+}
+
+float AdvancedScoringStrategy::EvaluationCache::storeStrategyScore(StrategyType strategy, float score) {
+    ready_[static_cast<int>(strategy)] = true;
+    scores_[static_cast<int>(strategy)] = score;
+    return score;
+}
+
 float AdvancedScoringStrategy::advancedScore(
     const arc::candidate::Candidate& candidate,
     const arc::core::Grid& target,
     const std::vector<std::pair<arc::core::Grid, arc::core::Grid>>& trainingPairs
 ) {
-    float primaryScore = scoreWithStrategy(candidate, target, config_.primaryStrategy);
+    // 主策略和所有备选策略共享同一个缓存
+    EvaluationCache cache(candidate, target);
+    float primaryScore = scoreCached(cache, config_.primaryStrategy);
     
     if (config_.fallbackStrategies.empty()) {
         return primaryScore;
@@ -465,7 +571,7 @@ float AdvancedScoringStrategy::advancedScore(
     // 计算备选策略分数
     float fallbackScore = 0.0f;
     for (auto strategy : config_.fallbackStrategies) {
-        fallbackScore += scoreWithStrategy(candidate, target, strategy);
+        fallbackScore += scoreCached(cache, strategy);
     }
     fallbackScore /= config_.fallbackStrategies.size();
     
@@ -479,51 +585,60 @@ float AdvancedScoringStrategy::scoreWithStrategy(
     const arc::core::Grid& target,
     StrategyType strategy
 ) {
+    EvaluationCache cache(candidate, target);
+    return scoreCached(cache, strategy);
+}
+
+float AdvancedScoringStrategy::scoreCached(EvaluationCache& cache, StrategyType strategy) {
+    if (static_cast<int>(strategy) >= NUM_STRATEGIES) {
+        return 0.0f;
+    }
+    if (cache.hasStrategyScore(strategy)) {
+        return cache.strategyScore(strategy);
+    }
+    
+    float score = 0.0f;
     switch (strategy) {
         case StrategyType::ExactMatch:
-            return exactMatchScore(candidate, target);
+            score = exactMatchScore(cache);
+            break;
         case StrategyType::StructuralSim:
-            return structuralSimilarityScore(candidate, target);
+            score = structuralSimilarityScore(cache);
+            break;
         case StrategyType::ProgressiveEval:
-            return progressiveEvalScore(candidate, target);
+            score = progressiveEvalScore(cache);
+            break;
         case StrategyType::EnsembleScoring:
-            return ensembleScore(candidate, target);
-        default:
-            return 0.0f;
+            score = ensembleScore(cache);
+            break;
     }
+    return cache.storeStrategyScore(strategy, score);
 }
 
-float AdvancedScoringStrategy::exactMatchScore(const arc::candidate::Candidate& candidate, const arc::core::Grid& target) {
-    if (candidate.images.empty()) return 0.0f;
+float AdvancedScoringStrategy::exactMatchScore(EvaluationCache& cache) {
+    if (!cache.hasAnswer()) return 0.0f;
     
-    const arc::core::Grid& answer = candidate.images.back();
-    return (answer.width == target.width && 
-            answer.height == target.height && 
-            answer.pixels == target.pixels) ? 1.0f : 0.0f;
+    return cache.exactMatch() ? 1.0f : 0.0f;
 }
 
-float AdvancedScoringStrategy::structuralSimilarityScore(const arc::candidate::Candidate& candidate, const arc::core::Grid& target) {
-    if (candidate.images.empty()) return 0.0f;
-    
-    const arc::core::Grid& answer = candidate.images.back();
-    float pixelSim = pixelDiff(answer, target);
-    float shapeSim = shapeBonus(answer, target);
-    float sizeSim = sizeMatchBonus(answer, target);
+float AdvancedScoringStrategy::structuralSimilarityScore(EvaluationCache& cache) {
+    if (!cache.hasAnswer()) return 0.0f;
     
-    return (pixelSim + shapeSim + sizeSim) / 3.0f;
+    const GridPairScores& scores = cache.pairScores();
+    return (scores.pixel + scores.shape + scores.size) / 3.0f;
 }
 
-float AdvancedScoringStrategy::progressiveEvalScore(const arc::candidate::Candidate& candidate, const arc::core::Grid& target) {
+float AdvancedScoringStrategy::progressiveEvalScore(EvaluationCache& cache) {
     // 渐进式评估：先粗粒度，再细粒度
-    float coarseScore = structuralSimilarityScore(candidate, target);
+    float coarseScore = scoreCached(cache, StrategyType::StructuralSim);
     if (coarseScore < 0.5f) return coarseScore;
     
-    return exactMatchScore(candidate, target);
+    return scoreCached(cache, StrategyType::ExactMatch);
 }
 
-float AdvancedScoringStrategy::ensembleScore(const arc::candidate::Candidate& candidate, const arc::core::Grid& target) {
-    float exactScore = exactMatchScore(candidate, target);
-    float structScore = structuralSimilarityScore(candidate, target);
+float AdvancedScoringStrategy::ensembleScore(EvaluationCache& cache) {
+    float exactScore = scoreCached(cache, StrategyType::ExactMatch);
+    float structScore = scoreCached(cache, StrategyType::StructuralSim);
     
     return (exactScore + structScore) / 2.0f;
 }
@@ -544,14 +659,19 @@ float quickScore(const arc::candidate::Candidate& candidate, const arc::core::Gr
 
 std::vector<float> batchScore(
     const std::vector<arc::candidate::Candidate>& candidates,
-    const arc::core::Grid& target
+    const arc::core::Grid& target,
+    std::size_t numThreads
 ) {
-    std::vector<float> scores;
-    scores.reserve(candidates.size());
-    
-    for (const auto& candidate : candidates) {
-        scores.push_back(quickScore(candidate, target));
-    }
+    std::vector<float> scores(candidates.size());
+    
+    // 每个候选解的分数写入各自的位置，块之间无共享状态
+    std::size_t numChunks = arc::core::resolveThreadCount(numThreads, candidates.size(), 64);
+    arc::core::parallelChunks(candidates.size(), numChunks,
+        [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t i = begin; i < end; ++i) {
+                scores[i] = quickScore(candidates[i], target);
+            }
+        });
     
     return scores;
 }
@@ -0,0 +1,288 @@
+#include "shared_store.hpp"
+#include "batch_journal.hpp"
+#include "io/mapped_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace arc::solver {
+
+// ============================================================================
+// 段内结构 - 计数器是跨进程共享的原子量，必须无锁
+// ============================================================================
+
+namespace {
+
+constexpr char STORE_MAGIC[8] = {'A', 'R', 'C', 'S', 'H', 'M', '0', '1'};
+constexpr std::uint32_t STORE_VERSION = 2;
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "共享内存中的原子量必须无锁");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "共享内存中的原子量必须无锁");
+
+// 结果槽位：序号为奇数时正在写入（seqlock），0表示尚无结果
+struct ResultSlot {
+    std::atomic<std::uint32_t> sequence;
+    std::uint32_t bytes;
+};
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::size_t pageSize() {
+    return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+} // namespace
+
+struct SharedTaskStore::StoreHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t slotBytes;
+    std::uint64_t totalBytes;
+    std::uint64_t corpusOffset;
+    std::uint64_t corpusBytes;
+    std::uint64_t slotIndexOffset;
+    std::uint64_t slotCount;
+    std::uint64_t resultsOffset;
+    std::uint64_t slotStride;
+    std::atomic<std::uint32_t> ready;          // 创建进程写完所有只读部分后置1
+    std::atomic<std::uint64_t> nextSlot;
+    std::atomic<std::uint64_t> completed;
+};
+
+struct SharedTaskStore::SlotEntry {
+    std::uint32_t task;                        // 语料中的任务序号
+    std::uint32_t testIndex;
+};
+
+// ============================================================================
+// 创建与附加
+// ============================================================================
+
+std::unique_ptr<SharedTaskStore> SharedTaskStore::create(const std::string& name, const std::string& corpusPath,
+                                                         const Config& config) {
+    arc::io::MappedFile file(corpusPath);
+    arc::io::CorpusReader source(file.data(), file.size());
+
+    std::vector<SlotEntry> slots;
+    for (std::size_t t = 0; t < source.taskCount(); ++t) {
+        const arc::io::TaskView view = source.task(t);
+        for (std::size_t i = 0; i < view.testCount; ++i) {
+            slots.push_back({static_cast<std::uint32_t>(t), static_cast<std::uint32_t>(i)});
+        }
+    }
+
+    // 头部独占一页；语料和槽位索引之后按页对齐，便于整体设为只读
+    const std::size_t page = pageSize();
+    static_assert(sizeof(StoreHeader) <= 4096, "StoreHeader必须放在一页内");
+    const std::size_t corpusOffset = page;
+    const std::size_t slotIndexOffset = alignUp(corpusOffset + file.size(), alignof(SlotEntry));
+    const std::size_t resultsOffset = alignUp(slotIndexOffset + slots.size() * sizeof(SlotEntry), page);
+    const std::size_t slotStride = alignUp(sizeof(ResultSlot) + config.slotBytes, 64);
+    const std::size_t totalBytes = resultsOffset + slots.size() * slotStride;
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("无法创建共享内存段 " + name + ": " + std::strerror(errno));
+    }
+    void* mapping = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(totalBytes)) == 0) {
+        mapping = ::mmap(nullptr, totalBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("无法映射共享内存段 " + name);
+    }
+
+    // ftruncate已将结果区清零
+    char* base = static_cast<char*>(mapping);
+    std::memcpy(base + corpusOffset, file.data(), file.size());
+    std::memcpy(base + slotIndexOffset, slots.data(), slots.size() * sizeof(SlotEntry));
+
+    auto* header = new (base) StoreHeader{};
+    std::memcpy(header->magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+    header->version = STORE_VERSION;
+    header->slotBytes = static_cast<std::uint32_t>(config.slotBytes);
+    header->totalBytes = totalBytes;
+    header->corpusOffset = corpusOffset;
+    header->corpusBytes = file.size();
+    header->slotIndexOffset = slotIndexOffset;
+    header->slotCount = slots.size();
+    header->resultsOffset = resultsOffset;
+    header->slotStride = slotStride;
+    header->ready.store(1, std::memory_order_release);
+
+    try {
+        return std::unique_ptr<SharedTaskStore>(new SharedTaskStore(name, base, totalBytes));
+    } catch (...) {
+        ::shm_unlink(name.c_str());
+        throw;
+    }
+}
+
+std::unique_ptr<SharedTaskStore> SharedTaskStore::attach(const std::string& name) {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        throw std::runtime_error("无法打开共享内存段 " + name + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    void* mapping = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(StoreHeader)) {
+        mapping = ::mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("无法映射共享内存段 " + name);
+    }
+    return std::unique_ptr<SharedTaskStore>(
+        new SharedTaskStore(name, static_cast<char*>(mapping), static_cast<std::size_t>(st.st_size)));
+}
+
+void SharedTaskStore::unlink(const std::string& name) {
+    if (::shm_unlink(name.c_str()) != 0 && errno != ENOENT) {
+        throw std::runtime_error("无法删除共享内存段 " + name + ": " + std::strerror(errno));
+    }
+}
+
+SharedTaskStore::SharedTaskStore(const std::string& name, char* base, std::size_t size)
+    : name_(name), base_(base), size_(size), header_(reinterpret_cast<StoreHeader*>(base)) {
+    try {
+        if (std::memcmp(header_->magic, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0 ||
+            header_->version != STORE_VERSION || header_->totalBytes != size_) {
+            throw std::runtime_error("不是有效的共享任务存储: " + name_);
+        }
+        if (header_->ready.load(std::memory_order_acquire) != 1) {
+            throw std::runtime_error("共享任务存储尚未创建完成: " + name_);
+        }
+
+        // 语料和槽位索引创建后不再修改，设为只读防止误写
+        ::mprotect(base_ + header_->corpusOffset, header_->resultsOffset - header_->corpusOffset, PROT_READ);
+
+        slots_ = reinterpret_cast<const SlotEntry*>(base_ + header_->slotIndexOffset);
+        corpus_ = std::make_unique<arc::io::CorpusReader>(base_ + header_->corpusOffset, header_->corpusBytes);
+    } catch (...) {
+        ::munmap(base_, size_);
+        throw;
+    }
+}
+
+SharedTaskStore::~SharedTaskStore() {
+    corpus_.reset();
+    ::munmap(base_, size_);
+}
+
+// ============================================================================
+// 任务
+// ============================================================================
+
+std::size_t SharedTaskStore::slotCount() const {
+    return header_->slotCount;
+}
+
+std::size_t SharedTaskStore::corpusTask(std::size_t slot) const {
+    return slots_[slot].task;
+}
+
+std::size_t SharedTaskStore::testIndex(std::size_t slot) const {
+    return slots_[slot].testIndex;
+}
+
+ARCTask SharedTaskStore::loadTask(std::size_t slot) const {
+    if (slot >= slotCount()) {
+        throw std::out_of_range("槽位越界");
+    }
+    const arc::io::TaskView view = corpus_->task(slots_[slot].task);
+    const std::size_t test = slots_[slot].testIndex;
+
+    ARCTask task;
+    task.taskId = view.id;
+    task.testIndex = test;
+    task.trainingExamples.reserve(view.trainCount);
+    for (std::size_t i = 0; i < view.trainCount; ++i) {
+        task.trainingExamples.emplace_back(corpus_->loadGrid(view.trainInputGrid(i)),
+                                           corpus_->loadGrid(view.trainOutputGrid(i)));
+    }
+    task.testInput = corpus_->loadGrid(view.testInputGrid(test));
+    if (test < view.testOutputCount && corpus_->hasGrid(view.testOutputGrid(test))) {
+        task.testOutput = corpus_->loadGrid(view.testOutputGrid(test));
+    }
+    return task;
+}
+
+long SharedTaskStore::claim() {
+    const std::uint64_t slot = header_->nextSlot.fetch_add(1, std::memory_order_relaxed);
+    return slot < header_->slotCount ? static_cast<long>(slot) : -1;
+}
+
+// ============================================================================
+// 结果 - 每个槽位同一时刻只应有一个写者（claim()保证），读者可随时读取
+// ============================================================================
+
+char* SharedTaskStore::resultSlot(std::size_t slot) const {
+    if (slot >= slotCount()) {
+        throw std::out_of_range("槽位越界");
+    }
+    return base_ + header_->resultsOffset + slot * header_->slotStride;
+}
+
+void SharedTaskStore::storeResult(std::size_t slot, const ARCTask& task, const SolveResult& result) {
+    std::string payload = encodeTaskResult(task, result);
+    if (payload.size() > header_->slotBytes) {
+        SolveResult trimmed = result;
+        while (payload.size() > header_->slotBytes && !trimmed.answers.empty()) {
+            trimmed.answers.pop_back();
+            payload = encodeTaskResult(task, trimmed);
+        }
+        if (payload.size() > header_->slotBytes) {
+            throw std::runtime_error("结果超出共享内存槽位容量");
+        }
+    }
+
+    auto* entry = reinterpret_cast<ResultSlot*>(resultSlot(slot));
+    const std::uint32_t sequence = entry->sequence.load(std::memory_order_relaxed);
+    entry->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry->bytes = static_cast<std::uint32_t>(payload.size());
+    std::memcpy(reinterpret_cast<char*>(entry) + sizeof(ResultSlot), payload.data(), payload.size());
+    entry->sequence.store(sequence + 2, std::memory_order_release);
+
+    if (sequence == 0) {
+        header_->completed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool SharedTaskStore::loadResult(std::size_t slot, SolveResult& result) const {
+    const auto* entry = reinterpret_cast<const ResultSlot*>(resultSlot(slot));
+    std::string payload;
+    while (true) {
+        const std::uint32_t before = entry->sequence.load(std::memory_order_acquire);
+        if (before == 0 || (before & 1)) {
+            return false;   // 尚无结果，或正在写入（写者中途崩溃时会一直如此）
+        }
+        const std::uint32_t bytes = std::min<std::uint32_t>(entry->bytes, header_->slotBytes);
+        payload.assign(reinterpret_cast<const char*>(entry) + sizeof(ResultSlot), bytes);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry->sequence.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+
+    std::string taskId;
+    std::size_t testIndex = 0;
+    return decodeTaskResult(payload.data(), payload.size(), taskId, testIndex, result);
+}
+
+std::size_t SharedTaskStore::completed() const {
+    return header_->completed.load(std::memory_order_relaxed);
+}
+
+} // namespace arc::solver
@@ -1,10 +1,27 @@
 #include "solver.hpp"
+#include "io/arc_json.hpp"
+#include "io/corpus.hpp"
+#include "io/mapped_file.hpp"
+#include "core/log.hpp"
+#include "core/parallel.hpp"
+#include "core/trace.hpp"
+#include "batch_journal.hpp"
+#include "result_cache.hpp"
+#include "scheduler.hpp"
+#include "shared_store.hpp"
 #include <iostream>
 #include <chrono>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
 #include <set>
+#include <cmath>
+#include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <iomanip>
+#include <iterator>
+#include <sys/resource.h>
 
 namespace arc::solver {
 
@@ -23,6 +40,7 @@ ARCSolver::ARCSolver(const SolverConfig& config) : config_(config) {
     arc::piece::PieceExtractor::Config pieceConfig;
     pieceConfig.maxDepth = config_.maxDepth;
     pieceConfig.maxPieces = config_.maxPieces;
+    pieceConfig.maxNodes = config_.maxNodes;
     pieceExtractor_ = std::make_unique<arc::piece::PieceExtractor>(pieceConfig);
     
     candidateComposer_ = std::make_unique<arc::candidate::CandidateComposer>();
@@ -36,15 +54,145 @@ ARCSolver::ARCSolver(const SolverConfig& config) : config_(config) {
     arc::scoring::IntegratedScorer::Config scoringConfig;
     scoringConfig.candidateConfig.complexityPenalty = config_.complexityPenalty;
     scoringConfig.maxReturnedAnswers = config_.maxAnswers;
+    scoringConfig.numThreads = config_.scoringThreads;
     scorer_ = std::make_unique<arc::scoring::IntegratedScorer>(scoringConfig);
 }
 
+ARCSolver::~ARCSolver() = default;
+
+ResultCache* ARCSolver::resultCache() {
+    if (config_.resultCachePath.empty()) {
+        return nullptr;
+    }
+    if (!resultCache_ || resultCache_->path() != config_.resultCachePath) {
+        resultCache_ = std::make_unique<ResultCache>(config_.resultCachePath);
+    }
+    return resultCache_.get();
+}
+
+namespace {
+
+// 各阶段的时间权重：尺寸预测、Piece构建、候选解生成、评估排序
+// 每个阶段分到剩余时间中按剩余权重比例的一份，前面阶段省下的时间自动留给后面
+constexpr double STAGE_WEIGHTS[] = {0.02, 0.55, 0.33, 0.10};
+constexpr int NUM_STAGES = sizeof(STAGE_WEIGHTS) / sizeof(STAGE_WEIGHTS[0]);
+
+arc::core::Deadline stageDeadline(const arc::core::Deadline& deadline, int stage) {
+    double remainingWeight = 0.0;
+    for (int i = stage; i < NUM_STAGES; ++i) {
+        remainingWeight += STAGE_WEIGHTS[i];
+    }
+    return deadline.stage(STAGE_WEIGHTS[stage] / remainingWeight);
+}
+
+// 本任务实际使用的DAG节点上限：批量调度分配的预算，不超过预设的maxNodes
+std::size_t nodeLimit(const SolverConfig& config) {
+    return config.nodeBudget > 0 ? std::min(config.nodeBudget, config.maxNodes) : config.maxNodes;
+}
+
+// 候选解是否在所有训练对上都与输出一致
+bool fitsTraining(const arc::candidate::Candidate& candidate, const std::vector<ARCExample>& training) {
+    if (training.empty() || candidate.images.size() < training.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < training.size(); ++i) {
+        const arc::core::Grid& image = candidate.images[i];
+        const arc::core::Grid& target = training[i].output;
+        if (image.width != target.width || image.height != target.height || image.pixels != target.pixels) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 跟踪已回调的最佳答案集，只在答案集变化且分数不降低时回调
+class AnswerProgress {
+public:
+    AnswerProgress(const AnswerCallback& callback, std::chrono::steady_clock::time_point start)
+        : callback_(callback), start_(start) {}
+    
+    bool enabled() const { return static_cast<bool>(callback_); }
+    
+    void offer(std::vector<arc::core::Grid> answers, float score, const char* stage, bool final) {
+        if (!callback_) return;
+        if (!final) {
+            if (answers.empty()) return;
+            if (reported_ && (score < bestScore_ || answers == lastAnswers_)) return;
+        }
+        
+        AnswerUpdate update;
+        update.answers = std::move(answers);
+        update.score = score;
+        update.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        update.stage = stage;
+        update.final = final;
+        
+        reported_ = true;
+        bestScore_ = std::max(bestScore_, score);
+        lastAnswers_ = update.answers;
+        callback_(update);
+    }
+    
+private:
+    const AnswerCallback& callback_;
+    std::chrono::steady_clock::time_point start_;
+    bool reported_ = false;
+    float bestScore_ = 0.0f;
+    std::vector<arc::core::Grid> lastAnswers_;
+};
+
+} // namespace
+
 // 主求解函数 - 对应icecuber的核心求解流程
 SolveResult ARCSolver::solve(const ARCTask& task) {
+    return solve(task, arc::core::Deadline(config_.timeBudget, config_.memoryBudget));
+}
+
+SolveResult ARCSolver::solve(const ARCTask& task, const arc::core::Deadline& deadline) {
+    return solve(task, deadline, nullptr);
+}
+
+SolveResult ARCSolver::solve(const ARCTask& task, const arc::core::Deadline& deadline,
+                             const AnswerCallback& onUpdate) {
     auto startTime = std::chrono::high_resolution_clock::now();
+    AnswerProgress progress(onUpdate, std::chrono::steady_clock::now());
+    
+    // 持久化缓存：等价任务（颜色置换、旋转翻转）共享条目，答案映射回原任务空间
+    ResultCache* cache = resultCache();
+    CanonicalTask cacheKey;
+    std::uint64_t fingerprint = 0;
+    if (cache) {
+        cacheKey = canonicalizeTask(task);
+        fingerprint = solverFingerprint(config_);
+        CachedResult cached;
+        if (cache->lookup(cacheKey, fingerprint, cached)) {
+            SolveResult result;
+            for (const auto& answer : cached.answers) {
+                result.answers.push_back(fromCanonical(answer, cacheKey));
+            }
+            result.bestScore = cached.bestScore;
+            result.totalPieces = cached.totalPieces;
+            result.totalCandidates = cached.totalCandidates;
+            result.searchDepth = cached.searchDepth;
+            result.cacheHit = true;
+            result.verdict = calculateVerdict(result.answers, task);
+            result.success = (result.verdict != SolveResult::Verdict::Nothing);
+            result.solvingTime = std::chrono::duration<double>(
+                std::chrono::high_resolution_clock::now() - startTime).count();
+            progress.offer(result.answers, result.bestScore, "cache", true);
+            updateStatistics(result);
+            return result;
+        }
+    }
+    
+    arc::core::AllocTaskScope allocScope;
+    arc::core::PerfTaskScope perfScope(config_.perfCounters);
+    ARC_TRACE_SPAN(span, "solve");
+    ARC_TRACE_LABEL(span, "task", task.taskId);
     
     SolveResult result;
     result.success = false;
+    bool failed = false;
     
     try {
         if (config_.printTimes) {
@@ -53,8 +201,14 @@ SolveResult ARCSolver::solve(const ARCTask& task) {
         
         // 1. 尺寸预测 - 对应icecuber的bruteSize
         auto stepStart = std::chrono::high_resolution_clock::now();
-        auto outputSizes = predictOutputSizes(task.testInput, task.trainingExamples);
+        // 尺寸预测只与训练样例数成正比，不需要检查预算
+        std::vector<arc::core::Point> outputSizes;
+        {
+            ARC_STAGE_SPAN(sizeSpan, "predict_sizes", arc::core::SolveStage::SizePrediction);
+            outputSizes = predictOutputSizes(task.testInput, task.trainingExamples);
+        }
         auto stepEnd = std::chrono::high_resolution_clock::now();
+        result.stageTimes.sizePrediction = std::chrono::duration<double>(stepEnd - stepStart).count();
         
         if (config_.printTimes) {
             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stepEnd - stepStart);
@@ -62,11 +216,14 @@ SolveResult ARCSolver::solve(const ARCTask& task) {
         }
         
         // 2. 构建DAG和提取pieces - 对应icecuber的brutePieces2 + makePieces2
+        // 迭代加深时先浅层求解，训练对没有被完全解释再原地加深DAG
+        int depth = config_.iterativeDeepening ? std::min(config_.initialDepth, config_.maxDepth)
+                                               : config_.maxDepth;
         stepStart = std::chrono::high_resolution_clock::now();
-        auto pieces = buildPieces(task.testInput, task.trainingExamples, outputSizes);
+        auto pieces = buildPieces(task.testInput, task.trainingExamples, outputSizes, depth,
+                                  stageDeadline(deadline, 1));
         stepEnd = std::chrono::high_resolution_clock::now();
-        
-        result.totalPieces = pieces.getPieceCount();
+        double pieceTime = std::chrono::duration<double>(stepEnd - stepStart).count();
         
         if (config_.printTimes) {
             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stepEnd - stepStart);
@@ -77,27 +234,104 @@ SolveResult ARCSolver::solve(const ARCTask& task) {
             printMemoryUsage(pieces);
         }
         
-        // 3. 组合候选解 - 对应icecuber的composePieces2
-        stepStart = std::chrono::high_resolution_clock::now();
-        auto candidates = generateCandidates(pieces, task.trainingExamples, outputSizes);
-        stepEnd = std::chrono::high_resolution_clock::now();
-        
-        result.totalCandidates = candidates.size();
-        
-        if (config_.printTimes) {
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stepEnd - stepStart);
-            printProgress("候选解生成", duration.count() / 1000.0);
+        std::vector<arc::candidate::Candidate> rankedCandidates;
+        while (true) {
+            // 精确piece检查 - 最早可用的答案
+            auto exactCandidates = findExactPieceCandidates(pieces, task.trainingExamples);
+            if (progress.enabled() && !exactCandidates.empty()) {
+                progress.offer(selectBestAnswers(exactCandidates),
+                               static_cast<float>(exactCandidates.front().score), "exact_piece", false);
+            }
+            
+            // 3. 组合候选解 - 对应icecuber的composePieces2
+            stepStart = std::chrono::high_resolution_clock::now();
+            std::function<void(const std::vector<arc::candidate::Candidate>&)> onRound;
+            if (progress.enabled()) {
+                // 每轮组合后对当前候选解做一次轻量排序
+                onRound = [&](const std::vector<arc::candidate::Candidate>& roundCandidates) {
+                    std::vector<arc::candidate::Candidate> pool = exactCandidates;
+                    pool.insert(pool.end(), roundCandidates.begin(), roundCandidates.end());
+                    auto ranked = evaluateAndRank(std::move(pool), task.trainingExamples, deadline);
+                    if (!ranked.empty()) {
+                        progress.offer(selectBestAnswers(ranked), static_cast<float>(ranked.front().score),
+                                       "greedy_round", false);
+                    }
+                };
+            }
+            std::vector<arc::candidate::Candidate> candidates;
+            {
+                arc::core::StageScope stage(arc::core::SolveStage::Composition);
+                candidates = generateCandidates(pieces, task.trainingExamples, outputSizes,
+                                                stageDeadline(deadline, 2), onRound);
+            }
+            // 本轮组合记账的字节，评估后候选池整体丢弃，加深前归还
+            std::size_t composedBytes = 0;
+            for (const auto& candidate : candidates) {
+                composedBytes += arc::candidate::candidateBytes(candidate);
+            }
+            candidates.insert(candidates.begin(), exactCandidates.begin(), exactCandidates.end());
+            stepEnd = std::chrono::high_resolution_clock::now();
+            result.stageTimes.composition += std::chrono::duration<double>(stepEnd - stepStart).count();
+            
+            result.totalCandidates += candidates.size();
+            
+            if (config_.printTimes) {
+                auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stepEnd - stepStart);
+                printProgress("候选解生成", duration.count() / 1000.0);
+            }
+            
+            // 4. 评估和排序 - 对应icecuber的evaluateCands
+            stepStart = std::chrono::high_resolution_clock::now();
+            auto roundRanked = evaluateAndRank(std::move(candidates), task.trainingExamples,
+                                               stageDeadline(deadline, 3));
+            // 加深轮可能被预算截断（重新提取、组合或评估），只评估到部分候选解；
+            // 与上一轮的完整排序合并，最终答案不会比浅层差。重复的答案由selectBestAnswers去重
+            if (rankedCandidates.empty()) {
+                rankedCandidates = std::move(roundRanked);
+            } else {
+                std::vector<arc::candidate::Candidate> merged;
+                merged.reserve(rankedCandidates.size() + roundRanked.size());
+                std::merge(std::make_move_iterator(rankedCandidates.begin()),
+                           std::make_move_iterator(rankedCandidates.end()),
+                           std::make_move_iterator(roundRanked.begin()),
+                           std::make_move_iterator(roundRanked.end()),
+                           std::back_inserter(merged));
+                rankedCandidates = std::move(merged);
+            }
+            stepEnd = std::chrono::high_resolution_clock::now();
+            result.stageTimes.evaluation += std::chrono::duration<double>(stepEnd - stepStart).count();
+            
+            if (config_.printTimes) {
+                auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stepEnd - stepStart);
+                printProgress("候选解评估", duration.count() / 1000.0);
+            }
+            
+            const bool solved = !rankedCandidates.empty() &&
+                                fitsTraining(rankedCandidates.front(), task.trainingExamples);
+            if (solved || depth >= config_.maxDepth || deadline.expired()) {
+                break;
+            }
+            
+            // 加深一层，已有节点不重建
+            deadline.releaseMemory(composedBytes);
+            ++depth;
+            stepStart = std::chrono::high_resolution_clock::now();
+            const bool grew = deepenPieces(pieces, depth, stageDeadline(deadline, 1));
+            stepEnd = std::chrono::high_resolution_clock::now();
+            pieceTime += std::chrono::duration<double>(stepEnd - stepStart).count();
+            if (!grew) {
+                break;
+            }
+            ARC_LOG_DEBUG("任务 " << task.taskId << " 加深到深度 " << depth
+                          << ", pieces=" << pieces.getPieceCount());
         }
         
-        // 4. 评估和排序 - 对应icecuber的evaluateCands
-        stepStart = std::chrono::high_resolution_clock::now();
-        auto rankedCandidates = evaluateAndRank(std::move(candidates), task.trainingExamples);
-        stepEnd = std::chrono::high_resolution_clock::now();
-        
-        if (config_.printTimes) {
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stepEnd - stepStart);
-            printProgress("候选解评估", duration.count() / 1000.0);
+        result.searchDepth = depth;
+        result.totalPieces = pieces.getPieceCount();
+        for (const auto& dag : pieces.dags) {
+            result.stageTimes.dagBuild += dag->getBuildTime();
         }
+        result.stageTimes.pieceExtraction = std::max(0.0, pieceTime - result.stageTimes.dagBuild);
         
         // 5. 选择最佳答案 - 对应icecuber的答案过滤
         result.answers = selectBestAnswers(rankedCandidates);
@@ -110,16 +344,42 @@ SolveResult ARCSolver::solve(const ARCTask& task) {
         result.verdict = calculateVerdict(result.answers, task);
         result.success = (result.verdict != SolveResult::Verdict::Nothing);
         
+        progress.offer(result.answers, result.bestScore, "final", true);
+        
     } catch (const std::exception& e) {
-        if (config_.printTimes) {
-            std::cout << "求解过程中出现异常: " << e.what() << std::endl;
-        }
+        ARC_LOG_WARN("求解任务 " << task.taskId << " 时出现异常: " << e.what());
         result.success = false;
+        failed = true;
     }
     
     auto endTime = std::chrono::high_resolution_clock::now();
     auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
     result.solvingTime = totalDuration.count() / 1000.0;
+    result.budgetExceeded = deadline.expired();
+    result.peakHeapBytes = allocScope.peakBytes();
+    result.allocations = allocScope.stageDelta();
+    result.perfAvailable = perfScope.available();
+    result.perfCounters = perfScope.stageDelta();
+    ARC_TRACE_COUNTER(span, "pieces", result.totalPieces);
+    ARC_TRACE_COUNTER(span, "candidates", result.totalCandidates);
+    
+    // 预算截断的结果取决于当时的机器负载，不写入缓存；调度压低的节点预算同理
+    if (cache && !failed && !result.budgetExceeded && nodeLimit(config_) >= config_.maxNodes) {
+        CachedResult cached;
+        for (const auto& answer : result.answers) {
+            cached.answers.push_back(toCanonical(answer, cacheKey));
+        }
+        cached.bestScore = result.bestScore;
+        cached.totalPieces = result.totalPieces;
+        cached.totalCandidates = result.totalCandidates;
+        cached.searchDepth = result.searchDepth;
+        cached.solvingTime = result.solvingTime;
+        try {
+            cache->store(cacheKey, fingerprint, cached);
+        } catch (const std::exception& e) {
+            ARC_LOG_WARN("写入结果缓存失败: " << e.what());
+        }
+    }
     
     updateStatistics(result);
     
@@ -127,26 +387,198 @@ SolveResult ARCSolver::solve(const ARCTask& task) {
 }
 
 // 批量求解
-std::vector<SolveResult> ARCSolver::solveBatch(const std::vector<ARCTask>& tasks) {
+std::vector<SolveResult> ARCSolver::solveBatch(const std::vector<ARCTask>& tasks, const TaskDoneCallback& onTaskDone) {
+    if (config_.journalPath.empty()) {
+        return solveTasks(tasks, onTaskDone);
+    }
+    
+    // 已记录的任务直接复用，只求解其余任务；日志在求解期间一直持有，防止另一个进程同时续跑
+    BatchJournal journal(config_.journalPath, solverFingerprint(config_));
     std::vector<SolveResult> results;
-    results.reserve(tasks.size());
+    const std::vector<std::size_t> pending = journal.restore(tasks, results);
+    for (std::size_t i = 0, next = 0; i < tasks.size(); ++i) {
+        if (next < pending.size() && pending[next] == i) {
+            ++next;
+        } else {
+            updateStatistics(results[i]);
+        }
+    }
+    if (pending.size() < tasks.size()) {
+        ARC_LOG_INFO("从日志 " << config_.journalPath << " 恢复 " << (tasks.size() - pending.size())
+                     << " 个任务，剩余 " << pending.size() << " 个");
+    }
+    
+    std::vector<ARCTask> pendingTasks;
+    pendingTasks.reserve(pending.size());
+    for (std::size_t index : pending) {
+        pendingTasks.push_back(tasks[index]);
+    }
+    
+    std::vector<SolveResult> solved = solveTasks(pendingTasks, [&](std::size_t i, const SolveResult& result) {
+        journal.append(pendingTasks[i], result);
+        if (onTaskDone) {
+            onTaskDone(pending[i], result);
+        }
+    });
+    journal.sync();
+    
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        results[pending[i]] = std::move(solved[i]);
+    }
+    return results;
+}
+
+std::vector<SolveResult> ARCSolver::solveTasks(const std::vector<ARCTask>& tasks, const TaskDoneCallback& onTaskDone) {
+    const std::size_t numWorkers = arc::core::resolveThreadCount(config_.batchThreads, tasks.size());
+    
+    if (config_.batchDeadline > 0.0) {
+        return solveScheduled(tasks, numWorkers, onTaskDone);
+    }
+    
+    if (numWorkers <= 1) {
+        std::vector<SolveResult> results;
+        results.reserve(tasks.size());
+        
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            if (config_.printTimes) {
+                std::cout << "\n处理任务 " << (i + 1) << "/" << tasks.size() << std::endl;
+            }
+            
+            auto result = solve(tasks[i]);
+            results.push_back(result);
+            if (onTaskDone) {
+                onTaskDone(i, result);
+            }
+            
+            if (config_.printTimes) {
+                printResult(static_cast<int>(i), tasks[i].taskId, result);
+            }
+        }
+        
+        return results;
+    }
     
+    // 预计耗时长的任务先分发，避免批次末尾被长任务拖住
+    std::vector<double> costs(tasks.size());
     for (std::size_t i = 0; i < tasks.size(); ++i) {
-        if (config_.printTimes) {
-            std::cout << "\n处理任务 " << (i + 1) << "/" << tasks.size() << std::endl;
+        costs[i] = predictTaskCost(tasks[i]);
+    }
+    std::vector<std::size_t> order(tasks.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return costs[a] > costs[b];
+    });
+    
+    // 任务之间已经并行，任务内部不再开评分线程
+    SolverConfig workerConfig = config_;
+    workerConfig.batchThreads = 1;
+    workerConfig.scoringThreads = 1;
+    
+    std::vector<SolveResult> results(tasks.size());
+    std::vector<Statistics> workerStatistics(numWorkers);
+    std::atomic<std::size_t> nextSlot{0};
+    std::mutex printMutex;
+    
+    arc::core::parallelWorkers(numWorkers, [&](std::size_t worker) {
+        // 每个工作线程独立的求解组件和统计，不共享任何可变状态
+        ARCSolver workerSolver(workerConfig);
+        
+        for (std::size_t slot = nextSlot++; slot < order.size(); slot = nextSlot++) {
+            const std::size_t index = order[slot];
+            results[index] = workerSolver.solve(tasks[index]);
+            if (onTaskDone) {
+                onTaskDone(index, results[index]);
+            }
+            
+            if (config_.printTimes) {
+                std::lock_guard<std::mutex> lock(printMutex);
+                printResult(static_cast<int>(index), tasks[index].taskId, results[index]);
+            }
         }
         
-        auto result = solve(tasks[i]);
-        results.push_back(result);
+        workerStatistics[worker] = workerSolver.getStatistics();
+    });
+    
+    for (const auto& stats : workerStatistics) {
+        mergeStatistics(stats);
+    }
+    
+    return results;
+}
+
+// 全局截止时间下的批量求解：时间和节点预算由BatchScheduler在分发时逐任务决定
+std::vector<SolveResult> ARCSolver::solveScheduled(const std::vector<ARCTask>& tasks, std::size_t numWorkers,
+                                                   const TaskDoneCallback& onTaskDone) {
+    BatchScheduler::Config schedulerConfig;
+    schedulerConfig.totalBudget = config_.batchDeadline;
+    schedulerConfig.maxNodes = config_.maxNodes;
+    BatchScheduler scheduler(tasks, numWorkers, schedulerConfig);
+    
+    SolverConfig workerConfig = config_;
+    workerConfig.batchThreads = 1;
+    if (numWorkers > 1) {
+        workerConfig.scoringThreads = 1;
+    }
+    
+    std::vector<SolveResult> results(tasks.size());
+    std::vector<Statistics> workerStatistics(numWorkers);
+    std::mutex printMutex;
+    
+    arc::core::parallelWorkers(numWorkers, [&](std::size_t worker) {
+        ARCSolver workerSolver(workerConfig);
+        BatchScheduler::Assignment assignment;
         
-        if (config_.printTimes) {
-            printResult(static_cast<int>(i), tasks[i].taskId, result);
+        while (scheduler.next(assignment)) {
+            SolveResult& result = results[assignment.index];
+            if (assignment.skipped) {
+                // 全局时间已用尽，记为预算用尽的空结果
+                result.budgetExceeded = true;
+                workerSolver.updateStatistics(result);
+            } else {
+                SolverConfig taskConfig = workerConfig;
+                taskConfig.timeBudget = assignment.timeBudget;
+                taskConfig.nodeBudget = assignment.nodeBudget;
+                workerSolver.setConfig(taskConfig);
+                result = workerSolver.solve(tasks[assignment.index]);
+            }
+            scheduler.complete(assignment);
+            // 因全局时间用尽而跳过的任务没有真正求解，不回调（续跑时会重新求解）
+            if (onTaskDone && !assignment.skipped) {
+                onTaskDone(assignment.index, result);
+            }
+            
+            ARC_LOG_DEBUG("任务 " << tasks[assignment.index].taskId << " 预测耗时 " << assignment.predictedCost
+                          << " 时间预算 " << assignment.timeBudget << "s 节点预算 " << assignment.nodeBudget
+                          << " 实际 " << result.solvingTime << "s");
+            
+            if (config_.printTimes) {
+                std::lock_guard<std::mutex> lock(printMutex);
+                printResult(static_cast<int>(assignment.index), tasks[assignment.index].taskId, result);
+            }
         }
+        
+        workerStatistics[worker] = workerSolver.getStatistics();
+    });
+    
+    for (const auto& stats : workerStatistics) {
+        mergeStatistics(stats);
     }
     
     return results;
 }
 
+// 共享内存存储的工作进程循环（见shared_store.hpp）
+std::size_t solveFromStore(ARCSolver& solver, SharedTaskStore& store) {
+    std::size_t solved = 0;
+    for (long slot = store.claim(); slot >= 0; slot = store.claim()) {
+        const ARCTask task = store.loadTask(static_cast<std::size_t>(slot));
+        const SolveResult result = solver.solve(task);
+        store.storeResult(static_cast<std::size_t>(slot), task, result);
+        ++solved;
+    }
+    return solved;
+}
+
 // 1. 尺寸预测 - 简化版的bruteSize
 std::vector<arc::core::Point> ARCSolver::predictOutputSizes(
     const arc::core::Grid& testInput,
@@ -188,7 +620,9 @@ std::vector<arc::core::Point> ARCSolver::predictOutputSizes(
 arc::piece::PieceCollection ARCSolver::buildPieces(
     const arc::core::Grid& testInput,
     const std::vector<ARCExample>& training,
-    const std::vector<arc::core::Point>& outputSizes
+    const std::vector<arc::core::Point>& outputSizes,
+    int depth,
+    const arc::core::Deadline& deadline
 ) {
     // 准备训练对
     std::vector<std::pair<arc::core::Grid, arc::core::Grid>> trainingPairs;
@@ -196,15 +630,79 @@ arc::piece::PieceCollection ARCSolver::buildPieces(
         trainingPairs.emplace_back(example.input, example.output);
     }
     
+    ARC_STAGE_SPAN(span, "build_pieces", arc::core::SolveStage::PieceExtraction);
+    ARC_TRACE_COUNTER(span, "dags", training.size() + 1);
+    
     // 使用piece提取器构建pieces
+    auto pieceConfig = pieceExtractor_->getConfig();
+    pieceConfig.deadline = deadline;
+    pieceConfig.maxNodes = nodeLimit(config_);   // 批量调度会逐任务调整节点预算
+    pieceConfig.maxDepth = static_cast<std::uint16_t>(depth);
+    pieceExtractor_->setConfig(pieceConfig);
     return pieceExtractor_->buildFromTraining(trainingPairs, testInput, outputSizes);
 }
 
+// 2.1 迭代加深 - 在已有DAG上继续扩展一层并重新提取pieces
+bool ARCSolver::deepenPieces(
+    arc::piece::PieceCollection& pieces,
+    int depth,
+    const arc::core::Deadline& deadline
+) {
+    ARC_STAGE_SPAN(span, "deepen_pieces", arc::core::SolveStage::PieceExtraction);
+    ARC_TRACE_COUNTER(span, "depth", depth);
+    
+    auto pieceConfig = pieceExtractor_->getConfig();
+    pieceConfig.deadline = deadline;
+    pieceExtractor_->setConfig(pieceConfig);
+    return pieceExtractor_->deepen(pieces, static_cast<std::uint16_t>(depth));
+}
+
+// 2.5 精确piece检查 - pieces按深度递增提取，先找到的更简单
+std::vector<arc::candidate::Candidate> ARCSolver::findExactPieceCandidates(
+    const arc::piece::PieceCollection& pieces,
+    const std::vector<ARCExample>& training
+) {
+    std::vector<arc::candidate::Candidate> candidates;
+    const std::size_t dagCount = pieces.getDAGCount();
+    if (training.empty() || dagCount != training.size() + 1) {
+        return candidates;
+    }
+    
+    for (std::size_t p = 0; p < pieces.getPieceCount() && candidates.size() < config_.maxAnswers; ++p) {
+        bool exact = true;
+        for (std::size_t i = 0; i < training.size() && exact; ++i) {
+            arc::core::Grid image = pieces.getPieceImage(p, i);
+            const arc::core::Grid& target = training[i].output;
+            exact = image.width == target.width && image.height == target.height &&
+                    image.pixels == target.pixels;
+        }
+        if (!exact) continue;
+        
+        std::vector<arc::core::Grid> images;
+        images.reserve(dagCount);
+        for (std::size_t d = 0; d < dagCount; ++d) {
+            images.push_back(pieces.getPieceImage(p, d));
+        }
+        
+        // 与evaluateCandidates相同的分数：全部训练对匹配，再减去先验
+        const int depth = pieces.pieces[p].depth;
+        arc::candidate::Candidate candidate(images, training.size() - (depth + 0.001) * 0.01);
+        candidate.pieceCount = 1;
+        candidate.sumDepth = depth;
+        candidate.maxDepth = depth;
+        candidates.push_back(std::move(candidate));
+    }
+    
+    return candidates;
+}
+
 // 3. 组合候选解
 std::vector<arc::candidate::Candidate> ARCSolver::generateCandidates(
     arc::piece::PieceCollection& pieces,
     const std::vector<ARCExample>& training,
-    const std::vector<arc::core::Point>& outputSizes
+    const std::vector<arc::core::Point>& outputSizes,
+    const arc::core::Deadline& deadline,
+    const std::function<void(const std::vector<arc::candidate::Candidate>&)>& onRound
 ) {
     // 准备训练对
     std::vector<std::pair<arc::core::Grid, arc::core::Grid>> trainingPairs;
@@ -213,14 +711,22 @@ std::vector<arc::candidate::Candidate> ARCSolver::generateCandidates(
     }
     
     // 使用候选解组合器生成候选解
-    return candidateComposer_->composePieces(pieces, trainingPairs, outputSizes);
+    auto& greedyConfig = candidateComposer_->getGreedyConfig();
+    greedyConfig.deadline = deadline;
+    greedyConfig.onRoundComplete = onRound;
+    auto candidates = candidateComposer_->composePieces(pieces, trainingPairs, outputSizes);
+    greedyConfig.onRoundComplete = nullptr;
+    return candidates;
 }
 
 // 4. 评估和排序
 std::vector<arc::candidate::Candidate> ARCSolver::evaluateAndRank(
     std::vector<arc::candidate::Candidate> candidates,
-    const std::vector<ARCExample>& training
+    const std::vector<ARCExample>& training,
+    const arc::core::Deadline& deadline
 ) {
+    arc::core::StageScope stage(arc::core::SolveStage::Evaluation);
+    
     // 准备训练对
     std::vector<std::pair<arc::core::Grid, arc::core::Grid>> trainingPairs;
     for (const auto& example : training) {
@@ -228,7 +734,7 @@ std::vector<arc::candidate::Candidate> ARCSolver::evaluateAndRank(
     }
     
     // 使用候选解组合器评估
-    return candidateComposer_->evaluateCandidates(candidates, trainingPairs);
+    return candidateComposer_->evaluateCandidates(candidates, trainingPairs, deadline);
 }
 
 // 5. 选择最佳答案 - 对应icecuber的答案过滤逻辑
@@ -269,6 +775,17 @@ void ARCSolver::updateStatistics(const SolveResult& result) {
     statistics_.totalTasks++;
     statistics_.totalTime += result.solvingTime;
     statistics_.averageSolvingTime = statistics_.totalTime / statistics_.totalTasks;
+    statistics_.peakHeapBytes = std::max(statistics_.peakHeapBytes, result.peakHeapBytes);
+    statistics_.cacheHits += result.cacheHit ? 1 : 0;
+    for (std::size_t i = 0; i < arc::core::SOLVE_STAGE_COUNT; ++i) {
+        statistics_.allocations[i] += result.allocations[i];
+    }
+    if (result.perfAvailable) {
+        statistics_.perfTasks++;
+        for (std::size_t i = 0; i < arc::core::SOLVE_STAGE_COUNT; ++i) {
+            statistics_.perfCounters[i] += result.perfCounters[i];
+        }
+    }
     
     switch (result.verdict) {
         case SolveResult::Verdict::Correct:
@@ -285,6 +802,25 @@ void ARCSolver::updateStatistics(const SolveResult& result) {
     }
 }
 
+void ARCSolver::mergeStatistics(const Statistics& other) {
+    statistics_.totalTasks += other.totalTasks;
+    statistics_.correctSolutions += other.correctSolutions;
+    statistics_.candidateSolutions += other.candidateSolutions;
+    statistics_.dimensionMatches += other.dimensionMatches;
+    statistics_.totalTime += other.totalTime;
+    statistics_.averageSolvingTime = statistics_.totalTasks > 0 ?
+        statistics_.totalTime / statistics_.totalTasks : 0.0;
+    statistics_.peakHeapBytes = std::max(statistics_.peakHeapBytes, other.peakHeapBytes);
+    for (std::size_t i = 0; i < arc::core::SOLVE_STAGE_COUNT; ++i) {
+        statistics_.allocations[i] += other.allocations[i];
+    }
+    statistics_.cacheHits += other.cacheHits;
+    statistics_.perfTasks += other.perfTasks;
+    for (std::size_t i = 0; i < arc::core::SOLVE_STAGE_COUNT; ++i) {
+        statistics_.perfCounters[i] += other.perfCounters[i];
+    }
+}
+
 SolveResult::Verdict ARCSolver::calculateVerdict(
     const std::vector<arc::core::Grid>& answers,
     const ARCTask& task
@@ -352,47 +888,117 @@ ARCTask TaskLoader::createTestTask(
     return task;
 }
 
-// 简化的JSON加载（实际项目中应使用JSON库）
+namespace {
+
+// 每个test输入展开为一个ARCTask
+void appendTasks(arc::io::TaskRecord& record, std::vector<ARCTask>& tasks) {
+    for (std::size_t i = 0; i < record.testInputs.size(); ++i) {
+        ARCTask task;
+        task.taskId = record.id;
+        task.testIndex = i;
+        task.trainingExamples.reserve(record.train.size());
+        for (const auto& [input, output] : record.train) {
+            task.trainingExamples.emplace_back(input, output);
+        }
+        task.testInput = std::move(record.testInputs[i]);
+        if (i < record.testOutputs.size() && record.testOutputs[i]) {
+            task.testOutput = std::move(*record.testOutputs[i]);
+        }
+        tasks.push_back(std::move(task));
+    }
+}
+
+std::vector<ARCTask> expandRecords(std::vector<arc::io::TaskRecord>& records) {
+    std::vector<ARCTask> tasks;
+    for (auto& record : records) {
+        appendTasks(record, tasks);
+    }
+    return tasks;
+}
+
+std::vector<ARCTask> readCorpus(const arc::io::CorpusReader& reader) {
+    std::vector<ARCTask> tasks;
+    for (std::size_t i = 0; i < reader.taskCount(); ++i) {
+        arc::io::TaskRecord record = reader.loadTask(i);
+        appendTasks(record, tasks);
+    }
+    return tasks;
+}
+
+ARCTask firstTask(std::vector<ARCTask> tasks, const std::string& source) {
+    if (tasks.empty()) {
+        throw std::runtime_error("没有可用的test输入: " + source);
+    }
+    return std::move(tasks.front());
+}
+
+} // namespace
+
 ARCTask TaskLoader::loadFromJson(const std::string& jsonStr) {
-    // 这里应该使用真正的JSON解析库
-    // 为简化起见，创建一个测试任务
-    ARCTask task;
-    task.taskId = "json_task";
-    
-    // 创建简单的测试数据
-    arc::core::Grid input(2, 2);
-    input(0, 0) = 1; input(0, 1) = 0;
-    input(1, 0) = 0; input(1, 1) = 1;
-    
-    arc::core::Grid output(2, 2);
-    output(0, 0) = 2; output(0, 1) = 0;
-    output(1, 0) = 0; output(1, 1) = 2;
-    
-    task.trainingExamples.emplace_back(input, output);
-    task.testInput = input;
-    task.testOutput = output;
-    
-    return task;
+    auto records = arc::io::parseArcJson(jsonStr.data(), jsonStr.size(), "json_task");
+    return firstTask(expandRecords(records), "json_task");
 }
 
 ARCTask TaskLoader::loadFromFile(const std::string& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        throw std::runtime_error("无法打开文件: " + filepath);
+    return firstTask(loadTasksFromFile(filepath), filepath);
+}
+
+std::vector<ARCTask> TaskLoader::loadTasksFromFile(const std::string& filepath) {
+    arc::io::MappedFile file(filepath);
+    std::string taskId = std::filesystem::path(filepath).stem().string();
+    auto records = arc::io::parseArcJson(file.data(), file.size(), taskId);
+    return expandRecords(records);
+}
+
+std::vector<ARCTask> TaskLoader::loadTasksFromJson(const char* data, std::size_t size, const std::string& defaultId) {
+    auto records = arc::io::parseArcJson(data, size, defaultId);
+    return expandRecords(records);
+}
+
+std::vector<ARCTask> TaskLoader::loadChallenges(
+    const std::string& challengesPath,
+    const std::string& solutionsPath
+) {
+    arc::io::MappedFile challenges(challengesPath);
+    auto records = arc::io::parseChallengesJson(challenges.data(), challenges.size());
+    
+    if (!solutionsPath.empty()) {
+        arc::io::MappedFile solutions(solutionsPath);
+        arc::io::applySolutionsJson(solutions.data(), solutions.size(), records);
     }
     
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return loadFromJson(buffer.str());
+    return expandRecords(records);
 }
 
 std::vector<ARCTask> TaskLoader::loadFromDirectory(const std::string& dirPath) {
-    // 简化实现：返回单个测试任务
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(dirPath)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    
     std::vector<ARCTask> tasks;
-    tasks.push_back(loadFromJson("{}"));
+    for (const auto& file : files) {
+        auto fileTasks = loadTasksFromFile(file.string());
+        tasks.insert(tasks.end(),
+                     std::make_move_iterator(fileTasks.begin()),
+                     std::make_move_iterator(fileTasks.end()));
+    }
     return tasks;
 }
 
+std::vector<ARCTask> TaskLoader::loadCorpus(const std::string& corpusPath) {
+    arc::io::CorpusReader reader(corpusPath);
+    return readCorpus(reader);
+}
+
+std::vector<ARCTask> TaskLoader::loadCorpus(const char* data, std::size_t size) {
+    arc::io::CorpusReader reader(data, size);
+    return readCorpus(reader);
+}
+
 // ============================================================================
 // SolverFactory 实现
 // ============================================================================
@@ -448,6 +1054,23 @@ std::string colorRed(const std::string& text) {
     return "\033[1;31m" + text + "\033[0m";
 }
 
+namespace {
+
+void printPerfCounters(const arc::core::PerfStageCounts& counters) {
+    for (std::size_t i = 0; i < arc::core::SOLVE_STAGE_COUNT; ++i) {
+        const auto& stage = counters[i];
+        if (stage.cycles == 0) continue;
+        std::cout << "  " << arc::core::solveStageName(static_cast<arc::core::SolveStage>(i))
+                  << ": 周期=" << stage.cycles
+                  << ", 指令=" << stage.instructions
+                  << ", IPC=" << stage.ipc()
+                  << ", 缓存缺失=" << stage.cacheMisses
+                  << ", 分支预测失败=" << stage.branchMisses << std::endl;
+    }
+}
+
+} // namespace
+
 void printResult(int taskIndex, const std::string& taskId, const SolveResult& result) {
     std::cout << "任务 #" << taskIndex << " (" << taskId << "): ";
     
@@ -470,6 +1093,10 @@ void printResult(int taskIndex, const std::string& taskId, const SolveResult& re
               << "Pieces: " << result.totalPieces << ", "
               << "候选解: " << result.totalCandidates << ", "
               << "答案: " << result.answers.size() << std::endl;
+    
+    if (result.perfAvailable) {
+        printPerfCounters(result.perfCounters);
+    }
 }
 
 void printStatistics(const ARCSolver::Statistics& stats) {
@@ -483,6 +1110,198 @@ void printStatistics(const ARCSolver::Statistics& stats) {
               << " (" << (100.0 * stats.dimensionMatches / stats.totalTasks) << "%)" << std::endl;
     std::cout << "平均用时: " << stats.averageSolvingTime << "s" << std::endl;
     std::cout << "总用时: " << stats.totalTime << "s" << std::endl;
+    if (stats.cacheHits > 0) {
+        std::cout << "缓存命中: " << stats.cacheHits << std::endl;
+    }
+    
+    if (arc::core::allocAccountingEnabled()) {
+        std::cout << "堆高水位: " << (stats.peakHeapBytes / 1024.0 / 1024.0) << "MB" << std::endl;
+        std::cout << "分配统计:" << std::endl;
+        for (std::size_t i = 0; i < arc::core::SOLVE_STAGE_COUNT; ++i) {
+            const auto& counters = stats.allocations[i];
+            if (counters.allocations == 0 && counters.frees == 0) continue;
+            std::cout << "  " << arc::core::solveStageName(static_cast<arc::core::SolveStage>(i))
+                      << ": 分配=" << counters.allocations
+                      << ", 释放=" << counters.frees
+                      << ", 字节=" << (counters.bytesAllocated / 1024.0 / 1024.0) << "MB" << std::endl;
+        }
+    }
+    
+    if (stats.perfTasks > 0) {
+        std::cout << "性能计数器 (" << stats.perfTasks << " 个任务):" << std::endl;
+        printPerfCounters(stats.perfCounters);
+    }
+}
+
+// ============================================================================
+// 批量评估摘要实现
+// ============================================================================
+
+namespace {
+
+// 最近秩法分位数，sorted已升序
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    std::size_t rank = static_cast<std::size_t>(std::ceil(q * sorted.size() - 1e-9));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+const char* verdictName(SolveResult::Verdict verdict) {
+    switch (verdict) {
+        case SolveResult::Verdict::Correct: return "correct";
+        case SolveResult::Verdict::Dimensions: return "dimensions";
+        case SolveResult::Verdict::Candidate: return "candidate";
+        default: return "nothing";
+    }
+}
+
+void writeJsonString(std::ostream& out, const std::string& value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                << std::dec << std::setfill(' ');
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+std::size_t peakResidentBytes() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<std::size_t>(usage.ru_maxrss);          // macOS以字节为单位
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;   // Linux以KB为单位
+#endif
+}
+
+BatchSummary summarizeBatch(
+    const std::vector<ARCTask>& tasks,
+    const std::vector<SolveResult>& results,
+    double wallSeconds,
+    std::size_t threads
+) {
+    BatchSummary summary;
+    summary.tasks = results.size();
+    summary.threads = threads;
+    summary.wallSeconds = wallSeconds;
+    summary.tasksPerSecond = wallSeconds > 0.0 ? results.size() / wallSeconds : 0.0;
+    summary.peakRssBytes = peakResidentBytes();
+    
+    std::vector<double> latencies;
+    latencies.reserve(results.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const SolveResult& result = results[i];
+        latencies.push_back(result.solvingTime);
+        summary.peakHeapBytes = std::max(summary.peakHeapBytes, result.peakHeapBytes);
+        if (result.budgetExceeded) summary.budgetExceeded++;
+        if (i < tasks.size() && tasks[i].hasTestOutput()) summary.withGroundTruth++;
+        
+        switch (result.verdict) {
+            case SolveResult::Verdict::Correct: summary.correct++; break;
+            case SolveResult::Verdict::Dimensions: summary.dimensions++; break;
+            case SolveResult::Verdict::Candidate: summary.candidates++; break;
+            default: summary.nothing++; break;
+        }
+    }
+    
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        summary.latencyMean = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+        summary.latencyP50 = percentile(latencies, 0.50);
+        summary.latencyP90 = percentile(latencies, 0.90);
+        summary.latencyP99 = percentile(latencies, 0.99);
+        summary.latencyMax = latencies.back();
+    }
+    return summary;
+}
+
+void printBatchSummary(const BatchSummary& summary) {
+    auto percent = [&](std::size_t count) {
+        return summary.tasks > 0 ? 100.0 * count / summary.tasks : 0.0;
+    };
+    
+    std::cout << "\n=== 批量评估 ===" << std::endl;
+    std::cout << "任务数: " << summary.tasks << " (线程: " << summary.threads << ")" << std::endl;
+    std::cout << "正确: " << summary.correct << " (" << percent(summary.correct) << "%)";
+    if (summary.withGroundTruth > 0) {
+        std::cout << ", 准确率 " << (100.0 * summary.accuracy()) << "% / " << summary.withGroundTruth << " 个有答案";
+    }
+    std::cout << std::endl;
+    std::cout << "尺寸匹配: " << summary.dimensions << " (" << percent(summary.dimensions) << "%)" << std::endl;
+    std::cout << "候选解: " << summary.candidates << " (" << percent(summary.candidates) << "%)" << std::endl;
+    std::cout << "无解: " << summary.nothing << " (" << percent(summary.nothing) << "%)" << std::endl;
+    if (summary.budgetExceeded > 0) {
+        std::cout << "预算用尽: " << summary.budgetExceeded << std::endl;
+    }
+    std::cout << "总用时: " << summary.wallSeconds << "s, 吞吐: " << summary.tasksPerSecond << " 任务/s" << std::endl;
+    std::cout << "延迟: 平均=" << summary.latencyMean << "s, p50=" << summary.latencyP50
+              << "s, p90=" << summary.latencyP90 << "s, p99=" << summary.latencyP99
+              << "s, max=" << summary.latencyMax << "s" << std::endl;
+    std::cout << "峰值RSS: " << (summary.peakRssBytes / 1024.0 / 1024.0) << "MB" << std::endl;
+    if (summary.peakHeapBytes > 0) {
+        std::cout << "单任务最大堆高水位: " << (summary.peakHeapBytes / 1024.0 / 1024.0) << "MB" << std::endl;
+    }
+}
+
+void writeBatchReportJson(
+    const std::string& path,
+    const BatchSummary& summary,
+    const std::vector<ARCTask>& tasks,
+    const std::vector<SolveResult>& results
+) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("无法写入报告文件: " + path);
+    }
+    out << std::setprecision(9);
+    
+    out << "{\n  \"summary\": {"
+        << "\"tasks\": " << summary.tasks
+        << ", \"threads\": " << summary.threads
+        << ", \"correct\": " << summary.correct
+        << ", \"dimensions\": " << summary.dimensions
+        << ", \"candidates\": " << summary.candidates
+        << ", \"nothing\": " << summary.nothing
+        << ", \"budget_exceeded\": " << summary.budgetExceeded
+        << ", \"with_ground_truth\": " << summary.withGroundTruth
+        << ", \"accuracy\": " << summary.accuracy()
+        << ", \"wall_seconds\": " << summary.wallSeconds
+        << ", \"tasks_per_second\": " << summary.tasksPerSecond
+        << ", \"latency\": {\"mean\": " << summary.latencyMean
+        << ", \"p50\": " << summary.latencyP50
+        << ", \"p90\": " << summary.latencyP90
+        << ", \"p99\": " << summary.latencyP99
+        << ", \"max\": " << summary.latencyMax << "}"
+        << ", \"peak_rss_bytes\": " << summary.peakRssBytes
+        << ", \"peak_heap_bytes\": " << summary.peakHeapBytes
+        << "},\n  \"tasks\": [";
+    
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const SolveResult& result = results[i];
+        out << (i == 0 ? "\n    " : ",\n    ") << "{\"id\": ";
+        writeJsonString(out, i < tasks.size() ? tasks[i].taskId : std::string());
+        out << ", \"test_index\": " << (i < tasks.size() ? tasks[i].testIndex : 0)
+            << ", \"verdict\": \"" << verdictName(result.verdict) << "\""
+            << ", \"seconds\": " << result.solvingTime
+            << ", \"pieces\": " << result.totalPieces
+            << ", \"candidates\": " << result.totalCandidates
+            << ", \"budget_exceeded\": " << (result.budgetExceeded ? "true" : "false") << "}";
+    }
+    out << "\n  ]\n}\n";
+    
+    if (!out) {
+        throw std::runtime_error("写入报告文件失败: " + path);
+    }
 }
 
 } // namespace arc::solver 
\ No newline at end of file
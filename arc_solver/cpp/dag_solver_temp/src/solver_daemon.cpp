@@ -0,0 +1,390 @@
+#include "solver_daemon.hpp"
+#include "batch_journal.hpp"
+#include "core/log.hpp"
+#include "core/parallel.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace arc::solver {
+
+namespace {
+
+// ============================================================================
+// socket读写
+// ============================================================================
+
+bool recvAll(int fd, void* data, std::size_t size) {
+    auto* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::recv(fd, bytes, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        bytes += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// MSG_NOSIGNAL：客户端已断开时返回EPIPE而不是杀死守护进程
+bool sendAll(int fd, const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        bytes += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("socket路径为空或过长: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+int connectSocket(const std::string& path) {
+    const sockaddr_un address = socketAddress(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error("无法创建socket");
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+// ============================================================================
+// 连接与请求状态
+// ============================================================================
+
+struct SolverDaemon::Connection {
+    int fd = -1;
+    std::mutex writeMutex;                     // 多个工作线程向同一连接写响应帧
+    std::atomic<bool> alive{true};             // 写失败后置false，其余任务不再求解
+
+    explicit Connection(int fd_) : fd(fd_) {}
+    ~Connection() { ::close(fd); }
+
+    void send(std::uint32_t requestId, ResponseKind kind, const std::string& payload) {
+        if (!alive) return;
+        ResponseHeader header{};
+        header.magic = DAEMON_RESPONSE_MAGIC;
+        header.requestId = requestId;
+        header.kind = static_cast<std::uint8_t>(kind);
+        header.payloadBytes = static_cast<std::uint32_t>(payload.size());
+
+        std::lock_guard<std::mutex> lock(writeMutex);
+        if (!sendAll(fd, &header, sizeof(header)) || !sendAll(fd, payload.data(), payload.size())) {
+            alive = false;
+        }
+    }
+
+    void sendDone(std::uint32_t requestId, std::uint32_t results) {
+        send(requestId, ResponseKind::Done, std::string(reinterpret_cast<const char*>(&results), sizeof(results)));
+    }
+};
+
+struct SolverDaemon::Request {
+    std::uint32_t id = 0;
+    double timeBudget = 0.0;
+    std::vector<ARCTask> tasks;
+    std::atomic<std::size_t> remaining{0};
+    std::atomic<std::uint32_t> sent{0};
+};
+
+// ============================================================================
+// SolverDaemon
+// ============================================================================
+
+SolverDaemon::SolverDaemon(const SolverConfig& solverConfig, const Config& config)
+    : solverConfig_(solverConfig), config_(config) {
+    solverConfig_.printTimes = false;
+    solverConfig_.printMemory = false;
+}
+
+SolverDaemon::~SolverDaemon() {
+    stop();
+}
+
+void SolverDaemon::stop() {
+    stopping_.store(true);
+    const int fd = listenFd_.load();
+    if (fd >= 0) {
+        ::shutdown(fd, SHUT_RDWR);   // 唤醒阻塞在accept()上的run()
+    }
+}
+
+void SolverDaemon::run() {
+    const sockaddr_un address = socketAddress(config_.socketPath);
+
+    // 残留的socket文件（上次未正常退出）可以删除，仍有进程在监听时拒绝启动
+    if (::access(config_.socketPath.c_str(), F_OK) == 0) {
+        int probe = connectSocket(config_.socketPath);
+        if (probe >= 0) {
+            ::close(probe);
+            throw std::runtime_error("已有守护进程在监听: " + config_.socketPath);
+        }
+        ::unlink(config_.socketPath.c_str());
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error("无法创建socket");
+    }
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 64) != 0) {
+        ::close(fd);
+        throw std::runtime_error("无法监听 " + config_.socketPath + ": " + std::strerror(errno));
+    }
+    listenFd_.store(fd);
+
+    // 工作线程在接受连接前就构建好求解组件
+    numWorkers_ = arc::core::resolveThreadCount(config_.workers, ~std::size_t{0});
+    workersStop_ = false;
+    for (std::size_t i = 0; i < numWorkers_; ++i) {
+        workers_.emplace_back(&SolverDaemon::workerLoop, this);
+    }
+    ARC_LOG_INFO("守护进程监听 " << config_.socketPath << "，" << numWorkers_ << " 个求解线程");
+
+    while (!stopping_.load()) {
+        int client = ::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;   // stop()关闭了监听socket
+        }
+
+        auto connection = std::make_shared<Connection>(client);
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex_);
+            connections_.erase(std::remove_if(connections_.begin(), connections_.end(),
+                                              [](const auto& weak) { return weak.expired(); }),
+                               connections_.end());
+            connections_.push_back(connection);
+            ++activeConnections_;
+        }
+        std::thread(&SolverDaemon::serveConnection, this, std::move(connection)).detach();
+    }
+
+    // 关闭所有连接的读端，等读取线程退出，再停止工作线程
+    listenFd_.store(-1);
+    ::close(fd);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);   // 与enqueue的等待条件同步
+    }
+    queueSpace_.notify_all();
+    {
+        std::unique_lock<std::mutex> lock(connectionsMutex_);
+        for (const auto& weak : connections_) {
+            if (auto connection = weak.lock()) {
+                ::shutdown(connection->fd, SHUT_RDWR);
+            }
+        }
+        connectionsDone_.wait(lock, [&]() { return activeConnections_ == 0; });
+        connections_.clear();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        workersStop_ = true;
+    }
+    queueReady_.notify_all();
+    queueSpace_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    queue_.clear();
+
+    ::unlink(config_.socketPath.c_str());
+    ARC_LOG_INFO("守护进程退出，共处理 " << requests_.load() << " 个请求、" << tasks_.load() << " 个任务");
+}
+
+void SolverDaemon::serveConnection(std::shared_ptr<Connection> connection) {
+    RequestHeader header;
+    std::string payload;
+
+    while (!stopping_.load() && recvAll(connection->fd, &header, sizeof(header))) {
+        if (header.magic != DAEMON_REQUEST_MAGIC) {
+            connection->send(header.requestId, ResponseKind::Error, "请求头magic不匹配");
+            break;   // 无法再定位下一个请求的边界
+        }
+        if (header.payloadBytes > config_.maxRequestBytes) {
+            connection->send(header.requestId, ResponseKind::Error, "请求负载超过上限");
+            break;
+        }
+        payload.resize(header.payloadBytes);
+        if (!recvAll(connection->fd, payload.data(), payload.size())) {
+            break;
+        }
+
+        auto request = std::make_shared<Request>();
+        request->id = header.requestId;
+        request->timeBudget = header.timeBudget;
+        try {
+            if (header.format == static_cast<std::uint8_t>(RequestFormat::Json)) {
+                request->tasks = TaskLoader::loadTasksFromJson(payload.data(), payload.size(),
+                                                               "request_" + std::to_string(header.requestId));
+            } else if (header.format == static_cast<std::uint8_t>(RequestFormat::Corpus)) {
+                request->tasks = TaskLoader::loadCorpus(payload.data(), payload.size());
+            } else {
+                throw std::runtime_error("未知的请求格式");
+            }
+        } catch (const std::exception& e) {
+            connection->send(header.requestId, ResponseKind::Error, e.what());
+            connection->sendDone(header.requestId, 0);
+            continue;
+        }
+
+        ++requests_;
+        if (request->tasks.empty()) {
+            connection->sendDone(header.requestId, 0);
+            continue;
+        }
+        enqueue(connection, request);
+    }
+
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    --activeConnections_;
+    connectionsDone_.notify_all();
+}
+
+void SolverDaemon::enqueue(const std::shared_ptr<Connection>& connection, const std::shared_ptr<Request>& request) {
+    request->remaining = request->tasks.size();
+    for (std::size_t i = 0; i < request->tasks.size(); ++i) {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        queueSpace_.wait(lock, [&]() { return queue_.size() < config_.maxQueuedTasks || stopping_.load(); });
+        if (stopping_.load()) return;   // 连接即将关闭，剩余任务不再排队
+        queue_.push_back(Job{connection, request, i});
+        lock.unlock();
+        queueReady_.notify_one();
+    }
+}
+
+void SolverDaemon::workerLoop() {
+    SolverConfig workerConfig = solverConfig_;
+    workerConfig.batchThreads = 1;
+    if (numWorkers_ > 1) {
+        workerConfig.scoringThreads = 1;
+    }
+    // 每个线程的求解组件跨请求复用
+    ARCSolver solver(workerConfig);
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueReady_.wait(lock, [&]() { return !queue_.empty() || workersStop_; });
+            if (workersStop_) return;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        queueSpace_.notify_one();
+
+        if (job.connection->alive) {
+            const double budget = job.request->timeBudget > 0.0 ? job.request->timeBudget : workerConfig.timeBudget;
+            if (solver.getConfig().timeBudget != budget) {
+                SolverConfig taskConfig = workerConfig;
+                taskConfig.timeBudget = budget;
+                solver.setConfig(taskConfig);
+            }
+
+            const ARCTask& task = job.request->tasks[job.index];
+            SolveResult result = solver.solve(task);
+            job.connection->send(job.request->id, ResponseKind::Result, encodeTaskResult(task, result));
+            ++job.request->sent;
+            ++tasks_;
+        }
+        finishJob(job);
+    }
+}
+
+void SolverDaemon::finishJob(const Job& job) {
+    if (--job.request->remaining == 0) {
+        job.connection->sendDone(job.request->id, job.request->sent.load());
+    }
+}
+
+// ============================================================================
+// SolverClient
+// ============================================================================
+
+SolverClient::SolverClient(const std::string& socketPath) {
+    fd_ = connectSocket(socketPath);
+    if (fd_ < 0) {
+        throw std::runtime_error("无法连接守护进程: " + socketPath);
+    }
+}
+
+SolverClient::~SolverClient() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+std::size_t SolverClient::solve(const std::string& payload, RequestFormat format, double timeBudget,
+                                const ResultCallback& onResult) {
+    RequestHeader header{};
+    header.magic = DAEMON_REQUEST_MAGIC;
+    header.format = static_cast<std::uint8_t>(format);
+    header.requestId = nextRequestId_++;
+    header.timeBudget = static_cast<float>(timeBudget);
+    header.payloadBytes = static_cast<std::uint32_t>(payload.size());
+    if (!sendAll(fd_, &header, sizeof(header)) || !sendAll(fd_, payload.data(), payload.size())) {
+        throw std::runtime_error("向守护进程发送请求失败");
+    }
+
+    std::size_t received = 0;
+    std::string error;
+    std::string buffer;
+    while (true) {
+        ResponseHeader response;
+        if (!recvAll(fd_, &response, sizeof(response)) || response.magic != DAEMON_RESPONSE_MAGIC) {
+            throw std::runtime_error("守护进程连接中断");
+        }
+        buffer.resize(response.payloadBytes);
+        if (!recvAll(fd_, buffer.data(), buffer.size())) {
+            throw std::runtime_error("守护进程连接中断");
+        }
+        if (response.requestId != header.requestId) {
+            continue;
+        }
+
+        const auto kind = static_cast<ResponseKind>(response.kind);
+        if (kind == ResponseKind::Result) {
+            std::string taskId;
+            std::size_t testIndex = 0;
+            SolveResult result;
+            if (!decodeTaskResult(buffer.data(), buffer.size(), taskId, testIndex, result)) {
+                throw std::runtime_error("无法解析守护进程返回的结果");
+            }
+            ++received;
+            if (onResult) {
+                onResult(taskId, testIndex, result);
+            }
+        } else if (kind == ResponseKind::Error) {
+            error = buffer;
+        } else {
+            break;
+        }
+    }
+
+    if (!error.empty()) {
+        throw std::runtime_error("守护进程: " + error);
+    }
+    return received;
+}
+
+} // namespace arc::solver
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <queue>
 #include <cassert>
+#include <mutex>
 
 namespace arc::transform {
 
@@ -680,8 +681,8 @@ arc::core::Grid majorityCol(const arc::core::Grid& img) {
 // 变换函数注册
 // ============================================================================
 
-// 初始化所有变换函数 - 对应icecuber的initFuncs3
-void initializeTransformFunctions() {
+// 注册所有变换函数 - 对应icecuber的initFuncs3
+static void registerTransformFunctions() {
     auto& lib = TransformLibrary::instance();
     
     // 基础几何变换
@@ -775,4 +776,10 @@ void initializeTransformFunctions() {
     }, 15);
 }
 
-} // namespace arc::transform 
\ No newline at end of file
+// 全局函数库只注册一次，多个求解器或工作线程重复调用是安全的
+void initializeTransformFunctions() {
+    static std::once_flag once;
+    std::call_once(once, registerTransformFunctions);
+}
+
+} // namespace arc::transform 
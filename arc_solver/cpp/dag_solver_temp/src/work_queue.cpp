@@ -0,0 +1,558 @@
+#include "work_queue.hpp"
+#include "batch_journal.hpp"
+#include "result_cache.hpp"
+#include "scheduler.hpp"
+#include "core/log.hpp"
+#include "core/parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace arc::solver {
+
+// 帧内整数直接按内存布局传输，各机器须为同一字节序
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "工作队列协议假定小端序");
+
+namespace {
+
+// ============================================================================
+// 协议：帧 = {类型, 负载长度} + 负载
+// ============================================================================
+
+constexpr std::uint32_t PROTOCOL_VERSION = 2;
+
+enum class Message : std::uint32_t {
+    Hello = 1,         // 工作 -> 协调：{协议版本 u32, 任务集指纹 u64}
+    Welcome = 2,       // 协调 -> 工作：{心跳间隔毫秒 u32}
+    Reject = 3,        // 协调 -> 工作：错误信息
+    Request = 4,       // 工作 -> 协调：领取一个任务
+    Assign = 5,        // 协调 -> 工作：{任务下标 u32, 租约 u64}
+    Wait = 6,          // 协调 -> 工作：{重试间隔毫秒 u32}，暂无可分发的任务但仍有租约未完成
+    Finished = 7,      // 协调 -> 工作：全部完成，断开
+    Heartbeat = 8,     // 工作 -> 协调：{任务下标 u32, 租约 u64}
+    Result = 9         // 工作 -> 协调：{任务下标 u32, 租约 u64} + encodeTaskResult
+};
+
+struct FrameHeader {
+    std::uint32_t type;
+    std::uint32_t payloadBytes;
+};
+
+constexpr std::size_t MAX_FRAME_BYTES = 64u << 20;
+
+template <typename T>
+void put(std::string& buffer, const T& value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T get(const std::string& buffer, std::size_t offset) {
+    T value{};
+    if (offset + sizeof(T) <= buffer.size()) {
+        std::memcpy(&value, buffer.data() + offset, sizeof(T));
+    }
+    return value;
+}
+
+bool recvAll(int fd, void* data, std::size_t size) {
+    auto* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::recv(fd, bytes, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        bytes += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool sendAll(int fd, const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        bytes += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool sendFrame(int fd, Message type, const std::string& payload = std::string()) {
+    std::string frame;
+    frame.reserve(sizeof(FrameHeader) + payload.size());
+    put(frame, FrameHeader{static_cast<std::uint32_t>(type), static_cast<std::uint32_t>(payload.size())});
+    frame += payload;
+    return sendAll(fd, frame.data(), frame.size());
+}
+
+bool recvFrame(int fd, Message& type, std::string& payload) {
+    FrameHeader header;
+    if (!recvAll(fd, &header, sizeof(header)) || header.payloadBytes > MAX_FRAME_BYTES) {
+        return false;
+    }
+    type = static_cast<Message>(header.type);
+    payload.resize(header.payloadBytes);
+    return recvAll(fd, payload.data(), payload.size());
+}
+
+std::string leasePayload(std::uint32_t index, std::uint64_t lease) {
+    std::string payload;
+    put(payload, index);
+    put(payload, lease);
+    return payload;
+}
+
+int connectTcp(const std::string& host, int port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        throw std::runtime_error("无法解析地址: " + host);
+    }
+
+    int fd = -1;
+    for (addrinfo* address = addresses; address && fd < 0; address = address->ai_next) {
+        fd = ::socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd >= 0 && ::connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ::freeaddrinfo(addresses);
+
+    if (fd >= 0) {
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+} // namespace
+
+std::uint64_t taskSetFingerprint(const std::vector<ARCTask>& tasks) {
+    std::uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&](const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    for (const auto& task : tasks) {
+        mix(task.taskId.data(), task.taskId.size());
+        const std::uint64_t testIndex = task.testIndex;
+        mix(&testIndex, sizeof(testIndex));
+    }
+    return hash;
+}
+
+// ============================================================================
+// BatchCoordinator
+// ============================================================================
+
+BatchCoordinator::BatchCoordinator(const Config& config) : config_(config) {}
+
+std::vector<SolveResult> BatchCoordinator::run(ARCSolver& solver, const std::vector<ARCTask>& tasks) {
+    enum class State { Pending, Leased, Done };
+    struct TaskState {
+        State state = State::Pending;
+        std::size_t attempts = 0;
+        std::uint64_t lease = 0;
+        int holder = -1;               // 持有租约的连接
+        double expiry = 0.0;
+    };
+    struct Connection {
+        std::string buffer;            // 尚未凑成完整帧的字节
+        bool greeted = false;
+    };
+
+    std::vector<SolveResult> results(tasks.size());
+    std::vector<TaskState> states(tasks.size());
+    std::size_t done = 0;
+    failures_.clear();
+    reassignments_ = 0;
+    workersSeen_ = 0;
+
+    // 复用批量运行日志：已记录的任务直接完成
+    std::unique_ptr<BatchJournal> journal;
+    std::vector<std::size_t> pending(tasks.size());
+    std::iota(pending.begin(), pending.end(), std::size_t{0});
+    if (!solver.getConfig().journalPath.empty()) {
+        journal = std::make_unique<BatchJournal>(solver.getConfig().journalPath,
+                                                 solverFingerprint(solver.getConfig()));
+        pending = journal->restore(tasks, results);
+        for (std::size_t i = 0, next = 0; i < tasks.size(); ++i) {
+            if (next < pending.size() && pending[next] == i) {
+                ++next;
+            } else {
+                states[i].state = State::Done;
+                solver.recordResult(results[i]);
+                ++done;
+            }
+        }
+        ARC_LOG_INFO("从日志恢复 " << done << " 个任务");
+    }
+    if (done == tasks.size()) {
+        return results;
+    }
+
+    // 与solveBatch相同，预计耗时长的任务先分发
+    std::vector<double> costs(tasks.size());
+    for (std::size_t index : pending) {
+        costs[index] = predictTaskCost(tasks[index]);
+    }
+    std::stable_sort(pending.begin(), pending.end(), [&](std::size_t a, std::size_t b) {
+        return costs[a] > costs[b];
+    });
+    std::deque<std::size_t> queue(pending.begin(), pending.end());
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(config_.port));
+    if (::inet_pton(AF_INET, config_.bindAddress.c_str(), &address.sin_addr) != 1) {
+        throw std::runtime_error("无效的监听地址: " + config_.bindAddress);
+    }
+    int listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int one = 1;
+    ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd, 64) != 0) {
+        if (listenFd >= 0) ::close(listenFd);
+        throw std::runtime_error("无法监听端口 " + std::to_string(config_.port) + ": " + std::strerror(errno));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto now = [&]() { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+    const std::uint32_t heartbeatMs = static_cast<std::uint32_t>(std::max(1.0, config_.leaseTimeout * 1000.0 / 3.0));
+    const std::uint32_t retryMs = std::min<std::uint32_t>(1000, heartbeatMs);
+    const std::uint64_t fingerprint = taskSetFingerprint(tasks);
+
+    std::map<int, Connection> connections;
+    std::uint64_t nextLease = 1;
+
+    // 失败的任务只在内存中记为完成，不写日志，协调进程重启后重新分发
+    auto complete = [&](std::size_t index, SolveResult result, bool journaled) {
+        states[index].state = State::Done;
+        states[index].holder = -1;
+        results[index] = std::move(result);
+        solver.recordResult(results[index]);
+        if (journal && journaled) {
+            journal->append(tasks[index], results[index]);
+        }
+        ++done;
+    };
+
+    // 收回租约：重新排到队首，收回次数过多时记为失败
+    auto reclaim = [&](std::size_t index, const std::string& reason) {
+        TaskState& task = states[index];
+        if (++task.attempts >= config_.maxAttempts) {
+            ARC_LOG_WARN("任务 " << tasks[index].taskId << " " << reason << "（第 " << task.attempts << " 次），记为失败");
+            failures_.push_back({index, reason});
+            complete(index, SolveResult{}, false);
+            return;
+        }
+        ARC_LOG_WARN("任务 " << tasks[index].taskId << " " << reason << "，重新分发");
+        task.state = State::Pending;
+        task.holder = -1;
+        queue.push_front(index);
+        ++reassignments_;
+    };
+
+    auto drop = [&](int fd) {
+        ::close(fd);
+        connections.erase(fd);
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            if (states[i].state == State::Leased && states[i].holder == fd) {
+                reclaim(i, "所在工作进程断开");
+            }
+        }
+    };
+
+    // 处理一帧，返回false表示应断开该连接
+    auto handle = [&](int fd, Connection& connection, Message type, const std::string& payload) {
+        if (type == Message::Hello) {
+            if (get<std::uint32_t>(payload, 0) != PROTOCOL_VERSION ||
+                get<std::uint64_t>(payload, sizeof(std::uint32_t)) != fingerprint) {
+                sendFrame(fd, Message::Reject, "协议版本或任务集与协调进程不一致");
+                return false;
+            }
+            connection.greeted = true;
+            ++workersSeen_;
+            std::string welcome;
+            put(welcome, heartbeatMs);
+            return sendFrame(fd, Message::Welcome, welcome);
+        }
+        if (!connection.greeted) {
+            return false;
+        }
+
+        if (type == Message::Request) {
+            while (!queue.empty() && states[queue.front()].state != State::Pending) {
+                queue.pop_front();   // 收回后又收到了迟到的结果
+            }
+            if (queue.empty()) {
+                std::string wait;
+                put(wait, retryMs);
+                return sendFrame(fd, Message::Wait, wait);
+            }
+            const std::size_t index = queue.front();
+            queue.pop_front();
+            TaskState& task = states[index];
+            task.state = State::Leased;
+            task.lease = nextLease++;
+            task.holder = fd;
+            task.expiry = now() + config_.leaseTimeout;
+            return sendFrame(fd, Message::Assign, leasePayload(static_cast<std::uint32_t>(index), task.lease));
+        }
+
+        const std::size_t index = get<std::uint32_t>(payload, 0);
+        const std::uint64_t lease = get<std::uint64_t>(payload, sizeof(std::uint32_t));
+        if (index >= tasks.size()) {
+            return false;
+        }
+        if (type == Message::Heartbeat) {
+            TaskState& task = states[index];
+            if (task.state == State::Leased && task.lease == lease) {
+                task.expiry = now() + config_.leaseTimeout;
+            }
+            return true;
+        }
+        if (type == Message::Result) {
+            // 租约已被收回但任务仍未完成时照样接受，先到的结果为准
+            const std::size_t offset = sizeof(std::uint32_t) + sizeof(std::uint64_t);
+            std::string taskId;
+            std::size_t testIndex = 0;
+            SolveResult result;
+            if (payload.size() < offset ||
+                !decodeTaskResult(payload.data() + offset, payload.size() - offset, taskId, testIndex, result) ||
+                taskId != tasks[index].taskId || testIndex != tasks[index].testIndex) {
+                return false;
+            }
+            if (states[index].state != State::Done) {
+                complete(index, std::move(result), true);
+            }
+            return true;
+        }
+        return false;
+    };
+
+    ARC_LOG_INFO("协调进程监听 " << config_.bindAddress << ":" << config_.port << "，待分发 " << queue.size() << " 个任务");
+
+    try {
+        while (done < tasks.size()) {
+            std::vector<pollfd> fds;
+            fds.push_back({listenFd, POLLIN, 0});
+            for (const auto& entry : connections) {
+                fds.push_back({entry.first, POLLIN, 0});
+            }
+            ::poll(fds.data(), fds.size(), config_.pollIntervalMs);
+
+            if (fds[0].revents & POLLIN) {
+                int client = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client >= 0) {
+                    ::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    connections[client] = Connection{};
+                }
+            }
+
+            for (std::size_t i = 1; i < fds.size(); ++i) {
+                if ((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) == 0) continue;
+                const int fd = fds[i].fd;
+                Connection& connection = connections[fd];
+
+                char chunk[65536];
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) {
+                    drop(fd);
+                    continue;
+                }
+                connection.buffer.append(chunk, static_cast<std::size_t>(n));
+
+                // 逐帧处理缓冲区中已完整的帧
+                bool keep = true;
+                std::size_t consumed = 0;
+                while (keep && connection.buffer.size() - consumed >= sizeof(FrameHeader)) {
+                    FrameHeader header;
+                    std::memcpy(&header, connection.buffer.data() + consumed, sizeof(header));
+                    if (header.payloadBytes > MAX_FRAME_BYTES) {
+                        keep = false;
+                        break;
+                    }
+                    if (connection.buffer.size() - consumed < sizeof(header) + header.payloadBytes) break;
+                    const std::string payload = connection.buffer.substr(consumed + sizeof(header), header.payloadBytes);
+                    consumed += sizeof(header) + header.payloadBytes;
+                    keep = handle(fd, connection, static_cast<Message>(header.type), payload);
+                }
+                if (!keep) {
+                    drop(fd);
+                    continue;
+                }
+                connection.buffer.erase(0, consumed);
+            }
+
+            // 心跳超时的租约
+            const double t = now();
+            for (std::size_t i = 0; i < states.size(); ++i) {
+                if (states[i].state == State::Leased && t > states[i].expiry) {
+                    reclaim(i, "租约超时");
+                }
+            }
+        }
+    } catch (...) {
+        for (const auto& entry : connections) {
+            ::close(entry.first);
+        }
+        ::close(listenFd);
+        throw;
+    }
+
+    for (const auto& entry : connections) {
+        sendFrame(entry.first, Message::Finished);
+        ::close(entry.first);
+    }
+    ::close(listenFd);
+    if (journal) {
+        journal->sync();
+    }
+    return results;
+}
+
+// ============================================================================
+// BatchWorker
+// ============================================================================
+
+BatchWorker::BatchWorker(const Config& config) : config_(config) {}
+
+std::size_t BatchWorker::run(const SolverConfig& solverConfig, const std::vector<ARCTask>& tasks) {
+    const std::size_t threads = arc::core::resolveThreadCount(config_.threads, ~std::size_t{0});
+
+    // 每个连接一个求解线程，线程之间已经并行，任务内部不再开评分线程
+    SolverConfig workerConfig = solverConfig;
+    workerConfig.batchThreads = 1;
+    if (threads > 1) {
+        workerConfig.scoringThreads = 1;
+    }
+
+    std::atomic<std::size_t> solved{0};
+    arc::core::parallelWorkers(threads, [&](std::size_t) {
+        solved += serve(workerConfig, tasks);
+    });
+    return solved.load();
+}
+
+std::size_t BatchWorker::serve(const SolverConfig& solverConfig, const std::vector<ARCTask>& tasks) {
+    // 协调进程可能还没启动，重试到connectTimeout
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(config_.connectTimeout);
+    int fd = connectTcp(config_.host, config_.port);
+    while (fd < 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        fd = connectTcp(config_.host, config_.port);
+    }
+    if (fd < 0) {
+        throw std::runtime_error("无法连接协调进程 " + config_.host + ":" + std::to_string(config_.port));
+    }
+
+    std::string hello;
+    put(hello, PROTOCOL_VERSION);
+    put(hello, taskSetFingerprint(tasks));
+    Message type;
+    std::string payload;
+    if (!sendFrame(fd, Message::Hello, hello) || !recvFrame(fd, type, payload)) {
+        ::close(fd);
+        throw std::runtime_error("与协调进程握手失败");
+    }
+    if (type != Message::Welcome) {
+        ::close(fd);
+        throw std::runtime_error("协调进程拒绝连接: " + payload);
+    }
+    const auto heartbeatInterval = std::chrono::milliseconds(get<std::uint32_t>(payload, 0));
+
+    // 心跳线程：求解期间定时续租，与主线程共用socket，写入互斥
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stop = false;
+    bool solving = false;
+    std::string heartbeat;
+    std::thread heartbeatThread([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop) {
+            wake.wait_for(lock, heartbeatInterval);
+            if (!stop && solving) {
+                sendFrame(fd, Message::Heartbeat, heartbeat);
+            }
+        }
+    });
+
+    auto send = [&](Message message, const std::string& body) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sendFrame(fd, message, body);
+    };
+
+    ARCSolver solver(solverConfig);
+    std::size_t solved = 0;
+    bool finished = false;
+    while (!finished) {
+        if (!send(Message::Request, std::string()) || !recvFrame(fd, type, payload)) {
+            // 协调进程已退出（全部完成后关闭连接，或异常终止）
+            ARC_LOG_WARN("与协调进程的连接中断");
+            break;
+        }
+
+        if (type == Message::Assign) {
+            const std::uint32_t index = get<std::uint32_t>(payload, 0);
+            const std::uint64_t lease = get<std::uint64_t>(payload, sizeof(std::uint32_t));
+            if (index >= tasks.size()) {
+                ARC_LOG_ERROR("协调进程分发的任务下标越界: " << index);
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                heartbeat = leasePayload(index, lease);
+                solving = true;
+            }
+            SolveResult result = solver.solve(tasks[index]);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                solving = false;
+            }
+            if (!send(Message::Result, leasePayload(index, lease) + encodeTaskResult(tasks[index], result))) {
+                break;
+            }
+            ++solved;
+        } else if (type == Message::Wait) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(get<std::uint32_t>(payload, 0)));
+        } else {
+            finished = true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_all();
+    heartbeatThread.join();
+    ::close(fd);
+    return solved;
+}
+
+} // namespace arc::solver
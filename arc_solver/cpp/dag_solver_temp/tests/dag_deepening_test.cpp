@@ -0,0 +1,87 @@
+// 迭代加深一致性检查：先建到深度1再逐层extendDepth，与一次建到目标深度得到相同的节点数
+// 变换函数包含代价为2的函数，覆盖子节点越过深度上限、父节点留在边界上的情况
+//
+// 构建与运行：arc_solver/cpp/CMakeLists.txt中的dag_deepening_test目标（ctest），或在arc_solver/cpp下
+//   g++ -std=c++17 -Idag_solver_temp/include dag_solver_temp/tests/dag_deepening_test.cpp \
+//       dag_solver_temp/src/core/{dag,state,deadline,stage,alloc_stats,perf_counters}.cpp -o dag_deepening_test
+//   ./dag_deepening_test
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include "core/dag.hpp"
+
+using namespace arc::core;
+
+namespace {
+
+// 像素逐个映射的变换，足够产生重复状态和不同深度的同一图像
+template <typename F>
+void registerPixelMap(DAG& dag, const std::string& name, std::uint8_t cost, F map) {
+    dag.registerFunction(name, [map](const State& input, State& output) {
+        output.images = input.images;
+        output.isVector = input.isVector;
+        for (auto& grid : output.images) {
+            for (auto& pixel : grid.pixels) {
+                pixel = map(pixel);
+            }
+        }
+        return true;
+    }, cost);
+}
+
+DAG makeDAG(std::size_t maxDepth, bool withCost2) {
+    DAG::Config config;
+    config.maxDepth = maxDepth;
+    DAG dag(config);
+    registerPixelMap(dag, "shift", 1, [](std::uint8_t p) { return static_cast<std::uint8_t>((p + 1) % 10); });
+    registerPixelMap(dag, "double", 1, [](std::uint8_t p) { return static_cast<std::uint8_t>(p * 2 % 10); });
+    dag.registerFunction("reverse", [](const State& input, State& output) {
+        output.images = input.images;
+        output.isVector = input.isVector;
+        for (auto& grid : output.images) {
+            std::reverse(grid.pixels.begin(), grid.pixels.end());
+        }
+        return true;
+    });
+    if (withCost2) {
+        registerPixelMap(dag, "square", 2, [](std::uint8_t p) { return static_cast<std::uint8_t>((p * p + 3) % 10); });
+    }
+
+    Grid grid(3, 2);
+    for (std::size_t i = 0; i < grid.pixels.size(); ++i) {
+        grid.pixels[i] = static_cast<std::uint8_t>(i);
+    }
+    State root;
+    root.images = {grid};
+    root.depth = 0;
+    dag.addRootNode(root);
+    return dag;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    for (bool withCost2 : {false, true}) {
+        for (std::size_t depth = 1; depth <= 7; ++depth) {
+            DAG oneGo = makeDAG(depth, withCost2);
+            oneGo.buildDAG();
+
+            DAG incremental = makeDAG(1, withCost2);
+            incremental.buildDAG();
+            for (std::size_t d = 2; d <= depth; ++d) {
+                incremental.extendDepth(d);
+            }
+
+            if (oneGo.getNodeCount() != incremental.getNodeCount()) {
+                std::printf("FAIL cost2=%d depth=%zu: 一次构建%zu个节点，逐层加深%zu个节点\n",
+                            withCost2 ? 1 : 0, depth, oneGo.getNodeCount(), incremental.getNodeCount());
+                ++failures;
+            }
+        }
+    }
+    if (failures == 0) {
+        std::printf("dag_deepening_test: OK\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
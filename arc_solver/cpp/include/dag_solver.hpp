@@ -3,8 +3,10 @@
 #include <vector>
 #include <memory>
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <unordered_map>
+#include "core/deadline.hpp"
 
 namespace arc_solver {
 
@@ -55,6 +57,7 @@ struct SolverConfig {
     int maxPixels = 8000;
     float complexityPenalty = 0.01f;
     std::size_t maxAnswers = 3;
+    std::size_t batchThreads = 0;   // solveBatch的工作线程数，0表示使用硬件并发数
     bool printTimes = false;
     bool printMemory = false;
     bool printNodes = false;
@@ -73,6 +76,17 @@ struct SolveResult {
     Verdict verdict = Verdict::Nothing;
 };
 
+// 渐进式答案更新
+struct AnswerUpdate {
+    std::vector<std::vector<std::vector<int>>> answers;
+    float score = 0.0f;          // 当前最佳答案在训练样例上的匹配比例
+    double elapsed = 0.0;        // 自开始求解经过的秒数
+    std::string stage;
+    bool final = false;
+};
+
+using AnswerCallback = std::function<void(const AnswerUpdate&)>;
+
 // 任务定义
 struct ARCExample {
     Grid input;
@@ -102,8 +116,18 @@ public:
         const std::vector<std::vector<std::vector<int>>>& train_outputs,
         const std::vector<std::vector<std::vector<int>>>& test_inputs);
     
+    // 渐进式求解：答案集一有改进就回调onUpdate，最后一次回调的final为true
+    // deadline过期或被取消时停止搜索，以已找到的答案发出final更新
+    void solveStreaming(
+        const std::vector<std::vector<std::vector<int>>>& train_inputs,
+        const std::vector<std::vector<std::vector<int>>>& train_outputs,
+        const std::vector<std::vector<std::vector<int>>>& test_inputs,
+        const AnswerCallback& onUpdate,
+        const arc::core::Deadline& deadline = arc::core::Deadline());
+    
     // DAG特有的方法
     SolveResult solveSingle(const ARCTask& task);
+    // 多线程批量求解：每个工作线程独立的Impl，预计耗时长的任务先分发，结果按输入顺序返回
     std::vector<SolveResult> solveBatch(const std::vector<ARCTask>& tasks);
     
     // 配置和统计
@@ -121,6 +145,7 @@ private:
     std::unique_ptr<Impl> impl_;
     
     // 辅助方法
+    SolveResult solveWith(Impl& impl, const ARCTask& task) const;
     Grid convertFromVector(const std::vector<std::vector<int>>& input);
     std::vector<std::vector<int>> convertToVector(const Grid& grid);
     ARCTask convertTask(const std::vector<std::vector<std::vector<int>>>& train_inputs,
@@ -13,10 +13,20 @@ ext_modules = [
             "src/chess_solver.cpp",
             "src/tiling_solver.cpp",
             "src/ml_solver.cpp",
+            "src/dag_solver.cpp",
+            "dag_solver_temp/src/core/deadline.cpp",
+            "dag_solver_temp/src/core/packed.cpp",
+            "dag_solver_temp/src/io/mapped_file.cpp",
+            "dag_solver_temp/src/io/arc_json.cpp",
+            "dag_solver_temp/src/io/corpus.cpp",
+            "dag_solver_temp/src/core/log.cpp",
+            "dag_solver_temp/src/batch_journal.cpp",
+            "dag_solver_temp/src/shared_store.cpp",
             "bindings/bindings.cpp",
         ],
         include_dirs=[
             "include",
+            "dag_solver_temp/include",
             pybind11.get_include(),
         ],
         language="c++",
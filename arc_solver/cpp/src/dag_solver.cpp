@@ -1,9 +1,13 @@
 #include "../include/dag_solver.hpp"
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <exception>
 #include <iostream>
 #include <cmath>
+#include <numeric>
 #include <random>
+#include <thread>
 #include <unordered_set>
 
 namespace arc_solver {
@@ -156,9 +160,31 @@ public:
         return input;
     }
     
-    // 简化的DAG搜索
-    std::vector<Grid> searchSolutions(const ARCTask& task, const SolverConfig& config) {
+    // 变换在训练样例上的匹配比例
+    float trainingScore(const std::string& funcName, const ARCTask& task) {
+        if (task.training.empty()) return 0.0f;
+        std::size_t matches = 0;
+        for (const auto& example : task.training) {
+            try {
+                Grid output = applyTransform(funcName, example.input);
+                if (output.width == example.output.width && output.height == example.output.height &&
+                    output.pixels == example.output.pixels) {
+                    ++matches;
+                }
+            } catch (...) {
+            }
+        }
+        return static_cast<float>(matches) / task.training.size();
+    }
+    
+    // 简化的DAG搜索，每找到一个解调用onFound(当前解集, 分数, 阶段)
+    using FoundCallback = std::function<void(const std::vector<Grid>&, float, const char*)>;
+    
+    std::vector<Grid> searchSolutions(const ARCTask& task, const SolverConfig& config,
+                                      const FoundCallback& onFound = nullptr,
+                                      const arc::core::Deadline& deadline = arc::core::Deadline()) {
         std::vector<Grid> solutions;
+        float bestScore = 0.0f;
         
         // 预测输出尺寸
         std::vector<std::pair<int, int>> outputSizes;
@@ -182,6 +208,9 @@ public:
         std::vector<std::string> functionsToTry = {"identity", "invert", "transpose", "flipH", "flipV"};
         
         for (const auto& funcName : functionsToTry) {
+            if (deadline.expired()) {
+                break;
+            }
             try {
                 Grid result = applyTransform(funcName, task.testInput);
                 
@@ -190,15 +219,24 @@ public:
                     auto expectedSize = outputSizes[0];
                     if (result.width == expectedSize.first && result.height == expectedSize.second) {
                         solutions.push_back(result);
+                    } else {
+                        continue;
                     }
                 } else {
                     // 检查尺寸是否在合理范围内
                     if (result.width <= config.maxSide && result.height <= config.maxSide &&
                         result.width * result.height <= config.maxArea) {
                         solutions.push_back(result);
+                    } else {
+                        continue;
                     }
                 }
                 
+                if (onFound) {
+                    bestScore = std::max(bestScore, trainingScore(funcName, task));
+                    onFound(solutions, bestScore, "transform");
+                }
+                
                 if (solutions.size() >= config.maxAnswers) {
                     break;
                 }
@@ -221,6 +259,9 @@ public:
                 std::fill(defaultSolution.pixels.begin(), defaultSolution.pixels.end(), avgColor);
             }
             solutions.push_back(defaultSolution);
+            if (onFound) {
+                onFound(solutions, 0.0f, "fallback");
+            }
         }
         
         return solutions;
@@ -299,13 +340,59 @@ std::vector<std::vector<std::vector<int>>> DAGSolverCpp::solve(
     return results;
 }
 
+void DAGSolverCpp::solveStreaming(
+    const std::vector<std::vector<std::vector<int>>>& train_inputs,
+    const std::vector<std::vector<std::vector<int>>>& train_outputs,
+    const std::vector<std::vector<std::vector<int>>>& test_inputs,
+    const AnswerCallback& onUpdate,
+    const arc::core::Deadline& deadline) {
+    
+    auto start = std::chrono::steady_clock::now();
+    AnswerUpdate update;
+    
+    auto emit = [&](const std::vector<Grid>& solutions, float score, const char* stage, bool final) {
+        update.answers.clear();
+        for (const auto& solution : solutions) {
+            update.answers.push_back(convertToVector(solution));
+        }
+        update.score = score;
+        update.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        update.stage = stage;
+        update.final = final;
+        onUpdate(update);
+    };
+    
+    std::vector<Grid> solutions;
+    float bestScore = 0.0f;
+    if (!test_inputs.empty()) {
+        try {
+            ARCTask task = convertTask(train_inputs, train_outputs, test_inputs[0]);
+            // 每个调用方独立的Impl，流式求解可以与其他求解并发
+            Impl impl;
+            solutions = impl.searchSolutions(task, config_,
+                [&](const std::vector<Grid>& found, float score, const char* stage) {
+                    bestScore = score;
+                    emit(found, score, stage, false);
+                }, deadline);
+        } catch (const std::exception& e) {
+            std::cerr << "DAG Solver error: " << e.what() << std::endl;
+        }
+    }
+    
+    emit(solutions, bestScore, "final", true);
+}
+
 SolveResult DAGSolverCpp::solveSingle(const ARCTask& task) {
+    return solveWith(*impl_, task);
+}
+
+SolveResult DAGSolverCpp::solveWith(Impl& impl, const ARCTask& task) const {
     SolveResult result;
     
     auto start = std::chrono::high_resolution_clock::now();
     
     try {
-        std::vector<Grid> solutions = impl_->searchSolutions(task, config_);
+        std::vector<Grid> solutions = impl.searchSolutions(task, config_);
         result.answers = solutions;
         result.success = !solutions.empty();
         
@@ -327,11 +414,66 @@ SolveResult DAGSolverCpp::solveSingle(const ARCTask& task) {
 }
 
 std::vector<SolveResult> DAGSolverCpp::solveBatch(const std::vector<ARCTask>& tasks) {
-    std::vector<SolveResult> results;
-    results.reserve(tasks.size());
+    std::size_t numWorkers = config_.batchThreads;
+    if (numWorkers == 0) {
+        numWorkers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numWorkers = std::max<std::size_t>(1, std::min(numWorkers, tasks.size()));
     
-    for (const auto& task : tasks) {
-        results.push_back(solveSingle(task));
+    if (numWorkers == 1) {
+        std::vector<SolveResult> results;
+        results.reserve(tasks.size());
+        
+        for (const auto& task : tasks) {
+            results.push_back(solveSingle(task));
+        }
+        
+        return results;
+    }
+    
+    // 按像素总量估计耗时，大任务先分发
+    std::vector<std::size_t> costs(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        std::size_t pixels = tasks[i].testInput.pixels.size();
+        for (const auto& example : tasks[i].training) {
+            pixels += example.input.pixels.size() + example.output.pixels.size();
+        }
+        costs[i] = pixels;
+    }
+    std::vector<std::size_t> order(tasks.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return costs[a] > costs[b];
+    });
+    
+    std::vector<SolveResult> results(tasks.size());
+    std::vector<std::exception_ptr> errors(numWorkers);
+    std::atomic<std::size_t> nextSlot{0};
+    
+    auto runWorker = [&](std::size_t worker) {
+        try {
+            // 每个工作线程独立的状态缓存
+            Impl impl;
+            for (std::size_t slot = nextSlot++; slot < order.size(); slot = nextSlot++) {
+                results[order[slot]] = solveWith(impl, tasks[order[slot]]);
+            }
+        } catch (...) {
+            errors[worker] = std::current_exception();
+        }
+    };
+    
+    std::vector<std::thread> workers;
+    workers.reserve(numWorkers - 1);
+    for (std::size_t worker = 1; worker < numWorkers; ++worker) {
+        workers.emplace_back(runWorker, worker);
+    }
+    runWorker(0);
+    
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& error : errors) {
+        if (error) std::rethrow_exception(error);
     }
     
     return results;
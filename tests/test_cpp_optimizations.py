@@ -8,6 +8,7 @@ they provide the expected performance improvements and maintain correctness.
 import pytest
 import numpy as np
 import time
+import os
 from arc_solver import ArcSolver, TaskLoader, SolverConfig
 
 
@@ -401,5 +402,232 @@ class TestCppIntegration:
             assert speedup >= 1.5  # At least 1.5x speedup
 
 
+def import_cpp_module():
+    """Import the compiled arc_solver_cpp module or skip the test."""
+    try:
+        import arc_solver_cpp
+        return arc_solver_cpp
+    except ImportError:
+        pytest.skip("arc_solver_cpp module not available")
+
+
+def write_corpus_json(path):
+    """Write a small challenges file; task_b has one test without an output."""
+    import json
+
+    challenges = {
+        'task_a': {
+            'train': [{'input': [[1, 2], [3, 4]], 'output': [[4, 3], [2, 1]]}],
+            'test': [{'input': [[5, 6]]}]
+        },
+        'task_b': {
+            'train': [{'input': [[7]], 'output': [[8]]}],
+            'test': [{'input': [[1, 1]]}, {'input': [[2]], 'output': [[3]]}]
+        },
+        'task_c': {
+            'train': [{'input': [[0, 9, 0]], 'output': [[9]]}],
+            'test': [{'input': [[9, 9]]}]
+        }
+    }
+    path.write_text(json.dumps(challenges))
+    return challenges
+
+
+class TestCppArcCorpus:
+    """Test the packed binary corpus and its numpy views."""
+    
+    def test_corpus_round_trip(self, tmp_path):
+        """Test that converted tasks read back as the original grids."""
+        cpp = import_cpp_module()
+        json_path = tmp_path / 'challenges.json'
+        corpus_path = tmp_path / 'challenges.arcc'
+        challenges = write_corpus_json(json_path)
+        
+        # 奇数个任务：网格索引需要补齐到8字节
+        assert cpp.convert_arc_json_to_corpus(str(json_path), str(corpus_path)) == 3
+        corpus = cpp.ArcCorpus(str(corpus_path))
+        
+        assert len(corpus) == 3
+        assert not corpus.is_packed
+        for index in range(len(corpus)):
+            task = challenges[corpus.task_id(index)]
+            pairs = corpus.train_pairs(index)
+            assert len(pairs) == len(task['train'])
+            for (grid_in, grid_out), example in zip(pairs, task['train']):
+                assert grid_in.dtype == np.uint8
+                assert np.array_equal(grid_in, np.array(example['input']))
+                assert np.array_equal(grid_out, np.array(example['output']))
+            tests = corpus.test_inputs(index)
+            assert [grid.tolist() for grid in tests] == [test['input'] for test in task['test']]
+    
+    def test_corpus_views_are_read_only(self, tmp_path):
+        """Test that uint8 corpus arrays are read-only views that outlive the reader object."""
+        cpp = import_cpp_module()
+        json_path = tmp_path / 'challenges.json'
+        corpus_path = tmp_path / 'challenges.arcc'
+        write_corpus_json(json_path)
+        cpp.convert_arc_json_to_corpus(str(json_path), str(corpus_path))
+        
+        corpus = cpp.ArcCorpus(str(corpus_path))
+        grid = corpus.test_inputs(0)[0]
+        assert not grid.flags.writeable
+        with pytest.raises(ValueError):
+            grid[0, 0] = 1
+        
+        del corpus
+        assert grid.shape == (1, 2)
+    
+    def test_corpus_test_outputs_stay_aligned(self, tmp_path):
+        """Test that a test without an output yields None rather than shifting later outputs."""
+        cpp = import_cpp_module()
+        json_path = tmp_path / 'challenges.json'
+        corpus_path = tmp_path / 'challenges.arcc'
+        write_corpus_json(json_path)
+        cpp.convert_arc_json_to_corpus(str(json_path), str(corpus_path))
+        
+        corpus = cpp.ArcCorpus(str(corpus_path))
+        index = [corpus.task_id(i) for i in range(len(corpus))].index('task_b')
+        outputs = corpus.test_outputs(index)
+        assert len(outputs) == 2
+        assert outputs[0] is None
+        assert outputs[1].tolist() == [[3]]
+        
+        index = [corpus.task_id(i) for i in range(len(corpus))].index('task_a')
+        assert corpus.test_outputs(index) == []
+    
+    def test_nibble_corpus(self, tmp_path):
+        """Test that 4-bit packed corpora unpack to the same grids and reject colors above 15."""
+        cpp = import_cpp_module()
+        json_path = tmp_path / 'challenges.json'
+        corpus_path = tmp_path / 'challenges.arcc'
+        challenges = write_corpus_json(json_path)
+        cpp.convert_arc_json_to_corpus(str(json_path), str(corpus_path), pack_nibbles=True)
+        
+        corpus = cpp.ArcCorpus(str(corpus_path))
+        assert corpus.is_packed
+        for index in range(len(corpus)):
+            task = challenges[corpus.task_id(index)]
+            grid_in, grid_out = corpus.train_pairs(index)[0]
+            assert grid_in.tolist() == task['train'][0]['input']
+            assert grid_out.tolist() == task['train'][0]['output']
+        
+        bad_path = tmp_path / 'bad.json'
+        bad_path.write_text('{"train": [{"input": [[16]], "output": [[1]]}], "test": [{"input": [[1]]}]}')
+        with pytest.raises(RuntimeError):
+            cpp.convert_arc_json_to_corpus(str(bad_path), str(tmp_path / 'bad.arcc'), pack_nibbles=True)
+
+
+
+class TestCppSharedTaskStore:
+    """Test the shared memory task store and its result slots."""
+    
+    def make_store(self, tmp_path):
+        cpp = import_cpp_module()
+        json_path = tmp_path / 'challenges.json'
+        corpus_path = tmp_path / 'challenges.arcc'
+        challenges = write_corpus_json(json_path)
+        cpp.convert_arc_json_to_corpus(str(json_path), str(corpus_path))
+        name = '/arc_test_%d' % os.getpid()
+        cpp.SharedTaskStore.unlink(name)
+        return cpp, cpp.SharedTaskStore.create(name, str(corpus_path)), challenges
+    
+    def test_claim_and_views(self, tmp_path):
+        """Test that every test input gets one slot and its grids are read-only views."""
+        cpp, store, challenges = self.make_store(tmp_path)
+        try:
+            worker = cpp.SharedTaskStore.attach(store.name)
+            assert len(worker) == 4
+            claimed = []
+            slot = worker.claim()
+            while slot is not None:
+                claimed.append(slot)
+                slot = worker.claim()
+            assert claimed == [0, 1, 2, 3]
+            
+            for slot in claimed:
+                task = challenges[worker.task_id(slot)]
+                test = task['test'][worker.test_index(slot)]
+                grid = worker.test_input(slot)
+                assert grid.tolist() == test['input']
+                assert not grid.flags.writeable
+                output = worker.test_output(slot)
+                assert (output is None) == ('output' not in test)
+                grid_in, grid_out = worker.train_pairs(slot)[0]
+                assert grid_in.tolist() == task['train'][0]['input']
+            
+            # 视图持有存储对象，解除引用后仍然有效
+            grid = worker.test_input(0)
+            del worker
+            assert grid.tolist() == challenges[store.task_id(0)]['test'][0]['input']
+        finally:
+            cpp.SharedTaskStore.unlink(store.name)
+    
+    def test_results_round_trip(self, tmp_path):
+        """Test that results written through one attachment read back through another."""
+        cpp, store, _ = self.make_store(tmp_path)
+        try:
+            worker = cpp.SharedTaskStore.attach(store.name)
+            slot = worker.claim()
+            assert store.load_result(slot) is None
+            
+            answer = np.array([[1, 2], [3, 4]], dtype=np.uint8)
+            worker.store_result(slot, [answer, answer.T], score=2.5)
+            answers, score = store.load_result(slot)
+            assert [grid.tolist() for grid in answers] == [answer.tolist(), answer.T.tolist()]
+            assert score == 2.5
+            assert store.completed == 1
+            
+            with pytest.raises(IndexError):
+                store.load_result(len(store))
+        finally:
+            cpp.SharedTaskStore.unlink(store.name)
+
+
+
+class TestCppDagStreaming:
+    """Test progressive answers from the DAG solver."""
+    
+    TRAIN_INPUTS = [[[1, 2], [3, 4]], [[5, 6], [7, 8]]]
+    TEST_INPUTS = [[[2, 3], [4, 5]]]
+    
+    def test_solve_streaming_ends_with_final(self):
+        """Test that solve_streaming reports improving updates and finishes with one final update."""
+        cpp = import_cpp_module()
+        solver = cpp.DAGSolverCpp()
+        updates = []
+        solver.solve_streaming(self.TRAIN_INPUTS, self.TRAIN_INPUTS, self.TEST_INPUTS, updates.append)
+        
+        assert len(updates) >= 2
+        assert [update.final for update in updates] == [False] * (len(updates) - 1) + [True]
+        assert updates[-1].answers
+        assert [update.elapsed for update in updates] == sorted(update.elapsed for update in updates)
+        # 恒等任务：最终答案就是测试输入
+        assert updates[-1].answers[0] == self.TEST_INPUTS[0]
+    
+    def test_solve_iter_matches_streaming(self):
+        """Test that solve_iter yields the same final answers as solve_streaming."""
+        cpp = import_cpp_module()
+        solver = cpp.DAGSolverCpp()
+        streamed = []
+        solver.solve_streaming(self.TRAIN_INPUTS, self.TRAIN_INPUTS, self.TEST_INPUTS, streamed.append)
+        
+        updates = list(solver.solve_iter(self.TRAIN_INPUTS, self.TRAIN_INPUTS, self.TEST_INPUTS))
+        assert updates[-1].final
+        assert not any(update.final for update in updates[:-1])
+        assert updates[-1].answers == streamed[-1].answers
+    
+    def test_solve_iter_dropped_early(self):
+        """Test that dropping the iterator after the first update cancels the solve instead of blocking."""
+        cpp = import_cpp_module()
+        solver = cpp.DAGSolverCpp()
+        iterator = solver.solve_iter(self.TRAIN_INPUTS, self.TRAIN_INPUTS, self.TEST_INPUTS)
+        first = next(iterator)
+        assert first.answers
+        
+        start = time.time()
+        del iterator
+        assert time.time() - start < 1.0
+
+
 if __name__ == "__main__":
     pytest.main([__file__]) 
\ No newline at end of file